@@ -20,6 +20,7 @@
 // THE SOFTWARE.
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
 #include <string>
@@ -129,7 +130,46 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  // the parser fills in its own default access method when there is no USING clause
+  std::string index_type = "bplustree";
+  if (stmt->accessMethod != nullptr && std::string(stmt->accessMethod) != DEFAULT_INDEX_TYPE) {
+    index_type = StringUtil::Lower(stmt->accessMethod);
+  }
+
+  // the grammar has no INCLUDE clause, so a covering index names its included columns as an option:
+  // `WITH (include = 'v1, v2')`, or `WITH (include = v1)` for a single one
+  std::vector<std::unique_ptr<BoundColumnRef>> include_cols;
+  if (stmt->options != nullptr) {
+    for (auto cell = stmt->options->head; cell != nullptr; cell = cell->next) {
+      auto def_elem = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      if (StringUtil::Lower(def_elem->defname) != "include" || def_elem->arg == nullptr) {
+        throw NotImplementedException(fmt::format("index option {} is not supported", def_elem->defname));
+      }
+      std::vector<std::string> include_names;
+      if (def_elem->arg->type == duckdb_libpgquery::T_PGString) {
+        include_names = StringUtil::Split(reinterpret_cast<duckdb_libpgquery::PGValue *>(def_elem->arg)->val.str, ',');
+      } else if (def_elem->arg->type == duckdb_libpgquery::T_PGTypeName) {
+        auto type_name = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(def_elem->arg);
+        include_names.emplace_back(
+            reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str);
+      } else {
+        throw bustub::Exception("included columns should be given as a column name or a string of them");
+      }
+      for (const auto &include_name : include_names) {
+        auto column_ref = ResolveColumn(*table, std::vector{StringUtil::Lower(StringUtil::Strip(include_name, ' '))});
+        const auto &include_col = dynamic_cast<const BoundColumnRef &>(*column_ref);
+        auto is_same_col = [&](const auto &col) { return col->col_name_ == include_col.col_name_; };
+        if (std::any_of(cols.begin(), cols.end(), is_same_col) ||
+            std::any_of(include_cols.begin(), include_cols.end(), is_same_col)) {
+          throw bustub::Exception(fmt::format("column {} is included in the index twice", include_col.ToString()));
+        }
+        include_cols.emplace_back(std::make_unique<BoundColumnRef>(include_col));
+      }
+    }
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), std::move(index_type),
+                                          std::move(include_cols));
 }
 
 }  // namespace bustub
@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager.cpp
+//
+// Identification: src/buffer/buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_manager.h"
+
+#include "common/logger.h"
+
+namespace bustub {
+
+auto BufferPoolManager::FetchPageBasic(page_id_t page_id, AccessType access_type, const char *file, int line)
+    -> BasicPageGuard {
+  BasicPageGuard guard(this, FetchPage(page_id, access_type));
+  TrackGuardPin(&guard, file, line);
+  return guard;
+}
+
+auto BufferPoolManager::FetchPageRead(page_id_t page_id, AccessType access_type, const char *file, int line)
+    -> ReadPageGuard {
+  return FetchPageBasic(page_id, access_type, file, line).UpgradeRead();
+}
+
+auto BufferPoolManager::FetchPageWrite(page_id_t page_id, AccessType access_type, const char *file, int line)
+    -> WritePageGuard {
+  return FetchPageBasic(page_id, access_type, file, line).UpgradeWrite();
+}
+
+auto BufferPoolManager::NewPageGuarded(page_id_t *page_id, const char *file, int line) -> BasicPageGuard {
+  BasicPageGuard guard(this, NewPage(page_id));
+  // a new page has to reach the disk even if the caller never writes to it
+  guard.is_dirty_ = true;
+  TrackGuardPin(&guard, file, line);
+  return guard;
+}
+
+void BufferPoolManager::TrackGuardPin(BasicPageGuard *guard, const char *file, int line) {
+  if (!guard->IsValid()) {
+    return;
+  }
+  guard->file_ = file;
+  guard->line_ = line;
+#ifndef NDEBUG
+  std::scoped_lock<std::mutex> lock(guard_pin_latch_);
+  guard_pins_[{file, line}]++;
+#endif
+}
+
+void BufferPoolManager::UntrackGuardPin(const char *file, int line) {
+#ifndef NDEBUG
+  if (file == nullptr) {
+    // a guard that was built by hand, not by the buffer pool manager
+    return;
+  }
+  std::scoped_lock<std::mutex> lock(guard_pin_latch_);
+  auto it = guard_pins_.find({file, line});
+  if (it != guard_pins_.end() && --it->second == 0) {
+    guard_pins_.erase(it);
+  }
+#endif
+}
+
+auto BufferPoolManager::GetGuardPinSites() -> std::map<std::string, size_t> {
+  std::map<std::string, size_t> sites;
+#ifndef NDEBUG
+  std::scoped_lock<std::mutex> lock(guard_pin_latch_);
+  for (const auto &[site, count] : guard_pins_) {
+    // the same file may show up under several name pointers, one per translation unit
+    sites[std::string(site.first) + ":" + std::to_string(site.second)] += count;
+  }
+#endif
+  return sites;
+}
+
+void BufferPoolManager::ReportLeakedGuardPins() {
+  for (const auto &[site, count] : GetGuardPinSites()) {
+    LOG_WARN("%zu page pin(s) taken by a page guard at %s were never released", count, site.c_str());
+  }
+}
+
+}  // namespace bustub
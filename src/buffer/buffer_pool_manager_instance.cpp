@@ -12,48 +12,452 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <vector>
+
 #include "common/exception.h"
+#include "common/logger.h"
 #include "common/macros.h"
 
 namespace bustub {
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, replacer_k, log_manager, replacer_type) {}
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : pool_size_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      next_page_id_(static_cast<page_id_t>(instance_index)),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      scan_ring_size_(std::clamp<size_t>(pool_size / 4, 1, SCAN_RING_SIZE)) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(
+      instance_index < num_instances,
+      "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 1.");
   // we allocate a consecutive memory space for the buffer pool
   pages_ = new Page[pool_size_];
   page_table_ = new ExtendibleHashTable<page_id_t, frame_id_t>(bucket_size_);
-  replacer_ = new LRUKReplacer(pool_size, replacer_k);
+  if (replacer_type == ReplacerType::CLOCK) {
+    replacer_ = new ClockReplacer(pool_size);
+  } else {
+    replacer_ = new LRUKReplacer(pool_size, replacer_k);
+  }
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
     free_list_.emplace_back(static_cast<int>(i));
   }
-
-  // TODO(students): remove this line after you have implemented the buffer pool manager
-  throw NotImplementedException(
-      "BufferPoolManager is not implemented yet. If you have finished implementing BPM, please remove the throw "
-      "exception line in `buffer_pool_manager_instance.cpp`.");
+  prefetching_.assign(pool_size_, false);
+  scan_ring_pos_.resize(pool_size_);
+  in_scan_ring_.assign(pool_size_, false);
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  StopBackgroundWriter();
+  if (prefetch_thread_ != nullptr) {
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      enable_prefetcher_ = false;
+    }
+    prefetch_cv_.notify_one();
+    prefetch_thread_->join();
+    delete prefetch_thread_;
+  }
+#ifndef NDEBUG
+  ReportLeakedGuardPins();
+  for (size_t i = 0; i < pool_size_; i++) {
+    if (pages_[i].pin_count_ > 0) {
+      LOG_WARN("page %d is still pinned %d time(s) at shutdown", pages_[i].page_id_, pages_[i].pin_count_);
+    }
+  }
+#endif
   delete[] pages_;
   delete page_table_;
   delete replacer_;
 }
 
-auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * { return nullptr; }
+auto BufferPoolManagerInstance::AcquireFrame(frame_id_t *frame_id, AccessType access_type) -> bool {
+  const bool use_ring = access_type == AccessType::Scan || access_type == AccessType::BulkLoad;
+  if (use_ring && scan_ring_.size() >= scan_ring_size_ && RecycleRingFrame(frame_id)) {
+    // fall through to the write back below, the frame still holds a page
+  } else if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+  } else if (!replacer_->Evict(frame_id)) {
+    return false;
+  }
 
-auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * { return nullptr; }
+  // The frame goes to the back of the ring if a scan takes it, and leaves the ring otherwise.
+  LeaveScanRing(*frame_id);
+  if (use_ring) {
+    scan_ring_pos_[*frame_id] = scan_ring_.insert(scan_ring_.end(), *frame_id);
+    in_scan_ring_[*frame_id] = true;
+  }
 
-auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool { return false; }
+  auto *victim = &pages_[*frame_id];
+  if (victim->GetPageId() == INVALID_PAGE_ID) {
+    return true;
+  }
+  metrics_.Add(BufferPoolCounter::EVICTION);
+  if (victim->IsDirty()) {
+    WritePageToDisk(victim->GetPageId(), victim->GetData());
+    metrics_.Add(BufferPoolCounter::SYNC_WRITEBACK);
+  }
+  page_table_->Remove(victim->GetPageId());
+  victim->ResetMemory();
+  victim->page_id_ = INVALID_PAGE_ID;
+  victim->pin_count_ = 0;
+  victim->is_dirty_ = false;
+  return true;
+}
 
-auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool { return false; }
+auto BufferPoolManagerInstance::RecycleRingFrame(frame_id_t *frame_id) -> bool {
+  for (auto ring_frame_id : scan_ring_) {
+    if (pages_[ring_frame_id].GetPinCount() == 0) {
+      replacer_->Remove(ring_frame_id);
+      *frame_id = ring_frame_id;
+      return true;
+    }
+  }
+  return false;
+}
 
-void BufferPoolManagerInstance::FlushAllPgsImp() {}
+void BufferPoolManagerInstance::LeaveScanRing(frame_id_t frame_id) {
+  if (in_scan_ring_[frame_id]) {
+    scan_ring_.erase(scan_ring_pos_[frame_id]);
+    in_scan_ring_[frame_id] = false;
+  }
+}
 
-auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool { return false; }
+auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
+  std::scoped_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!AcquireFrame(&frame_id, AccessType::Normal)) {
+    return nullptr;
+  }
+  *page_id = AllocatePage();
+  auto *page = &pages_[frame_id];
+  page->page_id_ = *page_id;
+  page->pin_count_ = 1;
+  page_table_->Insert(*page_id, frame_id);
+  replacer_->RecordAccess(frame_id);
+  replacer_->SetEvictable(frame_id, false);
+  return page;
+}
 
-auto BufferPoolManagerInstance::AllocatePage() -> page_id_t { return next_page_id_++; }
+auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * {
+  std::unique_lock<std::mutex> lock(latch_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    metrics_.Add(BufferPoolCounter::PIN_WAIT);
+    lock.lock();
+  }
+  frame_id_t frame_id;
+  if (FindFrame(page_id, &frame_id)) {
+    metrics_.Add(BufferPoolCounter::HIT);
+    auto *page = &pages_[frame_id];
+    if (access_type == AccessType::Normal) {
+      LeaveScanRing(frame_id);
+    }
+    page->pin_count_++;
+    replacer_->RecordAccess(frame_id);
+    replacer_->SetEvictable(frame_id, false);
+    // The page may still be on its way in from read-ahead. Our pin keeps it in this frame while we wait.
+    if (prefetching_[frame_id]) {
+      metrics_.Add(BufferPoolCounter::PIN_WAIT);
+      prefetch_done_cv_.wait(lock, [this, frame_id] { return !prefetching_[frame_id]; });
+    }
+    return page;
+  }
+  metrics_.Add(BufferPoolCounter::MISS);
+  ValidatePageId(page_id);
+  if (!AcquireFrame(&frame_id, access_type)) {
+    return nullptr;
+  }
+  auto *page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page->pin_count_ = 1;
+  ReadPageFromDisk(page_id, page->GetData());
+  page_table_->Insert(page_id, frame_id);
+  replacer_->RecordAccess(frame_id);
+  replacer_->SetEvictable(frame_id, false);
+  return page;
+}
+
+auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!FindFrame(page_id, &frame_id)) {
+    return false;
+  }
+  auto *page = &pages_[frame_id];
+  if (page->GetPinCount() <= 0) {
+    return false;
+  }
+  page->is_dirty_ |= is_dirty;
+  if (--page->pin_count_ == 0) {
+    replacer_->SetEvictable(frame_id, true);
+  }
+  return true;
+}
+
+auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "cannot flush INVALID_PAGE_ID");
+  std::scoped_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!FindFrame(page_id, &frame_id)) {
+    return false;
+  }
+  if (prefetching_[frame_id]) {
+    // the frame is being filled from disk, so disk already has this very content
+    return true;
+  }
+  auto *page = &pages_[frame_id];
+  WritePageToDisk(page_id, page->GetData());
+  page->is_dirty_ = false;
+  return true;
+}
+
+void BufferPoolManagerInstance::FlushAllPgsImp() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // Hand the whole pool to the disk manager as one batch, so that it can merge and overlap the writes.
+  std::vector<page_id_t> page_ids;
+  std::vector<const char *> page_data;
+  for (size_t i = 0; i < pool_size_; i++) {
+    auto *page = &pages_[i];
+    if (page->GetPageId() != INVALID_PAGE_ID && !prefetching_[i]) {
+      page_ids.push_back(page->GetPageId());
+      page_data.push_back(page->GetData());
+      page->is_dirty_ = false;
+    }
+  }
+  auto start = std::chrono::steady_clock::now();
+  disk_manager_->WritePages(page_ids, page_data);
+  metrics_.RecordWriteLatency(std::chrono::steady_clock::now() - start);
+}
+
+auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  // A page that read-ahead is still loading is pinned by the prefetch thread only; wait for it instead of failing.
+  while (true) {
+    if (!FindFrame(page_id, &frame_id)) {
+      return true;
+    }
+    if (!prefetching_[frame_id]) {
+      break;
+    }
+    prefetch_done_cv_.wait(lock);
+  }
+  auto *page = &pages_[frame_id];
+  if (page->GetPinCount() > 0) {
+    return false;
+  }
+  page_table_->Remove(page_id);
+  replacer_->Remove(frame_id);
+  LeaveScanRing(frame_id);
+  free_list_.push_back(frame_id);
+  page->ResetMemory();
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  DeallocatePage(page_id);
+  return true;
+}
+
+void BufferPoolManagerInstance::PrefetchPgsImp(page_id_t first_page_id, size_t count, AccessType access_type) {
+  std::vector<frame_id_t> frames;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    const size_t max_prefetching = pool_size_ / 4;
+    const auto end_page_id = static_cast<int64_t>(first_page_id) + static_cast<int64_t>(count);
+    for (int64_t id = std::max<int64_t>(first_page_id, 0); id < end_page_id && id < next_page_id_; id++) {
+      const auto page_id = static_cast<page_id_t>(id);
+      frame_id_t frame_id;
+      if (page_id % num_instances_ != instance_index_ || FindFrame(page_id, &frame_id)) {
+        continue;
+      }
+      if (num_prefetching_ >= max_prefetching || !AcquireFrame(&frame_id, access_type)) {
+        break;
+      }
+      auto *page = &pages_[frame_id];
+      page->page_id_ = page_id;
+      page->pin_count_ = 1;
+      page_table_->Insert(page_id, frame_id);
+      replacer_->RecordAccess(frame_id);
+      replacer_->SetEvictable(frame_id, false);
+      prefetching_[frame_id] = true;
+      num_prefetching_++;
+      frames.push_back(frame_id);
+    }
+    if (frames.empty()) {
+      return;
+    }
+    prefetch_queue_.push_back(std::move(frames));
+    if (prefetch_thread_ == nullptr) {
+      prefetch_thread_ = new std::thread(&BufferPoolManagerInstance::RunPrefetcher, this);
+    }
+  }
+  prefetch_cv_.notify_one();
+}
+
+void BufferPoolManagerInstance::RunPrefetcher() {
+  while (true) {
+    std::vector<frame_id_t> frames;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      prefetch_cv_.wait(lock, [this] { return !enable_prefetcher_ || !prefetch_queue_.empty(); });
+      if (prefetch_queue_.empty()) {
+        return;
+      }
+      frames = std::move(prefetch_queue_.front());
+      prefetch_queue_.pop_front();
+    }
+
+    // The frames are pinned and marked as in flight, so nobody else touches them until we clear the mark.
+    std::vector<page_id_t> page_ids;
+    std::vector<char *> page_data;
+    for (auto frame_id : frames) {
+      page_ids.push_back(pages_[frame_id].GetPageId());
+      page_data.push_back(pages_[frame_id].GetData());
+    }
+    auto start = std::chrono::steady_clock::now();
+    disk_manager_->ReadPages(page_ids, page_data);
+    metrics_.RecordReadLatency(std::chrono::steady_clock::now() - start);
+
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      for (auto frame_id : frames) {
+        prefetching_[frame_id] = false;
+        if (--pages_[frame_id].pin_count_ == 0) {
+          replacer_->SetEvictable(frame_id, true);
+        }
+      }
+      num_prefetching_ -= frames.size();
+    }
+    metrics_.Add(BufferPoolCounter::PREFETCHED_PAGE, frames.size());
+    prefetch_done_cv_.notify_all();
+  }
+}
+
+void BufferPoolManagerInstance::StartBackgroundWriter(double target_clean_ratio, size_t max_writes_per_second) {
+  BUSTUB_ASSERT(background_writer_thread_ == nullptr, "background writer is already running");
+  target_clean_ratio_ = std::clamp(target_clean_ratio, 0.0, 1.0);
+  max_writes_per_second_ = max_writes_per_second;
+  enable_background_writer_ = true;
+  background_writer_thread_ = new std::thread(&BufferPoolManagerInstance::RunBackgroundWriter, this);
+}
+
+void BufferPoolManagerInstance::StopBackgroundWriter() {
+  if (background_writer_thread_ == nullptr) {
+    return;
+  }
+  enable_background_writer_ = false;
+  background_writer_thread_->join();
+  delete background_writer_thread_;
+  background_writer_thread_ = nullptr;
+}
+
+void BufferPoolManagerInstance::RunBackgroundWriter() {
+  const auto window = static_cast<size_t>(std::ceil(target_clean_ratio_ * static_cast<double>(pool_size_)));
+  const auto budget = std::max<size_t>(1, max_writes_per_second_ * background_writer_interval.count() / 1000);
+  while (enable_background_writer_) {
+    std::this_thread::sleep_for(background_writer_interval);
+
+    // Only collect the candidates under the latch; the writes themselves happen without it.
+    std::vector<frame_id_t> dirty_frames;
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      for (auto frame_id : replacer_->GetEvictionOrder(window)) {
+        if (pages_[frame_id].IsDirty()) {
+          dirty_frames.push_back(frame_id);
+          if (dirty_frames.size() == budget) {
+            break;
+          }
+        }
+      }
+    }
+
+    for (auto frame_id : dirty_frames) {
+      if (!enable_background_writer_) {
+        break;
+      }
+      CleanFrame(frame_id);
+    }
+  }
+}
+
+auto BufferPoolManagerInstance::CleanFrame(frame_id_t frame_id) -> bool {
+  auto *page = &pages_[frame_id];
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (!page->IsDirty() || page->GetPinCount() > 0) {
+      return false;
+    }
+    // Pin the frame without recording an access, so that it cannot be evicted while it is being written.
+    page->pin_count_++;
+    replacer_->SetEvictable(frame_id, false);
+  }
+
+  // The read latch keeps writers out while the page is on its way to disk. Any change made before we got the latch is
+  // part of this write; any later change re-dirties the page through UnpinPgImp().
+  page->RLatch();
+  WritePageToDisk(page->GetPageId(), page->GetData());
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    page->is_dirty_ = false;
+    if (--page->pin_count_ == 0) {
+      replacer_->SetEvictable(frame_id, true);
+    }
+  }
+  page->RUnlatch();
+  metrics_.Add(BufferPoolCounter::BACKGROUND_WRITEBACK);
+  return true;
+}
+
+auto BufferPoolManagerInstance::FindFrame(page_id_t page_id, frame_id_t *frame_id) -> bool {
+  size_t probes = 0;
+  bool found = page_table_->Find(page_id, *frame_id, &probes);
+  metrics_.Add(BufferPoolCounter::PAGE_TABLE_LOOKUP);
+  metrics_.Add(BufferPoolCounter::PAGE_TABLE_PROBE, probes);
+  return found;
+}
+
+void BufferPoolManagerInstance::WritePageToDisk(page_id_t page_id, const char *page_data) {
+  auto start = std::chrono::steady_clock::now();
+  disk_manager_->WritePage(page_id, page_data);
+  metrics_.RecordWriteLatency(std::chrono::steady_clock::now() - start);
+}
+
+void BufferPoolManagerInstance::ReadPageFromDisk(page_id_t page_id, char *page_data) {
+  auto start = std::chrono::steady_clock::now();
+  disk_manager_->ReadPage(page_id, page_data);
+  metrics_.RecordReadLatency(std::chrono::steady_clock::now() - start);
+}
+
+auto BufferPoolManagerInstance::AllocatePage() -> page_id_t {
+  const page_id_t next_page_id = next_page_id_.fetch_add(num_instances_);
+  ValidatePageId(next_page_id);
+  return next_page_id;
+}
+
+void BufferPoolManagerInstance::ReservePageIds(page_id_t end_page_id) {
+  // the first page id of this instance from end_page_id on
+  const auto num_instances = static_cast<page_id_t>(num_instances_);
+  const auto instance_index = static_cast<page_id_t>(instance_index_);
+  page_id_t reserved = end_page_id + (instance_index - end_page_id % num_instances + num_instances) % num_instances;
+  page_id_t next_page_id = next_page_id_.load();
+  while (next_page_id < reserved && !next_page_id_.compare_exchange_weak(next_page_id, reserved)) {
+  }
+}
+
+void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
+  assert(page_id % num_instances_ == instance_index_);  // allocated pages mod back to this BPI
+}
 
 }  // namespace bustub
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_metrics.cpp
+//
+// Identification: src/buffer/buffer_pool_metrics.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_metrics.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+auto BufferPoolStats::HitRatio() const -> double {
+  const auto hits = Get(BufferPoolCounter::HIT);
+  const auto fetches = hits + Get(BufferPoolCounter::MISS);
+  return fetches == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(fetches);
+}
+
+auto BufferPoolStats::AvgProbeLength() const -> double {
+  const auto lookups = Get(BufferPoolCounter::PAGE_TABLE_LOOKUP);
+  if (lookups == 0) {
+    return 0.0;
+  }
+  return static_cast<double>(Get(BufferPoolCounter::PAGE_TABLE_PROBE)) / static_cast<double>(lookups);
+}
+
+auto BufferPoolStats::LatencyQuantile(const LatencyHistogram &histogram, double quantile) -> uint64_t {
+  uint64_t total = 0;
+  for (auto count : histogram) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  // the rank of the quantile, 1-based, so that quantile 0 lands in the first non-empty bucket
+  const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::clamp(quantile, 0.0, 1.0) * total));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < histogram.size(); i++) {
+    seen += histogram[i];
+    if (seen >= rank) {
+      return uint64_t{1} << i;
+    }
+  }
+  return uint64_t{1} << (histogram.size() - 1);
+}
+
+auto BufferPoolStats::operator+=(const BufferPoolStats &that) -> BufferPoolStats & {
+  for (size_t i = 0; i < counters_.size(); i++) {
+    counters_[i] += that.counters_[i];
+  }
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+    read_latency_[i] += that.read_latency_[i];
+    write_latency_[i] += that.write_latency_[i];
+  }
+  return *this;
+}
+
+auto BufferPoolMetrics::Get(BufferPoolCounter counter) const -> uint64_t {
+  uint64_t total = 0;
+  for (const auto &slot : slots_) {
+    total += slot.counters_[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+auto BufferPoolMetrics::Snapshot() const -> BufferPoolStats {
+  BufferPoolStats stats;
+  for (const auto &slot : slots_) {
+    for (size_t i = 0; i < stats.counters_.size(); i++) {
+      stats.counters_[i] += slot.counters_[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+      stats.read_latency_[i] += slot.read_latency_[i].load(std::memory_order_relaxed);
+      stats.write_latency_[i] += slot.write_latency_[i].load(std::memory_order_relaxed);
+    }
+  }
+  return stats;
+}
+
+auto BufferPoolMetrics::ThreadSlotIndex() -> size_t {
+  // the shared counter is only touched the first time a thread counts something
+  static std::atomic<size_t> next_slot{0};
+  thread_local const size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed) % METRICS_SLOTS;
+  return slot;
+}
+
+auto BufferPoolMetrics::BucketOf(std::chrono::nanoseconds latency) -> size_t {
+  auto us = static_cast<uint64_t>(std::max<int64_t>(0, latency.count() / 1000));
+  size_t bucket = 0;
+  while (us > 0 && bucket < LATENCY_HISTOGRAM_BUCKETS - 1) {
+    us >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+}  // namespace bustub
@@ -12,18 +12,96 @@
 
 #include "buffer/clock_replacer.h"
 
+#include "common/macros.h"
+
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : num_pages_(num_pages), frames_(num_pages) {
+  for (auto &frame : frames_) {
+    frame.store(0, std::memory_order_relaxed);
+  }
+}
 
 ClockReplacer::~ClockReplacer() = default;
 
-auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool {
+  if (num_pages_ == 0) {
+    return false;
+  }
+  for (size_t step = 0; step < 2 * num_pages_ + 1; step++) {
+    const size_t pos = hand_.fetch_add(1, std::memory_order_relaxed) % num_pages_;
+    auto &frame = frames_[pos];
+    uint8_t state = frame.load(std::memory_order_acquire);
+    if ((state & EVICTABLE) == 0) {
+      continue;
+    }
+    if ((state & REFERENCED) != 0) {
+      // second chance
+      frame.fetch_and(static_cast<uint8_t>(~REFERENCED), std::memory_order_acq_rel);
+      continue;
+    }
+    // Claim the frame, unless somebody pinned or touched it since we looked.
+    if (frame.compare_exchange_strong(state, 0, std::memory_order_acq_rel)) {
+      *frame_id = static_cast<frame_id_t>(pos);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < num_pages_, "frame id is invalid");
+  frames_[frame_id].fetch_and(static_cast<uint8_t>(~EVICTABLE), std::memory_order_acq_rel);
+}
+
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < num_pages_, "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  // Unpinning a frame that is already in the replacer changes nothing.
+  if ((frame.load(std::memory_order_relaxed) & EVICTABLE) == 0) {
+    frame.fetch_or(EVICTABLE | REFERENCED, std::memory_order_acq_rel);
+  }
+}
+
+auto ClockReplacer::Size() -> size_t {
+  size_t size = 0;
+  for (const auto &frame : frames_) {
+    size += frame.load(std::memory_order_relaxed) & EVICTABLE;
+  }
+  return size;
+}
+
+void ClockReplacer::RecordAccess(frame_id_t frame_id) {
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < num_pages_, "frame id is invalid");
+  frames_[frame_id].fetch_or(REFERENCED, std::memory_order_acq_rel);
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < num_pages_, "frame id is invalid");
+  if (set_evictable) {
+    frames_[frame_id].fetch_or(EVICTABLE, std::memory_order_acq_rel);
+  } else {
+    frames_[frame_id].fetch_and(static_cast<uint8_t>(~EVICTABLE), std::memory_order_acq_rel);
+  }
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < num_pages_, "frame id is invalid");
+  frames_[frame_id].store(0, std::memory_order_release);
+}
 
-auto ClockReplacer::Size() -> size_t { return 0; }
+auto ClockReplacer::GetEvictionOrder(size_t limit) -> std::vector<frame_id_t> {
+  std::vector<frame_id_t> order;
+  const size_t hand = hand_.load(std::memory_order_relaxed);
+  for (uint8_t wanted : {EVICTABLE, static_cast<uint8_t>(EVICTABLE | REFERENCED)}) {
+    for (size_t i = 0; i < num_pages_ && order.size() < limit; i++) {
+      const size_t pos = (hand + i) % num_pages_;
+      if (frames_[pos].load(std::memory_order_relaxed) == wanted) {
+        order.push_back(static_cast<frame_id_t>(pos));
+      }
+    }
+  }
+  return order;
+}
 
 }  // namespace bustub
@@ -12,18 +12,156 @@
 
 #include "buffer/lru_k_replacer.h"
 
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : replacer_size_(num_frames), k_(k), nodes_(num_frames), history_(num_frames * k) {
+  BUSTUB_ASSERT(k > 0, "k must be positive");
+  heap_.reserve(num_frames);
+}
+
+auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (heap_.empty()) {
+    return false;
+  }
+  *frame_id = heap_.front();
+  HeapErase(0);
+  nodes_[*frame_id] = FrameNode{};
+  curr_size_--;
+  return true;
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "frame id is invalid");
+  auto &node = nodes_[frame_id];
+  auto *history = &history_[frame_id * k_];
+  if (node.count_ < k_) {
+    history[node.count_++] = current_timestamp_++;
+  } else {
+    // overwrite the oldest timestamp, the next one becomes the k-th most recent access
+    history[node.head_] = current_timestamp_++;
+    node.head_ = (node.head_ + 1) % k_;
+  }
+  if (node.heap_pos_ != NOT_IN_HEAP) {
+    // the key only ever grows with a new access
+    SiftDown(node.heap_pos_);
+  }
+}
+
+void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "frame id is invalid");
+  auto &node = nodes_[frame_id];
+  if (node.count_ == 0 || node.evictable_ == set_evictable) {
+    return;
+  }
+  node.evictable_ = set_evictable;
+  if (set_evictable) {
+    HeapPush(frame_id);
+    curr_size_++;
+  } else {
+    HeapErase(node.heap_pos_);
+    curr_size_--;
+  }
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (static_cast<size_t>(frame_id) >= replacer_size_ || nodes_[frame_id].count_ == 0) {
+    return;
+  }
+  BUSTUB_ASSERT(nodes_[frame_id].evictable_, "cannot remove a non-evictable frame");
+  HeapErase(nodes_[frame_id].heap_pos_);
+  nodes_[frame_id] = FrameNode{};
+  curr_size_--;
+}
+
+auto LRUKReplacer::GetEvictionOrder(size_t limit) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // Walk the heap best-first: the next victim is always the smallest key among the children of the frames taken so
+  // far, so only O(limit) heap slots are looked at.
+  using Candidate = std::pair<std::pair<bool, size_t>, size_t>;
+  std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>> frontier;
+  std::vector<frame_id_t> order;
+  if (!heap_.empty()) {
+    frontier.push({Key(heap_[0]), 0});
+  }
+  while (!frontier.empty() && order.size() < limit) {
+    auto pos = frontier.top().second;
+    frontier.pop();
+    order.push_back(heap_[pos]);
+    for (auto child = 2 * pos + 1; child <= 2 * pos + 2 && child < heap_.size(); child++) {
+      frontier.push({Key(heap_[child]), child});
+    }
+  }
+  return order;
+}
+
+auto LRUKReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
 
-auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool { return false; }
+void LRUKReplacer::HeapPush(frame_id_t frame_id) {
+  nodes_[frame_id].heap_pos_ = heap_.size();
+  heap_.push_back(frame_id);
+  SiftUp(heap_.size() - 1);
+}
 
-void LRUKReplacer::RecordAccess(frame_id_t frame_id) {}
+void LRUKReplacer::HeapErase(size_t pos) {
+  const size_t last = heap_.size() - 1;
+  nodes_[heap_[pos]].heap_pos_ = NOT_IN_HEAP;
+  if (pos != last) {
+    heap_[pos] = heap_[last];
+    nodes_[heap_[pos]].heap_pos_ = pos;
+  }
+  heap_.pop_back();
+  if (pos < heap_.size()) {
+    // the frame moved into the hole can belong either above or below it
+    const frame_id_t moved = heap_[pos];
+    SiftUp(pos);
+    SiftDown(nodes_[moved].heap_pos_);
+  }
+}
 
-void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {}
+void LRUKReplacer::SiftUp(size_t pos) {
+  while (pos > 0) {
+    const size_t parent = (pos - 1) / 2;
+    if (Key(heap_[parent]) <= Key(heap_[pos])) {
+      break;
+    }
+    HeapSwap(parent, pos);
+    pos = parent;
+  }
+}
 
-void LRUKReplacer::Remove(frame_id_t frame_id) {}
+void LRUKReplacer::SiftDown(size_t pos) {
+  while (true) {
+    size_t smallest = pos;
+    for (auto child = 2 * pos + 1; child <= 2 * pos + 2 && child < heap_.size(); child++) {
+      if (Key(heap_[child]) < Key(heap_[smallest])) {
+        smallest = child;
+      }
+    }
+    if (smallest == pos) {
+      return;
+    }
+    HeapSwap(pos, smallest);
+    pos = smallest;
+  }
+}
 
-auto LRUKReplacer::Size() -> size_t { return 0; }
+void LRUKReplacer::HeapSwap(size_t a, size_t b) {
+  std::swap(heap_[a], heap_[b]);
+  nodes_[heap_[a]].heap_pos_ = a;
+  nodes_[heap_[b]].heap_pos_ = b;
+}
 
 }  // namespace bustub
@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     size_t replacer_k, LogManager *log_manager,
+                                                     ReplacerType replacer_type)
+    : pool_size_(pool_size) {
+  BUSTUB_ASSERT(num_instances > 0, "a parallel buffer pool needs at least one instance");
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.emplace_back(std::make_unique<BufferPoolManagerInstance>(
+        pool_size, static_cast<uint32_t>(num_instances), static_cast<uint32_t>(i), disk_manager, replacer_k,
+        log_manager, replacer_type));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+#ifndef NDEBUG
+  // guards taken through this manager are counted here, the instances only see the raw pins
+  ReportLeakedGuardPins();
+#endif
+}
+
+auto ParallelBufferPoolManager::GetPoolSize() -> size_t { return instances_.size() * pool_size_; }
+
+void ParallelBufferPoolManager::StartBackgroundWriter(double target_clean_ratio, size_t max_writes_per_second) {
+  for (auto &instance : instances_) {
+    instance->StartBackgroundWriter(target_clean_ratio, max_writes_per_second);
+  }
+}
+
+void ParallelBufferPoolManager::StopBackgroundWriter() {
+  for (auto &instance : instances_) {
+    instance->StopBackgroundWriter();
+  }
+}
+
+auto ParallelBufferPoolManager::GetNumSyncWritebacks() const -> size_t {
+  size_t total = 0;
+  for (const auto &instance : instances_) {
+    total += instance->GetNumSyncWritebacks();
+  }
+  return total;
+}
+
+auto ParallelBufferPoolManager::GetNumBackgroundWritebacks() const -> size_t {
+  size_t total = 0;
+  for (const auto &instance : instances_) {
+    total += instance->GetNumBackgroundWritebacks();
+  }
+  return total;
+}
+
+auto ParallelBufferPoolManager::GetNumPrefetchedPages() const -> size_t {
+  size_t total = 0;
+  for (const auto &instance : instances_) {
+    total += instance->GetNumPrefetchedPages();
+  }
+  return total;
+}
+
+auto ParallelBufferPoolManager::GetStats() -> BufferPoolStats {
+  BufferPoolStats stats;
+  for (auto &instance : instances_) {
+    stats += instance->GetStats();
+  }
+  return stats;
+}
+
+void ParallelBufferPoolManager::ReservePageIds(page_id_t end_page_id) {
+  for (auto &instance : instances_) {
+    instance->ReservePageIds(end_page_id);
+  }
+}
+
+auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance * {
+  return instances_[static_cast<size_t>(page_id) % instances_.size()].get();
+}
+
+auto ParallelBufferPoolManager::FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id, access_type);
+}
+
+auto ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+auto ParallelBufferPoolManager::FlushPgImp(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+auto ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) -> Page * {
+  // Rotate the starting shard so that concurrent callers spread their allocations instead of all hammering shard 0.
+  size_t start = next_instance_.fetch_add(1) % instances_.size();
+  for (size_t i = 0; i < instances_.size(); i++) {
+    auto *page = instances_[(start + i) % instances_.size()]->NewPage(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPgsImp() {
+  for (auto &instance : instances_) {
+    instance->FlushAllPages();
+  }
+}
+
+void ParallelBufferPoolManager::PrefetchPgsImp(page_id_t first_page_id, size_t count, AccessType access_type) {
+  for (auto &instance : instances_) {
+    instance->PrefetchPages(first_page_id, count, access_type);
+  }
+}
+
+}  // namespace bustub
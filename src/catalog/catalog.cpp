@@ -0,0 +1,265 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// catalog.cpp
+//
+// Identification: src/catalog/catalog.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "catalog/catalog.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/exception.h"
+#include "storage/page/catalog_page.h"
+
+namespace bustub {
+
+namespace {
+
+/** Tells a catalog apart from a page that holds anything else, and which format it is in. */
+constexpr uint32_t CATALOG_MAGIC = 0x42544301;
+
+/** Appends values to the serialized catalog. Integers are written as they are in memory. */
+class CatalogWriter {
+ public:
+  template <typename T>
+  void Write(T value) {
+    buffer_.append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  void WriteString(const std::string &str) {
+    Write(static_cast<uint32_t>(str.size()));
+    buffer_.append(str);
+  }
+
+  void WriteAttrs(const std::vector<uint32_t> &attrs) {
+    Write(static_cast<uint32_t>(attrs.size()));
+    for (auto attr : attrs) {
+      Write(attr);
+    }
+  }
+
+  /** Reserve room for a uint32_t to be filled in by Patch(). @return where it is */
+  auto Reserve() -> size_t {
+    Write(uint32_t{0});
+    return buffer_.size() - sizeof(uint32_t);
+  }
+
+  void Patch(size_t pos, uint32_t value) { memcpy(buffer_.data() + pos, &value, sizeof(value)); }
+
+  auto Buffer() const -> const std::string & { return buffer_; }
+
+ private:
+  std::string buffer_;
+};
+
+/** Reads values back out of a serialized catalog, see CatalogWriter. */
+class CatalogReader {
+ public:
+  explicit CatalogReader(const std::string &buffer) : buffer_(buffer) {}
+
+  template <typename T>
+  auto Read() -> T {
+    T value;
+    Take(reinterpret_cast<char *>(&value), sizeof(T));
+    return value;
+  }
+
+  auto ReadString() -> std::string {
+    std::string str(Read<uint32_t>(), '\0');
+    Take(str.data(), str.size());
+    return str;
+  }
+
+  auto ReadAttrs() -> std::vector<uint32_t> {
+    std::vector<uint32_t> attrs(Read<uint32_t>());
+    for (auto &attr : attrs) {
+      attr = Read<uint32_t>();
+    }
+    return attrs;
+  }
+
+ private:
+  void Take(char *out, size_t size) {
+    if (size > buffer_.size() - pos_) {
+      throw Exception("the catalog in the database file is cut short");
+    }
+    memcpy(out, buffer_.data() + pos_, size);
+    pos_ += size;
+  }
+
+  const std::string &buffer_;
+  size_t pos_{0};
+};
+
+}  // namespace
+
+void Catalog::EnablePersistence(page_id_t catalog_page_id) {
+  auto guard = bpm_->FetchPageBasic(catalog_page_id);
+  guard.AsMut<CatalogPage>()->Init();
+  guard.Drop();
+  catalog_page_id_ = catalog_page_id;
+  Persist();
+}
+
+void Catalog::Persist() {
+  if (catalog_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+
+  // the total size goes first, so that the pages are read up to it
+  CatalogWriter writer;
+  auto size_pos = writer.Reserve();
+  writer.Write(CATALOG_MAGIC);
+  writer.Write(next_table_oid_.load());
+  writer.Write(next_index_oid_.load());
+
+  std::vector<const TableInfo *> tables;
+  for (const auto &[oid, table_info] : tables_) {
+    tables.push_back(table_info.get());
+  }
+  std::sort(tables.begin(), tables.end(), [](const auto *lhs, const auto *rhs) { return lhs->oid_ < rhs->oid_; });
+  writer.Write(static_cast<uint32_t>(tables.size()));
+  for (const auto *table_info : tables) {
+    writer.Write(table_info->oid_);
+    writer.WriteString(table_info->name_);
+    writer.Write(table_info->table_ == nullptr ? INVALID_PAGE_ID : table_info->table_->GetFirstPageId());
+    writer.Write(static_cast<uint32_t>(table_info->schema_.GetColumnCount()));
+    for (const auto &column : table_info->schema_.GetColumns()) {
+      writer.WriteString(column.GetName());
+      writer.Write(column.GetType());
+      writer.Write(column.GetVariableLength());
+    }
+  }
+
+  std::vector<const IndexInfo *> indexes;
+  for (const auto &[oid, index_info] : indexes_) {
+    indexes.push_back(index_info.get());
+  }
+  std::sort(indexes.begin(), indexes.end(),
+            [](const auto *lhs, const auto *rhs) { return lhs->index_oid_ < rhs->index_oid_; });
+  writer.Write(static_cast<uint32_t>(indexes.size()));
+  for (const auto *index_info : indexes) {
+    writer.Write(index_info->index_oid_);
+    writer.WriteString(index_info->name_);
+    writer.WriteString(index_info->table_name_);
+    writer.WriteAttrs(index_info->index_->GetKeyAttrs());
+    writer.WriteAttrs(index_info->index_->GetIncludeAttrs());
+    writer.Write(static_cast<uint64_t>(index_info->key_size_));
+    writer.Write(index_info->index_type_);
+    writer.Write(index_info->index_->GetFirstPageId());
+  }
+  writer.Patch(size_pos, static_cast<uint32_t>(writer.Buffer().size()));
+
+  // overwrite the chain from its start, growing it if the catalog does not fit anymore
+  const auto &buffer = writer.Buffer();
+  size_t written = 0;
+  page_id_t page_id = catalog_page_id_;
+  while (true) {
+    auto guard = bpm_->FetchPageBasic(page_id);
+    if (!guard.IsValid()) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch a catalog page");
+    }
+    auto *page = guard.AsMut<CatalogPage>();
+    size_t size = std::min(CatalogPage::CAPACITY, buffer.size() - written);
+    page->SetData(buffer.data() + written, size);
+    written += size;
+    if (written == buffer.size()) {
+      break;
+    }
+    if (page->GetNextPageId() == INVALID_PAGE_ID) {
+      page_id_t next_page_id;
+      auto next_guard = bpm_->NewPageGuarded(&next_page_id);
+      if (!next_guard.IsValid()) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a catalog page");
+      }
+      next_guard.AsMut<CatalogPage>()->Init();
+      page->SetNextPageId(next_page_id);
+    }
+    page_id = page->GetNextPageId();
+  }
+}
+
+auto Catalog::Open(page_id_t catalog_page_id) -> std::vector<PersistedIndex> {
+  BUSTUB_ASSERT(tables_.empty() && indexes_.empty(), "only an empty catalog can be opened");
+
+  std::string buffer;
+  size_t total_size = sizeof(uint32_t);
+  for (page_id_t page_id = catalog_page_id; buffer.size() < total_size;) {
+    if (page_id == INVALID_PAGE_ID) {
+      throw Exception("the catalog in the database file is cut short");
+    }
+    auto guard = bpm_->FetchPageRead(page_id);
+    if (!guard.IsValid()) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch a catalog page");
+    }
+    const auto *page = guard.As<CatalogPage>();
+    buffer.append(page->GetData(), std::min(page->GetSize(), CatalogPage::CAPACITY));
+    if (page_id == catalog_page_id && buffer.size() >= sizeof(uint32_t)) {
+      total_size = CatalogReader(buffer).Read<uint32_t>();
+    }
+    page_id = page->GetNextPageId();
+  }
+  buffer.resize(total_size);
+
+  CatalogReader reader(buffer);
+  reader.Read<uint32_t>();
+  if (reader.Read<uint32_t>() != CATALOG_MAGIC) {
+    throw Exception("the database file holds no catalog");
+  }
+  next_table_oid_ = reader.Read<table_oid_t>();
+  next_index_oid_ = reader.Read<index_oid_t>();
+
+  auto num_tables = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < num_tables; i++) {
+    auto table_oid = reader.Read<table_oid_t>();
+    auto table_name = reader.ReadString();
+    auto first_page_id = reader.Read<page_id_t>();
+    std::vector<Column> columns;
+    auto num_columns = reader.Read<uint32_t>();
+    for (uint32_t j = 0; j < num_columns; j++) {
+      auto column_name = reader.ReadString();
+      auto type = reader.Read<TypeId>();
+      auto variable_length = reader.Read<uint32_t>();
+      if (type == TypeId::VARCHAR) {
+        columns.emplace_back(column_name, type, variable_length);
+      } else {
+        columns.emplace_back(column_name, type);
+      }
+    }
+
+    // the heap is opened at its first page, and read only when it is scanned
+    std::unique_ptr<TableHeap> table;
+    if (first_page_id != INVALID_PAGE_ID) {
+      table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, first_page_id);
+    }
+    tables_.emplace(table_oid, std::make_unique<TableInfo>(Schema(columns), table_name, std::move(table), table_oid));
+    table_names_.emplace(table_name, table_oid);
+    index_names_.emplace(table_name, std::unordered_map<std::string, index_oid_t>{});
+  }
+
+  std::vector<PersistedIndex> indexes(reader.Read<uint32_t>());
+  for (auto &index : indexes) {
+    index.index_oid_ = reader.Read<index_oid_t>();
+    index.name_ = reader.ReadString();
+    index.table_name_ = reader.ReadString();
+    index.key_attrs_ = reader.ReadAttrs();
+    index.include_attrs_ = reader.ReadAttrs();
+    index.key_size_ = reader.Read<uint64_t>();
+    index.index_type_ = reader.Read<IndexType>();
+    index.first_page_id_ = reader.Read<page_id_t>();
+  }
+
+  catalog_page_id_ = catalog_page_id;
+  return indexes;
+}
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
 #include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
 #include "common/bustub_instance.h"
@@ -33,27 +34,56 @@
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/page/catalog_page.h"
+#include "storage/page/header_page.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
+namespace {
+
+/**
+ * One integer column makes a fixed size key; anything else, such as VARCHAR, several columns or included columns, a
+ * variable length one of at most VARLEN_KEY_SIZE bytes, which holds the included columns too.
+ */
+auto IsIntegerKey(const Schema &key_schema, const std::vector<uint32_t> &include_attrs) -> bool {
+  return key_schema.GetColumnCount() == 1 && include_attrs.empty() &&
+         key_schema.GetColumn(0).GetType() == TypeId::INTEGER;
+}
+
+}  // namespace
+
 auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext> {
   return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
 }
 
-BustubInstance::BustubInstance(const std::string &db_file_name) {
+BustubInstance::BustubInstance(const std::string &db_file_name, size_t bpm_num_instances, bool posix_io) {
   enable_logging = false;
 
   // Storage related.
-  disk_manager_ = new DiskManager(db_file_name);
+  if (posix_io) {
+    disk_manager_ = new DiskManagerPosix(db_file_name);
+  } else {
+    disk_manager_ = new DiskManager(db_file_name);
+  }
 
   // Log related.
   log_manager_ = new LogManager(disk_manager_);
 
   // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
-  // buffer pool size specified in `config.h`.
+  // buffer pool size specified in `config.h`. When sharded, every shard gets 128 frames. Pages go to a real
+  // file here, so a background writer keeps the next victims clean.
   try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    if (bpm_num_instances > 1) {
+      auto *bpm = new ParallelBufferPoolManager(bpm_num_instances, 128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+      bpm->StartBackgroundWriter();
+      buffer_pool_manager_ = bpm;
+    } else {
+      auto *bpm = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+      bpm->StartBackgroundWriter();
+      buffer_pool_manager_ = bpm;
+    }
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -71,9 +101,17 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
 
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
+
+  if (buffer_pool_manager_ != nullptr) {
+    if (disk_manager_->GetNumPages() > 0) {
+      OpenDatabase();
+    } else {
+      CreateSystemPages(true);
+    }
+  }
 }
 
-BustubInstance::BustubInstance() {
+BustubInstance::BustubInstance(size_t bpm_num_instances) {
   enable_logging = false;
 
   // Storage related.
@@ -83,9 +121,14 @@ BustubInstance::BustubInstance() {
   log_manager_ = new LogManager(disk_manager_);
 
   // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
-  // buffer pool size specified in `config.h`.
+  // buffer pool size specified in `config.h`. When sharded, every shard gets 128 frames.
   try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    if (bpm_num_instances > 1) {
+      buffer_pool_manager_ =
+          new ParallelBufferPoolManager(bpm_num_instances, 128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    } else {
+      buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    }
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -103,6 +146,45 @@ BustubInstance::BustubInstance() {
 
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
+
+  if (buffer_pool_manager_ != nullptr) {
+    CreateSystemPages(false);
+  }
+}
+
+void BustubInstance::CreateSystemPages(bool persistent) {
+  page_id_t header_page_id;
+  auto header_guard = buffer_pool_manager_->NewPageGuarded(&header_page_id);
+  BUSTUB_ASSERT(header_page_id == HEADER_PAGE_ID, "the header page is the first page");
+  header_guard.AsPageMut<HeaderPage>()->Init();
+  header_guard.Drop();
+  if (persistent) {
+    page_id_t catalog_page_id;
+    buffer_pool_manager_->NewPageGuarded(&catalog_page_id).Drop();
+    BUSTUB_ASSERT(catalog_page_id == CATALOG_PAGE_ID, "the catalog starts right after the header page");
+    catalog_->EnablePersistence(catalog_page_id);
+  }
+}
+
+void BustubInstance::OpenDatabase() {
+  // new pages go past the ones in the file
+  buffer_pool_manager_->ReservePageIds(disk_manager_->GetNumPages());
+  for (const auto &index : catalog_->Open(CATALOG_PAGE_ID)) {
+    const auto *table_info = catalog_->GetTable(index.table_name_);
+    IndexInfo *info = nullptr;
+    if (table_info != nullptr) {
+      auto key_schema = Schema::CopySchema(&table_info->schema_, index.key_attrs_);
+      if (IsIntegerKey(key_schema, index.include_attrs_)) {
+        info = catalog_->AttachIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+            index, IntegerHashFunctionType{});
+      } else {
+        info = catalog_->AttachIndex<VarlenKeyType, RID, VarlenComparatorType>(index, VarlenHashFunctionType{});
+      }
+    }
+    if (info == nullptr) {
+      throw bustub::Exception(fmt::format("cannot open index {} of the database file", index.name_));
+    }
+  }
 }
 
 void BustubInstance::CmdDisplayTables(ResultWriter &writer) {
@@ -132,6 +214,7 @@ void BustubInstance::CmdDisplayIndices(ResultWriter &writer) {
   writer.WriteHeaderCell("index_oid");
   writer.WriteHeaderCell("index_name");
   writer.WriteHeaderCell("index_cols");
+  writer.WriteHeaderCell("index_type");
   writer.EndHeader();
   for (const auto &table_name : table_names) {
     for (const auto *index_info : catalog_->GetTableIndexes(table_name)) {
@@ -140,12 +223,53 @@ void BustubInstance::CmdDisplayIndices(ResultWriter &writer) {
       writer.WriteCell(fmt::format("{}", index_info->index_oid_));
       writer.WriteCell(index_info->name_);
       writer.WriteCell(index_info->key_schema_.ToString());
+      writer.WriteCell(index_info->index_type_ == IndexType::HashTableIndex ? "hash" : "bplustree");
       writer.EndRow();
     }
   }
   writer.EndTable();
 }
 
+auto BustubInstance::GetBufferPoolStats() -> BufferPoolStats {
+  if (buffer_pool_manager_ == nullptr) {
+    return {};
+  }
+  return buffer_pool_manager_->GetStats();
+}
+
+void BustubInstance::CmdDisplayStats(ResultWriter &writer) {
+  auto stats = GetBufferPoolStats();
+  std::vector<std::pair<std::string, std::string>> rows = {
+      {"hits", fmt::format("{}", stats.Get(BufferPoolCounter::HIT))},
+      {"misses", fmt::format("{}", stats.Get(BufferPoolCounter::MISS))},
+      {"hit_ratio", fmt::format("{:.4f}", stats.HitRatio())},
+      {"evictions", fmt::format("{}", stats.Get(BufferPoolCounter::EVICTION))},
+      {"sync_writebacks", fmt::format("{}", stats.Get(BufferPoolCounter::SYNC_WRITEBACK))},
+      {"background_writebacks", fmt::format("{}", stats.Get(BufferPoolCounter::BACKGROUND_WRITEBACK))},
+      {"prefetched_pages", fmt::format("{}", stats.Get(BufferPoolCounter::PREFETCHED_PAGE))},
+      {"pin_waits", fmt::format("{}", stats.Get(BufferPoolCounter::PIN_WAIT))},
+      {"page_table_lookups", fmt::format("{}", stats.Get(BufferPoolCounter::PAGE_TABLE_LOOKUP))},
+      {"avg_probe_length", fmt::format("{:.2f}", stats.AvgProbeLength())},
+      {"read_latency_p50_us", fmt::format("{}", BufferPoolStats::LatencyQuantile(stats.read_latency_, 0.5))},
+      {"read_latency_p99_us", fmt::format("{}", BufferPoolStats::LatencyQuantile(stats.read_latency_, 0.99))},
+      {"write_latency_p50_us", fmt::format("{}", BufferPoolStats::LatencyQuantile(stats.write_latency_, 0.5))},
+      {"write_latency_p99_us", fmt::format("{}", BufferPoolStats::LatencyQuantile(stats.write_latency_, 0.99))},
+  };
+
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  writer.WriteHeaderCell("metric");
+  writer.WriteHeaderCell("value");
+  writer.EndHeader();
+  for (const auto &[metric, value] : rows) {
+    writer.BeginRow();
+    writer.WriteCell(metric);
+    writer.WriteCell(value);
+    writer.EndRow();
+  }
+  writer.EndTable();
+}
+
 void BustubInstance::WriteOneCell(const std::string &cell, ResultWriter &writer) {
   writer.BeginTable(true);
   writer.BeginRow();
@@ -159,6 +283,7 @@ void BustubInstance::CmdDisplayHelp(ResultWriter &writer) {
 
 \dt: show all tables
 \di: show all indices
+\stats: show buffer pool metrics
 \help: show this message again
 
 BusTub shell currently only supports a small set of Postgres queries. We'll set
@@ -191,6 +316,10 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       CmdDisplayIndices(writer);
       return true;
     }
+    if (sql == "\\stats") {
+      CmdDisplayStats(writer);
+      return true;
+    }
     if (sql == "\\help") {
       CmdDisplayHelp(writer);
       return true;
@@ -228,19 +357,51 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         for (const auto &col : index_stmt.cols_) {
           auto idx = index_stmt.table_->schema_.GetColIdx(col->col_name_.back());
           col_ids.push_back(idx);
-          if (index_stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
-            throw NotImplementedException("only support creating index on integer column");
-          }
         }
-        if (col_ids.size() != 1) {
-          throw NotImplementedException("only support creating index with exactly one column");
+        std::vector<uint32_t> include_ids;
+        for (const auto &col : index_stmt.include_cols_) {
+          include_ids.push_back(index_stmt.table_->schema_.GetColIdx(col->col_name_.back()));
         }
         auto key_schema = Schema::CopySchema(&index_stmt.table_->schema_, col_ids);
+        bool is_integer_key = IsIntegerKey(key_schema, include_ids);
+        auto entry_ids = col_ids;
+        entry_ids.insert(entry_ids.end(), include_ids.begin(), include_ids.end());
+        auto entry_schema = Schema::CopySchema(&index_stmt.table_->schema_, entry_ids);
+        size_t max_key_size = entry_schema.GetLength();
+        for (const auto &column : entry_schema.GetColumns()) {
+          if (!column.IsInlined()) {
+            max_key_size += sizeof(uint32_t) + column.GetVariableLength() + 1;
+          }
+        }
+        if (!is_integer_key && max_key_size > VARLEN_KEY_SIZE) {
+          throw NotImplementedException(
+              fmt::format("index key can be {} bytes, only support up to {}", max_key_size, VARLEN_KEY_SIZE));
+        }
+
+        IndexType index_type;
+        if (index_stmt.index_type_ == "bplustree" || index_stmt.index_type_ == "btree") {
+          index_type = IndexType::BPlusTreeIndex;
+        } else if (index_stmt.index_type_ == "hash") {
+          index_type = IndexType::HashTableIndex;
+        } else {
+          throw NotImplementedException(fmt::format("unsupported index type {}", index_stmt.index_type_));
+        }
+
+        if (!is_integer_key && index_type == IndexType::HashTableIndex) {
+          throw NotImplementedException("only support creating hash index on one integer column without included ones");
+        }
 
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-            txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
-            INTEGER_SIZE, IntegerHashFunctionType{});
+        IndexInfo *info;
+        if (is_integer_key) {
+          info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+              txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
+              INTEGER_SIZE, IntegerHashFunctionType{}, index_type);
+        } else {
+          info = catalog_->CreateIndex<VarlenKeyType, RID, VarlenComparatorType>(
+              txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
+              VARLEN_KEY_SIZE, VarlenHashFunctionType{}, index_type, include_ids);
+        }
         l.unlock();
 
         if (info == nullptr) {
@@ -388,6 +549,10 @@ void BustubInstance::GenerateMockTable() {
 }
 
 BustubInstance::~BustubInstance() {
+  // everything the catalog refers to has to be in the database file to open it again
+  if (catalog_->IsPersistent()) {
+    buffer_pool_manager_->FlushAllPages();
+  }
   if (enable_logging) {
     log_manager_->StopFlushThread();
   }
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -26,7 +27,19 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                          const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
     : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  //  implement me!
+  // start out with a directory of global depth 0 pointing at a single empty bucket
+  auto dir_guard = buffer_pool_manager_->NewPageGuarded(&directory_page_id_);
+  page_id_t bucket_page_id = INVALID_PAGE_ID;
+  auto bucket_guard = buffer_pool_manager_->NewPageGuarded(&bucket_page_id);
+  if (!dir_guard.IsValid() || !bucket_guard.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate the pages of hash table " + name);
+  }
+  auto *dir_page = dir_guard.template AsMut<HashTableDirectoryPage>();
+  dir_page->SetPageId(directory_page_id_);
+  dir_page->SetBucketPageId(0, bucket_page_id);
+  dir_page->SetLocalDepth(0, 0);
+  // a fresh page is already an empty bucket, but it has to reach the disk before it can be read back
+  bucket_guard.GetDataMut();
 }
 
 /*****************************************************************************
@@ -45,23 +58,31 @@ auto HASH_TABLE_TYPE::Hash(KeyType key) -> uint32_t {
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t {
-  return 0;
+inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, const HashTableDirectoryPage *dir_page) -> uint32_t {
+  return Hash(key) & dir_page->GetGlobalDepthMask();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t {
-  return 0;
+inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, const HashTableDirectoryPage *dir_page) -> page_id_t {
+  return dir_page->GetBucketPageId(KeyToDirectoryIndex(key, dir_page));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::FetchDirectoryPage() -> HashTableDirectoryPage * {
-  return nullptr;
+  Page *page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame for the hash table directory page");
+  }
+  return reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE * {
-  return nullptr;
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame for a hash table bucket page");
+  }
+  return reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
 }
 
 /*****************************************************************************
@@ -69,7 +90,18 @@ auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BU
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  auto dir_guard = buffer_pool_manager_->FetchPageRead(directory_page_id_);
+  if (!dir_guard.IsValid()) {
+    return false;
+  }
+  const page_id_t bucket_page_id = KeyToPageId(key, dir_guard.template As<HashTableDirectoryPage>());
+  auto bucket_guard = buffer_pool_manager_->FetchPageRead(bucket_page_id);
+  // splits and merges latch the bucket before touching it, so the directory is no longer needed
+  dir_guard.Drop();
+  if (!bucket_guard.IsValid()) {
+    return false;
+  }
+  return bucket_guard.template As<HASH_TABLE_BUCKET_TYPE>()->GetValue(key, comparator_, result);
 }
 
 /*****************************************************************************
@@ -77,12 +109,86 @@ auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  {
+    auto dir_guard = buffer_pool_manager_->FetchPageRead(directory_page_id_);
+    if (!dir_guard.IsValid()) {
+      return false;
+    }
+    const page_id_t bucket_page_id = KeyToPageId(key, dir_guard.template As<HashTableDirectoryPage>());
+    auto bucket_guard = buffer_pool_manager_->FetchPageWrite(bucket_page_id);
+    dir_guard.Drop();
+    if (!bucket_guard.IsValid()) {
+      return false;
+    }
+    if (!bucket_guard.template As<HASH_TABLE_BUCKET_TYPE>()->IsFull()) {
+      return bucket_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>()->Insert(key, value, comparator_);
+    }
+  }
+  // the bucket latch is released before the directory is latched again, latches are always taken directory first
+  return SplitInsert(transaction, key, value);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.WLock();
+  auto dir_guard = buffer_pool_manager_->FetchPageWrite(directory_page_id_);
+  bool inserted = false;
+  // keep splitting the key's bucket until the key fits; all its entries may land on the same side of a split
+  while (dir_guard.IsValid()) {
+    const auto *dir_page = dir_guard.template As<HashTableDirectoryPage>();
+    const uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    const uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    auto bucket_guard = buffer_pool_manager_->FetchPageWrite(dir_page->GetBucketPageId(bucket_idx));
+    if (!bucket_guard.IsValid()) {
+      break;
+    }
+    const auto *bucket = bucket_guard.template As<HASH_TABLE_BUCKET_TYPE>();
+    if (!bucket->IsFull()) {
+      // somebody else split the bucket while we were waiting for the directory
+      inserted = bucket_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>()->Insert(key, value, comparator_);
+      break;
+    }
+    std::vector<ValueType> values;
+    if (bucket->GetValue(key, comparator_, &values) && std::find(values.begin(), values.end(), value) != values.end()) {
+      break;
+    }
+    if (local_depth == dir_page->GetGlobalDepth() && dir_page->Size() == DIRECTORY_ARRAY_SIZE) {
+      LOG_WARN("hash table directory is full, cannot split bucket %u", bucket_idx);
+      break;
+    }
+
+    page_id_t image_page_id = INVALID_PAGE_ID;
+    auto image_basic_guard = buffer_pool_manager_->NewPageGuarded(&image_page_id);
+    if (!image_basic_guard.IsValid()) {
+      break;
+    }
+    auto image_guard = image_basic_guard.UpgradeWrite();
+
+    // entries whose hash has the new depth bit set move to the split image
+    const uint32_t high_bit = 1U << local_depth;
+    auto *bucket_mut = bucket_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>();
+    auto *image = image_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>();
+    for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE; i++) {
+      if (bucket_mut->IsReadable(i) && (Hash(bucket_mut->KeyAt(i)) & high_bit) != 0) {
+        image->Insert(bucket_mut->KeyAt(i), bucket_mut->ValueAt(i), comparator_);
+        bucket_mut->RemoveAt(i);
+      }
+    }
+
+    auto *dir_mut = dir_guard.template AsMut<HashTableDirectoryPage>();
+    if (local_depth == dir_mut->GetGlobalDepth()) {
+      dir_mut->IncrGlobalDepth();
+    }
+    // the bucket owns every slot that agrees with bucket_idx on the low local_depth bits
+    for (uint32_t i = bucket_idx & (high_bit - 1); i < dir_mut->Size(); i += high_bit) {
+      dir_mut->SetLocalDepth(i, local_depth + 1);
+      if ((i & high_bit) != 0) {
+        dir_mut->SetBucketPageId(i, image_page_id);
+      }
+    }
+  }
+  table_latch_.WUnlock();
+  return inserted;
 }
 
 /*****************************************************************************
@@ -90,14 +196,72 @@ auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  bool removed = false;
+  bool empty = false;
+  {
+    auto dir_guard = buffer_pool_manager_->FetchPageRead(directory_page_id_);
+    if (!dir_guard.IsValid()) {
+      return false;
+    }
+    const page_id_t bucket_page_id = KeyToPageId(key, dir_guard.template As<HashTableDirectoryPage>());
+    auto bucket_guard = buffer_pool_manager_->FetchPageWrite(bucket_page_id);
+    dir_guard.Drop();
+    if (!bucket_guard.IsValid()) {
+      return false;
+    }
+    removed = bucket_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>()->Remove(key, value, comparator_);
+    empty = bucket_guard.template As<HASH_TABLE_BUCKET_TYPE>()->IsEmpty();
+  }
+  if (removed && empty) {
+    Merge(transaction, key, value);
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {}
+void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  auto dir_guard = buffer_pool_manager_->FetchPageWrite(directory_page_id_);
+  // merging may leave the surviving bucket empty with an empty image of its own, so keep going
+  while (dir_guard.IsValid()) {
+    const auto *dir_page = dir_guard.template As<HashTableDirectoryPage>();
+    const uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    const uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (local_depth == 0) {
+      break;
+    }
+    const uint32_t image_idx = dir_page->GetSplitImageIndex(bucket_idx);
+    if (dir_page->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    const page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    const page_id_t image_page_id = dir_page->GetBucketPageId(image_idx);
+    {
+      // an insert may have refilled the bucket since Remove() let go of it
+      auto bucket_guard = buffer_pool_manager_->FetchPageWrite(bucket_page_id);
+      if (!bucket_guard.IsValid() || !bucket_guard.template As<HASH_TABLE_BUCKET_TYPE>()->IsEmpty()) {
+        break;
+      }
+    }
+
+    // the merged bucket owns every slot that agrees with bucket_idx on the low local_depth - 1 bits
+    auto *dir_mut = dir_guard.template AsMut<HashTableDirectoryPage>();
+    const uint32_t step = 1U << (local_depth - 1);
+    for (uint32_t i = bucket_idx & (step - 1); i < dir_mut->Size(); i += step) {
+      dir_mut->SetBucketPageId(i, image_page_id);
+      dir_mut->SetLocalDepth(i, local_depth - 1);
+    }
+    while (dir_mut->CanShrink()) {
+      dir_mut->DecrGlobalDepth();
+    }
+    // nothing can reach the bucket any more: new readers go through the directory, which we hold exclusively
+    buffer_pool_manager_->DeletePage(bucket_page_id);
+  }
+  table_latch_.WUnlock();
+}
 
 /*****************************************************************************
  * GETGLOBALDEPTH - DO NOT TOUCH
@@ -105,7 +269,13 @@ void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetGlobalDepth() -> uint32_t {
   table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  HashTableDirectoryPage *dir_page;
+  try {
+    dir_page = FetchDirectoryPage();
+  } catch (...) {
+    table_latch_.RUnlock();
+    throw;
+  }
   uint32_t global_depth = dir_page->GetGlobalDepth();
   assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr));
   table_latch_.RUnlock();
@@ -118,7 +288,13 @@ auto HASH_TABLE_TYPE::GetGlobalDepth() -> uint32_t {
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::VerifyIntegrity() {
   table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  HashTableDirectoryPage *dir_page;
+  try {
+    dir_page = FetchDirectoryPage();
+  } catch (...) {
+    table_latch_.RUnlock();
+    throw;
+  }
   dir_page->VerifyIntegrity();
   assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr));
   table_latch_.RUnlock();
@@ -10,8 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
@@ -26,21 +28,107 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+    : min_size_(std::max<size_t>(num_buckets, 1)),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(std::move(hash_fn)) {
+  header_page_id_ = CreateBlockPages(min_size_);
+  if (header_page_id_ == INVALID_PAGE_ID) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate the pages of hash table " + name);
+  }
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  table_latch_.RLock();
+  bool found = LookupIn(header_page_id_, key, result);
+  // entries that have not been moved over yet are still in the old block pages
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    found = LookupIn(old_header_page_id_, key, result) || found;
+  }
+  table_latch_.RUnlock();
+  return found;
 }
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  HelpResize();
+
+  table_latch_.RLock();
+  auto result = InsertResult::DUPLICATE;
+  std::vector<ValueType> old_values;
+  if (old_header_page_id_ == INVALID_PAGE_ID || !LookupIn(old_header_page_id_, key, &old_values) ||
+      std::find(old_values.begin(), old_values.end(), value) == old_values.end()) {
+    result = InsertInto(header_page_id_, key, value);
+  }
+  size_t size = 0;
+  {
+    auto header_guard = buffer_pool_manager_->FetchPageRead(header_page_id_);
+    size = header_guard.template As<HashTableHeaderPage>()->GetSize();
+  }
+  // counted under the latch, so that every insert is counted either before a resize starts a new count, and then
+  // again when its entry moves over, or after it
+  bool rebuild = false;
+  if (result == InsertResult::INSERTED) {
+    num_live_++;
+    rebuild = static_cast<double>(num_occupied_.fetch_add(1) + 1) > MAX_LOAD_FACTOR * static_cast<double>(size);
+  }
+  table_latch_.RUnlock();
+
+  switch (result) {
+    case InsertResult::INSERTED:
+      if (rebuild) {
+        Rebuild();
+      }
+      return true;
+    case InsertResult::DUPLICATE:
+      return false;
+    case InsertResult::TABLE_FULL:
+      break;
+  }
+  // only a resize that could not keep up gets here: finish it, grow past the size that was full and retry
+  FinishResize();
+  if (!Resize(size)) {
+    LOG_WARN("linear probe hash table is full and cannot grow");
+    return false;
+  }
+  return Insert(transaction, key, value);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::InsertInto(page_id_t header_page_id, const KeyType &key, const ValueType &value)
+    -> InsertResult {
+  auto header_guard = buffer_pool_manager_->FetchPageRead(header_page_id);
+  const auto *header = header_guard.template As<HashTableHeaderPage>();
+  const size_t size = header->GetSize();
+  size_t slot = hash_fn_.GetHash(key) % size;
+  // walk the probe sequence one block at a time, each block scanned in bulk up to its first never occupied slot
+  for (size_t remaining = size; remaining > 0;) {
+    const size_t block_idx = slot / BLOCK_ARRAY_SIZE;
+    const size_t from = slot % BLOCK_ARRAY_SIZE;
+    const size_t to = std::min({BLOCK_ARRAY_SIZE, size - block_idx * BLOCK_ARRAY_SIZE, from + remaining});
+    auto block_guard = buffer_pool_manager_->FetchPageWrite(header->GetBlockPageId(block_idx));
+    const auto *block = block_guard.template As<HASH_TABLE_BLOCK_TYPE>();
+    const slot_offset_t end = block->NextUnoccupied(from, to);
+    if (block->FindPair(from, end, key, value, comparator_) != end) {
+      return InsertResult::DUPLICATE;
+    }
+    // tombstones are never reused, so two inserts of the same pair always race for the same slot and the loser
+    // sees the winner's pair
+    if (end < to) {
+      block_guard.template AsMut<HASH_TABLE_BLOCK_TYPE>()->Insert(end, key, value);
+      return InsertResult::INSERTED;
+    }
+    remaining -= to - from;
+    slot = (slot + to - from) % size;
+  }
+  return InsertResult::TABLE_FULL;
 }
 
 /*****************************************************************************
@@ -48,6 +136,44 @@ auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
+  HelpResize();
+
+  table_latch_.RLock();
+  bool removed = RemoveFrom(header_page_id_, key, value);
+  if (!removed && old_header_page_id_ != INVALID_PAGE_ID) {
+    removed = RemoveFrom(old_header_page_id_, key, value);
+  }
+  if (removed) {
+    num_live_--;
+  }
+  table_latch_.RUnlock();
+  return removed;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::RemoveFrom(page_id_t header_page_id, const KeyType &key, const ValueType &value) -> bool {
+  auto header_guard = buffer_pool_manager_->FetchPageRead(header_page_id);
+  const auto *header = header_guard.template As<HashTableHeaderPage>();
+  const size_t size = header->GetSize();
+  size_t slot = hash_fn_.GetHash(key) % size;
+  for (size_t remaining = size; remaining > 0;) {
+    const size_t block_idx = slot / BLOCK_ARRAY_SIZE;
+    const size_t from = slot % BLOCK_ARRAY_SIZE;
+    const size_t to = std::min({BLOCK_ARRAY_SIZE, size - block_idx * BLOCK_ARRAY_SIZE, from + remaining});
+    auto block_guard = buffer_pool_manager_->FetchPageWrite(header->GetBlockPageId(block_idx));
+    const auto *block = block_guard.template As<HASH_TABLE_BLOCK_TYPE>();
+    const slot_offset_t end = block->NextUnoccupied(from, to);
+    const slot_offset_t pair_ind = block->FindPair(from, end, key, value, comparator_);
+    if (pair_ind != end) {
+      block_guard.template AsMut<HASH_TABLE_BLOCK_TYPE>()->Remove(pair_ind);
+      return true;
+    }
+    if (end < to) {
+      return false;
+    }
+    remaining -= to - from;
+    slot = (slot + to - from) % size;
+  }
   return false;
 }
 
@@ -55,14 +181,209 @@ auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+auto HASH_TABLE_TYPE::Resize(size_t initial_size) -> bool {
+  if (resizing_.exchange(true)) {
+    // the resize in progress grows the table
+    return true;
+  }
+  // only a resize changes the size, but another one may have finished since initial_size was read
+  const size_t size = GetSize();
+  if (size > initial_size) {
+    resizing_ = false;
+    return true;
+  }
+  return StartResize(2 * size);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::Rebuild() {
+  if (resizing_.exchange(true)) {
+    return;
+  }
+  // another rebuild may have emptied the table of tombstones since the caller found it too full
+  const size_t size = GetSize();
+  if (static_cast<double>(num_occupied_) <= MAX_LOAD_FACTOR * static_cast<double>(size)) {
+    resizing_ = false;
+    return;
+  }
+  // entries that are removed or inserted meanwhile only shift the count by as much as the rebuild leaves room for
+  const auto live = static_cast<double>(num_live_);
+  size_t new_size = size;
+  if (live > MAX_LOAD_FACTOR / 2 * static_cast<double>(size)) {
+    new_size = 2 * size;
+  } else {
+    while (new_size / 2 >= min_size_ && live < MAX_LOAD_FACTOR / 4 * static_cast<double>(new_size / 2)) {
+      new_size /= 2;
+    }
+  }
+  StartResize(new_size);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::StartResize(size_t new_size) -> bool {
+  // nobody can see the new block pages yet, so they are set up without the latch
+  const page_id_t new_header_page_id = CreateBlockPages(new_size);
+  if (new_header_page_id == INVALID_PAGE_ID) {
+    LOG_WARN("cannot allocate the block pages to resize the linear probe hash table to %zu slots", new_size);
+    resizing_ = false;
+    return false;
+  }
+  table_latch_.WLock();
+  old_header_page_id_ = header_page_id_;
+  header_page_id_ = new_header_page_id;
+  migrate_cursor_ = 0;
+  // the new block pages are empty; every entry of the old ones is counted again as it moves over
+  num_occupied_ = 0;
+  table_latch_.WUnlock();
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::FinishResize() {
+  while (resizing_) {
+    HelpResize();
+    // a resize that is still allocating has nothing to move yet
+    std::this_thread::yield();
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::HelpResize() {
+  if (!resizing_) {
+    return;
+  }
+  table_latch_.WLock();
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    MigrateSlots(MIGRATION_BATCH_SLOTS);
+  }
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MigrateSlots(size_t max_slots) {
+  {
+    auto old_header_guard = buffer_pool_manager_->FetchPageRead(old_header_page_id_);
+    const auto *old_header = old_header_guard.template As<HashTableHeaderPage>();
+    const size_t end = std::min(old_header->GetSize(), migrate_cursor_ + max_slots);
+    while (migrate_cursor_ < end) {
+      const size_t block_idx = migrate_cursor_ / BLOCK_ARRAY_SIZE;
+      const size_t block_start = block_idx * BLOCK_ARRAY_SIZE;
+      const size_t to = std::min(BLOCK_ARRAY_SIZE, end - block_start);
+      auto block_guard = buffer_pool_manager_->FetchPageWrite(old_header->GetBlockPageId(block_idx));
+      const auto *block = block_guard.template As<HASH_TABLE_BLOCK_TYPE>();
+      // tombstones are left behind; only live pairs move
+      for (auto offset = block->NextReadable(migrate_cursor_ - block_start, to); offset < to;
+           offset = block->NextReadable(offset + 1, to)) {
+        const auto result = InsertInto(header_page_id_, block->KeyAt(offset), block->ValueAt(offset));
+        if (result == InsertResult::TABLE_FULL) {
+          LOG_WARN("linear probe hash table filled up while resizing");
+          migrate_cursor_ = block_start + offset;
+          return;
+        }
+        if (result == InsertResult::INSERTED) {
+          num_occupied_++;
+        } else {
+          // the pair made it to the new block pages already and was counted twice
+          num_live_--;
+        }
+        block_guard.template AsMut<HASH_TABLE_BLOCK_TYPE>()->Remove(offset);
+      }
+      migrate_cursor_ = block_start + to;
+    }
+    if (migrate_cursor_ < old_header->GetSize()) {
+      return;
+    }
+  }
+  DeleteBlockPages(old_header_page_id_);
+  old_header_page_id_ = INVALID_PAGE_ID;
+  resizing_ = false;
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetSize() -> size_t {
-  return 0;
+  table_latch_.RLock();
+  size_t size = 0;
+  {
+    auto header_guard = buffer_pool_manager_->FetchPageRead(header_page_id_);
+    size = header_guard.template As<HashTableHeaderPage>()->GetSize();
+  }
+  table_latch_.RUnlock();
+  return size;
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::LookupIn(page_id_t header_page_id, const KeyType &key, std::vector<ValueType> *result) -> bool {
+  auto header_guard = buffer_pool_manager_->FetchPageRead(header_page_id);
+  const auto *header = header_guard.template As<HashTableHeaderPage>();
+  const size_t size = header->GetSize();
+  size_t slot = hash_fn_.GetHash(key) % size;
+  bool found = false;
+  for (size_t remaining = size; remaining > 0;) {
+    const size_t block_idx = slot / BLOCK_ARRAY_SIZE;
+    const size_t from = slot % BLOCK_ARRAY_SIZE;
+    const size_t to = std::min({BLOCK_ARRAY_SIZE, size - block_idx * BLOCK_ARRAY_SIZE, from + remaining});
+    auto block_guard = buffer_pool_manager_->FetchPageRead(header->GetBlockPageId(block_idx));
+    const auto *block = block_guard.template As<HASH_TABLE_BLOCK_TYPE>();
+    const slot_offset_t end = block->NextUnoccupied(from, to);
+    found = block->GetValues(from, end, key, comparator_, result) || found;
+    if (end < to) {
+      break;
+    }
+    remaining -= to - from;
+    slot = (slot + to - from) % size;
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::CreateBlockPages(size_t num_buckets) -> page_id_t {
+  const size_t num_blocks = (num_buckets + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE;
+  if (num_blocks > HashTableHeaderPage::MaxBlocks()) {
+    return INVALID_PAGE_ID;
+  }
+  page_id_t header_page_id = INVALID_PAGE_ID;
+  auto header_guard = buffer_pool_manager_->NewPageGuarded(&header_page_id);
+  if (!header_guard.IsValid()) {
+    return INVALID_PAGE_ID;
+  }
+  auto *header = header_guard.template AsMut<HashTableHeaderPage>();
+  header->SetPageId(header_page_id);
+  header->SetSize(num_buckets);
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id = INVALID_PAGE_ID;
+    auto block_guard = buffer_pool_manager_->NewPageGuarded(&block_page_id);
+    if (!block_guard.IsValid()) {
+      header_guard.Drop();
+      DeleteBlockPages(header_page_id);
+      return INVALID_PAGE_ID;
+    }
+    // a zeroed page is an empty block, but it has to reach the disk before it can be read back
+    block_guard.GetDataMut();
+    header->AddBlockPageId(block_page_id);
+  }
+  return header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::DeleteBlockPages(page_id_t header_page_id) {
+  std::vector<page_id_t> block_page_ids;
+  {
+    auto header_guard = buffer_pool_manager_->FetchPageRead(header_page_id);
+    const auto *header = header_guard.template As<HashTableHeaderPage>();
+    for (size_t i = 0; i < header->NumBlocks(); i++) {
+      block_page_ids.push_back(header->GetBlockPageId(i));
+    }
+  }
+  for (auto block_page_id : block_page_ids) {
+    buffer_pool_manager_->DeletePage(block_page_id);
+  }
+  buffer_pool_manager_->DeletePage(header_page_id);
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -16,6 +16,10 @@
 #include <list>
 #include <utility>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "container/hash/extendible_hash_table.h"
 #include "storage/page/page.h"
 
@@ -23,7 +27,9 @@ namespace bustub {
 
 template <typename K, typename V>
 ExtendibleHashTable<K, V>::ExtendibleHashTable(size_t bucket_size)
-    : global_depth_(0), bucket_size_(bucket_size), num_buckets_(1) {}
+    : global_depth_(0), bucket_size_(bucket_size), num_buckets_(1) {
+  dir_.push_back(std::make_shared<Bucket>(bucket_size_, 0));
+}
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::IndexOf(const K &key) -> size_t {
@@ -33,7 +39,7 @@ auto ExtendibleHashTable<K, V>::IndexOf(const K &key) -> size_t {
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::GetGlobalDepth() const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
+  std::shared_lock<std::shared_mutex> lock(latch_);
   return GetGlobalDepthInternal();
 }
 
@@ -44,7 +50,7 @@ auto ExtendibleHashTable<K, V>::GetGlobalDepthInternal() const -> int {
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::GetLocalDepth(int dir_index) const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
+  std::shared_lock<std::shared_mutex> lock(latch_);
   return GetLocalDepthInternal(dir_index);
 }
 
@@ -55,7 +61,7 @@ auto ExtendibleHashTable<K, V>::GetLocalDepthInternal(int dir_index) const -> in
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::GetNumBuckets() const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
+  std::shared_lock<std::shared_mutex> lock(latch_);
   return GetNumBucketsInternal();
 }
 
@@ -66,38 +72,332 @@ auto ExtendibleHashTable<K, V>::GetNumBucketsInternal() const -> int {
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Find(const K &key, V &value) -> bool {
-  UNREACHABLE("not implemented");
+  return Find(key, value, nullptr);
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::Find(const K &key, V &value, size_t *probes) -> bool {
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  auto &bucket = dir_[IndexOf(key)];
+  std::shared_lock<std::shared_mutex> bucket_lock(bucket->GetLatch());
+  return bucket->Find(key, value, probes);
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Remove(const K &key) -> bool {
-  UNREACHABLE("not implemented");
+  {
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    auto &bucket = dir_[IndexOf(key)];
+    std::scoped_lock<std::shared_mutex> bucket_lock(bucket->GetLatch());
+    if (!bucket->Remove(key)) {
+      return false;
+    }
+    if (bucket->GetDepth() == 0 || bucket->Count() > bucket_size_ / 4) {
+      return true;
+    }
+  }
+  // The bucket is at the low-water mark. MergeBucket() checks again, other threads may have refilled it by now.
+  std::scoped_lock<std::shared_mutex> lock(latch_);
+  MergeBucket(key);
+  return true;
 }
 
 template <typename K, typename V>
 void ExtendibleHashTable<K, V>::Insert(const K &key, const V &value) {
-  UNREACHABLE("not implemented");
+  {
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    auto &bucket = dir_[IndexOf(key)];
+    std::scoped_lock<std::shared_mutex> bucket_lock(bucket->GetLatch());
+    if (bucket->Insert(key, value)) {
+      return;
+    }
+  }
+  // The bucket is full. Another thread may split it before we get the directory, InsertWithSplit() copes with that.
+  std::scoped_lock<std::shared_mutex> lock(latch_);
+  InsertWithSplit(key, value);
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::InsertWithSplit(const K &key, const V &value) {
+  // Nobody else holds the directory latch, so no bucket latch is held either.
+  while (!dir_[IndexOf(key)]->Insert(key, value)) {
+    auto bucket = dir_[IndexOf(key)];
+    // The directory has to double before a bucket at global depth can be split.
+    if (bucket->GetDepth() == global_depth_) {
+      size_t old_size = dir_.size();
+      dir_.reserve(old_size * 2);
+      for (size_t i = 0; i < old_size; i++) {
+        dir_.push_back(dir_[i]);
+      }
+      global_depth_++;
+    }
+    RedistributeBucket(bucket);
+  }
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::RedistributeBucket(std::shared_ptr<Bucket> bucket) -> void {
+  bucket->IncrementDepth();
+  int depth = bucket->GetDepth();
+  size_t high_bit = 1 << (depth - 1);
+  auto image = std::make_shared<Bucket>(bucket_size_, depth);
+  num_buckets_++;
+
+  // Move every entry whose new distinguishing bit is set into the split image.
+  const size_t low_bits = std::hash<K>()(bucket->AnyKey()) & (high_bit - 1);
+  bucket->SplitInto(image.get(), high_bit);
+
+  // Repoint the half of the directory slots that referenced the old bucket. Those slots all agree with the bucket's
+  // entries on the low depth - 1 bits, so only every high_bit-th slot has to be looked at.
+  for (size_t i = low_bits; i < dir_.size(); i += high_bit) {
+    if ((i & high_bit) != 0) {
+      dir_[i] = image;
+    }
+  }
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::MergeBucket(const K &key) {
+  bool merged = false;
+  while (true) {
+    const size_t index = IndexOf(key);
+    auto bucket = dir_[index];
+    const int depth = bucket->GetDepth();
+    if (depth == 0) {
+      break;
+    }
+    const size_t high_bit = 1 << (depth - 1);
+    auto image = dir_[index ^ high_bit];
+    // An image that was split further has to merge back itself first.
+    if (image->GetDepth() != depth || bucket->Count() + image->Count() > bucket_size_ / 2) {
+      break;
+    }
+    bucket->MergeFrom(image.get());
+    bucket->DecrementDepth();
+    num_buckets_--;
+    // Every slot of the image agrees with it on the low depth bits.
+    for (size_t i = (index ^ high_bit) & ((high_bit << 1) - 1); i < dir_.size(); i += high_bit << 1) {
+      dir_[i] = bucket;
+    }
+    merged = true;
+  }
+  if (!merged) {
+    return;
+  }
+
+  // The upper half of the directory mirrors the lower half as long as no bucket is at global depth.
+  while (global_depth_ > 0) {
+    const size_t half = dir_.size() / 2;
+    bool all_below = true;
+    for (size_t i = 0; i < half; i++) {
+      if (dir_[i]->GetDepth() == global_depth_) {
+        all_below = false;
+        break;
+      }
+    }
+    if (!all_below) {
+      break;
+    }
+    dir_.resize(half);
+    global_depth_--;
+  }
 }
 
 //===--------------------------------------------------------------------===//
 // Bucket
 //===--------------------------------------------------------------------===//
 template <typename K, typename V>
-ExtendibleHashTable<K, V>::Bucket::Bucket(size_t array_size, int depth) : size_(array_size), depth_(depth) {}
+ExtendibleHashTable<K, V>::Bucket::Bucket(size_t array_size, int depth) : size_(array_size), depth_(depth) {
+  if constexpr (FLAT) {
+    tags_.resize(size_);
+    keys_.resize(size_);
+    values_.resize(size_);
+  }
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::Bucket::TagOf(const K &key) -> uint8_t {
+  // The directory indexes with the low bits of the hash, which are the same for most keys of a bucket.
+  return static_cast<uint8_t>((static_cast<uint64_t>(std::hash<K>()(key)) * 0x9E3779B97F4A7C15ULL) >> 56);
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::Bucket::FindIndex(const K &key, size_t *probes) const -> int {
+  if constexpr (std::is_integral_v<K> && sizeof(K) == 4) {
+    // Compare the keys directly; a tag would not be any cheaper to compare than the key itself.
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi32(static_cast<int32_t>(key));
+    for (; i + 4 <= count_; i += 4) {
+      const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&keys_[i]));
+      const int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(chunk, needle)));
+      if (mask != 0) {
+        const int index = static_cast<int>(i) + __builtin_ctz(mask);
+        *probes = index + 1;
+        return index;
+      }
+    }
+#endif
+    for (; i < count_; i++) {
+      if (keys_[i] == key) {
+        *probes = i + 1;
+        return static_cast<int>(i);
+      }
+    }
+    *probes = count_;
+    return -1;
+  } else {
+    const uint8_t tag = TagOf(key);
+    size_t compared = 0;
+    for (size_t i = 0; i < count_; i++) {
+      if (tags_[i] != tag) {
+        continue;
+      }
+      compared++;
+      if (keys_[i] == key) {
+        *probes = compared;
+        return static_cast<int>(i);
+      }
+    }
+    *probes = compared;
+    return -1;
+  }
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::Bucket::EraseAt(size_t index) {
+  count_--;
+  tags_[index] = tags_[count_];
+  keys_[index] = keys_[count_];
+  values_[index] = values_[count_];
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::Bucket::Append(const K &key, const V &value) {
+  tags_[count_] = TagOf(key);
+  keys_[count_] = key;
+  values_[count_] = value;
+  count_++;
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::Bucket::AnyKey() const -> const K & {
+  if constexpr (FLAT) {
+    return keys_[0];
+  } else {
+    return list_.front().first;
+  }
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::Bucket::SplitInto(Bucket *image, size_t high_bit) {
+  if constexpr (FLAT) {
+    for (size_t i = 0; i < count_;) {
+      if ((std::hash<K>()(keys_[i]) & high_bit) != 0) {
+        image->Append(keys_[i], values_[i]);
+        EraseAt(i);
+      } else {
+        i++;
+      }
+    }
+  } else {
+    for (auto it = list_.begin(); it != list_.end();) {
+      if ((std::hash<K>()(it->first) & high_bit) != 0) {
+        image->list_.push_back(*it);
+        it = list_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::Bucket::MergeFrom(Bucket *image) {
+  if constexpr (FLAT) {
+    for (size_t i = 0; i < image->count_; i++) {
+      Append(image->keys_[i], image->values_[i]);
+    }
+    image->count_ = 0;
+  } else {
+    list_.splice(list_.end(), image->list_);
+  }
+}
 
 template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::Bucket::Find(const K &key, V &value) -> bool {
-  UNREACHABLE("not implemented");
+auto ExtendibleHashTable<K, V>::Bucket::Find(const K &key, V &value, size_t *probes) -> bool {
+  size_t compared = 0;
+  bool found = false;
+  if constexpr (FLAT) {
+    int index = FindIndex(key, &compared);
+    if (index >= 0) {
+      value = values_[index];
+      found = true;
+    }
+  } else {
+    for (const auto &[k, v] : list_) {
+      compared++;
+      if (k == key) {
+        value = v;
+        found = true;
+        break;
+      }
+    }
+  }
+  if (probes != nullptr) {
+    *probes = compared;
+  }
+  return found;
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Bucket::Remove(const K &key) -> bool {
-  UNREACHABLE("not implemented");
+  if constexpr (FLAT) {
+    size_t probes;
+    int index = FindIndex(key, &probes);
+    if (index < 0) {
+      return false;
+    }
+    EraseAt(index);
+    return true;
+  } else {
+    for (auto it = list_.begin(); it != list_.end(); ++it) {
+      if (it->first == key) {
+        list_.erase(it);
+        return true;
+      }
+    }
+    return false;
+  }
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Bucket::Insert(const K &key, const V &value) -> bool {
-  UNREACHABLE("not implemented");
+  if constexpr (FLAT) {
+    size_t probes;
+    int index = FindIndex(key, &probes);
+    if (index >= 0) {
+      values_[index] = value;
+      return true;
+    }
+    if (IsFull()) {
+      return false;
+    }
+    Append(key, value);
+    return true;
+  } else {
+    for (auto &[k, v] : list_) {
+      if (k == key) {
+        v = value;
+        return true;
+      }
+    }
+    if (IsFull()) {
+      return false;
+    }
+    list_.emplace_back(key, value);
+    return true;
+  }
 }
 
 template class ExtendibleHashTable<page_id_t, Page *>;
@@ -11,12 +11,159 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "type/value_factory.h"
+
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      index_info_(exec_ctx->GetCatalog()->GetIndex(plan->GetIndexOid())),
+      table_heap_(exec_ctx->GetCatalog()->GetTable(index_info_->table_name_)->table_.get()) {}
+
+void IndexScanExecutor::Init() {
+  // each bound is a constant of the single key column
+  auto *key_schema = index_info_->index_->GetKeySchema();
+  lower_bound_.reset();
+  upper_bound_.reset();
+  if (plan_->lower_bound_ != nullptr) {
+    lower_bound_ = std::make_unique<Tuple>(std::vector<Value>{plan_->lower_bound_->Evaluate(nullptr, *key_schema)},
+                                           key_schema);
+  }
+  if (plan_->upper_bound_ != nullptr) {
+    upper_bound_ = std::make_unique<Tuple>(std::vector<Value>{plan_->upper_bound_->Evaluate(nullptr, *key_schema)},
+                                           key_schema);
+  }
+  if (plan_->index_only_) {
+    // the output columns are the table columns
+    const auto &entry_attrs = index_info_->index_->GetEntryAttrs();
+    entry_positions_.assign(GetOutputSchema().GetColumnCount(), -1);
+    for (size_t i = 0; i < entry_attrs.size(); i++) {
+      entry_positions_[entry_attrs[i]] = static_cast<int>(i);
+    }
+  }
+  num_produced_ = 0;
+  last_key_.reset();
+  Fetch(plan_->limit_.value_or(std::numeric_limits<size_t>::max()));
+}
+
+void IndexScanExecutor::Fetch(size_t num_entries) {
+  rids_.clear();
+  entries_.clear();
+  cursor_ = 0;
+  auto *index = index_info_->index_.get();
+  if (!plan_->index_only_ && !plan_->limit_.has_value()) {
+    index->ScanRange(lower_bound_.get(), upper_bound_.get(), plan_->reverse_, num_entries, &rids_,
+                     exec_ctx_->GetTransaction());
+    exhausted_ = rids_.size() < num_entries;
+    return;
+  }
+
+  // a scan with a limit may have to go on past the last entry it collected, so it collects the entries for their keys
+  const Tuple *lo = lower_bound_.get();
+  const Tuple *hi = upper_bound_.get();
+  if (last_key_ != nullptr) {
+    (plan_->reverse_ ? hi : lo) = last_key_.get();
+    num_entries++;
+  }
+  index->ScanRangeEntries(lo, hi, plan_->reverse_, num_entries, &entries_, exec_ctx_->GetTransaction());
+  exhausted_ = entries_.size() < num_entries;
+
+  // the bound is inclusive and keys are unique, so only the first entry can be the last one of the previous batch
+  auto *key_schema = index->GetKeySchema();
+  auto *entry_schema = index->GetEntrySchema();
+  if (last_key_ != nullptr && !entries_.empty()) {
+    bool same_key = true;
+    for (uint32_t i = 0; i < key_schema->GetColumnCount() && same_key; i++) {
+      same_key = entries_.front().first.GetValue(entry_schema, i).CompareEquals(last_key_->GetValue(key_schema, i)) ==
+                 CmpBool::CmpTrue;
+    }
+    if (same_key) {
+      entries_.erase(entries_.begin());
+    }
+  }
+  if (!entries_.empty()) {
+    // the entries hold the key columns first
+    std::vector<Value> key_values;
+    for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+      key_values.push_back(entries_.back().first.GetValue(entry_schema, i));
+    }
+    last_key_ = std::make_unique<Tuple>(key_values, key_schema);
+  }
+  if (!plan_->index_only_) {
+    for (const auto &entry : entries_) {
+      rids_.push_back(entry.second);
+    }
+    entries_.clear();
+  }
+}
+
+auto IndexScanExecutor::Refill() -> bool {
+  if (exhausted_ || !plan_->limit_.has_value() || num_produced_ >= *plan_->limit_) {
+    return false;
+  }
+  // some of the entries led nowhere: go on past the last one, far enough to make up for them
+  Fetch(*plan_->limit_ - num_produced_);
+  return !rids_.empty() || !entries_.empty();
+}
 
-void IndexScanExecutor::Init() { throw NotImplementedException("IndexScanExecutor is not implemented"); }
+auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (plan_->limit_.has_value() && num_produced_ >= *plan_->limit_) {
+    return false;
+  }
+  if (plan_->index_only_) {
+    return NextEntry(tuple, rid);
+  }
+  do {
+    while (cursor_ < rids_.size()) {
+      RID next_rid = rids_[cursor_++];
+      if (!table_heap_->GetTuple(next_rid, tuple, exec_ctx_->GetTransaction())) {
+        continue;
+      }
+      if (plan_->filter_predicate_ != nullptr) {
+        Value value = plan_->filter_predicate_->Evaluate(tuple, GetOutputSchema());
+        if (value.IsNull() || !value.GetAs<bool>()) {
+          continue;
+        }
+      }
+      *rid = next_rid;
+      num_produced_++;
+      return true;
+    }
+  } while (Refill());
+  return false;
+}
 
-auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto IndexScanExecutor::NextEntry(Tuple *tuple, RID *rid) -> bool {
+  const auto &output_schema = GetOutputSchema();
+  auto *entry_schema = index_info_->index_->GetEntrySchema();
+  std::vector<Value> values;
+  values.reserve(entry_positions_.size());
+  do {
+    while (cursor_ < entries_.size()) {
+      const auto &[entry, entry_rid] = entries_[cursor_++];
+      values.clear();
+      for (size_t i = 0; i < entry_positions_.size(); i++) {
+        values.push_back(entry_positions_[i] < 0
+                             ? ValueFactory::GetNullValueByType(output_schema.GetColumn(i).GetType())
+                             : entry.GetValue(entry_schema, entry_positions_[i]));
+      }
+      *tuple = Tuple(values, &output_schema);
+      if (plan_->filter_predicate_ != nullptr) {
+        Value value = plan_->filter_predicate_->Evaluate(tuple, output_schema);
+        if (value.IsNull() || !value.GetAs<bool>()) {
+          continue;
+        }
+      }
+      *rid = entry_rid;
+      num_produced_++;
+      return true;
+    }
+  } while (Refill());
+  return false;
+}
 
 }  // namespace bustub
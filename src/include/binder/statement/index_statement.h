@@ -21,7 +21,8 @@ namespace bustub {
 class IndexStatement : public BoundStatement {
  public:
   explicit IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                          std::vector<std::unique_ptr<BoundColumnRef>> cols);
+                          std::vector<std::unique_ptr<BoundColumnRef>> cols, std::string index_type,
+                          std::vector<std::unique_ptr<BoundColumnRef>> include_cols = {});
 
   /** Name of the index */
   std::string index_name_;
@@ -32,6 +33,12 @@ class IndexStatement : public BoundStatement {
   /** Name of the columns */
   std::vector<std::unique_ptr<BoundColumnRef>> cols_;
 
+  /** Access method from `USING <method>`, lower case */
+  std::string index_type_;
+
+  /** Columns stored along with the keys, from `WITH (include = ...)` */
+  std::vector<std::unique_ptr<BoundColumnRef>> include_cols_;
+
   auto ToString() const -> std::string override;
 };
 
@@ -13,16 +13,30 @@
 #pragma once
 
 #include <list>
+#include <map>
 #include <mutex>  // NOLINT
+#include <string>
 #include <unordered_map>
+#include <utility>
 
+#include "buffer/buffer_pool_metrics.h"
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
+/**
+ * How a page is going to be used, passed along with FetchPage() as a hint to the buffer pool.
+ *
+ * Normal pages compete for the whole pool. Pages fetched for a sequential scan or a bulk load are read once and then
+ * left behind, so a buffer pool may keep them in a small ring of frames instead, where they do not push out the
+ * working set of everybody else.
+ */
+enum class AccessType { Normal = 0, Scan, BulkLoad };
+
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  */
@@ -40,7 +54,15 @@ class BufferPoolManager {
   /** Grading function. Do not modify! */
   auto FetchPage(page_id_t page_id, bufferpool_callback_fn callback = nullptr) -> Page * {
     GradingCallback(callback, CallbackType::BEFORE, page_id);
-    auto *result = FetchPgImp(page_id);
+    auto *result = FetchPgImp(page_id, AccessType::Normal);
+    GradingCallback(callback, CallbackType::AFTER, page_id);
+    return result;
+  }
+
+  /** FetchPage() with a hint on how the page is going to be used. */
+  auto FetchPage(page_id_t page_id, AccessType access_type, bufferpool_callback_fn callback = nullptr) -> Page * {
+    GradingCallback(callback, CallbackType::BEFORE, page_id);
+    auto *result = FetchPgImp(page_id, access_type);
     GradingCallback(callback, CallbackType::AFTER, page_id);
     return result;
   }
@@ -84,10 +106,67 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Start loading pages [first_page_id, first_page_id + count) into the buffer pool in the background. The pages are
+   * not pinned for the caller, who still has to FetchPage() them; a FetchPage() that arrives while the read is in
+   * flight waits for it instead of issuing its own. Pages that are already resident or not allocated are skipped.
+   * @param first_page_id id of the first page to load
+   * @param count number of consecutive page ids to load
+   * @param access_type how the pages are going to be used once they are fetched
+   */
+  void PrefetchPages(page_id_t first_page_id, size_t count, AccessType access_type = AccessType::Normal) {
+    PrefetchPgsImp(first_page_id, count, access_type);
+  }
+
+  /**
+   * Fetch a page wrapped in a guard that unpins it when the guard goes out of scope.
+   * @param page_id id of page to be fetched
+   * @param access_type how the page is going to be used
+   * @return the guard, empty (IsValid() is false) if the page could not be fetched
+   */
+  auto FetchPageBasic(page_id_t page_id, AccessType access_type = AccessType::Normal,
+                      const char *file = __builtin_FILE(), int line = __builtin_LINE()) -> BasicPageGuard;
+
+  /** FetchPageBasic(), then take the page's read latch. The guard releases both. */
+  auto FetchPageRead(page_id_t page_id, AccessType access_type = AccessType::Normal,
+                     const char *file = __builtin_FILE(), int line = __builtin_LINE()) -> ReadPageGuard;
+
+  /** FetchPageBasic(), then take the page's write latch. The guard releases both. */
+  auto FetchPageWrite(page_id_t page_id, AccessType access_type = AccessType::Normal,
+                      const char *file = __builtin_FILE(), int line = __builtin_LINE()) -> WritePageGuard;
+
+  /**
+   * Create a new page wrapped in a guard that unpins it (dirty) when the guard goes out of scope.
+   * @param[out] page_id id of created page
+   * @return the guard, empty (IsValid() is false) if no new page could be created
+   */
+  auto NewPageGuarded(page_id_t *page_id, const char *file = __builtin_FILE(), int line = __builtin_LINE())
+      -> BasicPageGuard;
+
+  /**
+   * Pins held by page guards that have not been dropped yet, by the call site that created the guard. Only debug
+   * builds keep track of call sites; in release builds the map is always empty.
+   * @return "file:line" -> number of outstanding pins
+   */
+  auto GetGuardPinSites() -> std::map<std::string, size_t>;
+
   /** @return size of the buffer pool */
   virtual auto GetPoolSize() -> size_t = 0;
 
+  /** @return a snapshot of the buffer pool metrics; empty for buffer pools that do not keep any */
+  virtual auto GetStats() -> BufferPoolStats { return {}; }
+
+  /**
+   * Make NewPage() hand out only page ids from end_page_id on, e.g. past the pages of a database file that is opened
+   * again. Page ids below it can still be fetched.
+   * @param end_page_id the page id past the last page in use
+   */
+  virtual void ReservePageIds(page_id_t end_page_id) {}
+
  protected:
+  /** Log the pins that page guards still hold, by call site. Buffer pool managers call this when they shut down. */
+  void ReportLeakedGuardPins();
+
   /**
    * Grading function. Do not modify!
    * Invokes the callback function if it is not null.
@@ -104,9 +183,10 @@ class BufferPoolManager {
   /**
    * Fetch the requested page from the buffer pool.
    * @param page_id id of page to be fetched
+   * @param access_type how the page is going to be used
    * @return the requested page
    */
-  virtual auto FetchPgImp(page_id_t page_id) -> Page * = 0;
+  virtual auto FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * = 0;
 
   /**
    * Unpin the target page from the buffer pool.
@@ -141,5 +221,29 @@ class BufferPoolManager {
    * Flushes all the pages in the buffer pool to disk.
    */
   virtual void FlushAllPgsImp() = 0;
+
+  /**
+   * Starts loading a range of pages into the buffer pool. Buffer pools that cannot read ahead ignore the hint.
+   * @param first_page_id id of the first page to load
+   * @param count number of consecutive page ids to load
+   * @param access_type how the pages are going to be used
+   */
+  virtual void PrefetchPgsImp(page_id_t first_page_id, size_t count, AccessType access_type) {}
+
+ private:
+  friend class BasicPageGuard;
+
+  /** Attach a call site to a fresh guard and count its pin there. */
+  void TrackGuardPin(BasicPageGuard *guard, const char *file, int line);
+
+  /** Forget a pin counted by TrackGuardPin(). */
+  void UntrackGuardPin(const char *file, int line);
+
+#ifndef NDEBUG
+  /** Protects guard_pins_. */
+  std::mutex guard_pin_latch_;
+  /** (file, line) -> number of pins held by guards created there */
+  std::map<std::pair<const char *, int>, size_t> guard_pins_;
+#endif
 };
 }  // namespace bustub
@@ -12,11 +12,16 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <list>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/clock_replacer.h"
 #include "buffer/lru_k_replacer.h"
 #include "common/config.h"
 #include "container/hash/extendible_hash_table.h"
@@ -37,9 +42,28 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_type the replacement policy, LRU-K or a latch-free clock
    */
   BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRUK);
+
+  /**
+   * @brief Creates a new BufferPoolManagerInstance that is one shard of a ParallelBufferPoolManager.
+   *
+   * The instance only allocates page ids that are congruent to instance_index modulo num_instances, so that the
+   * page ids handed out by different shards never collide and a page id alone identifies its owning shard.
+   *
+   * @param pool_size the size of the buffer pool
+   * @param num_instances total number of BPIs in the parallel BPM
+   * @param instance_index index of this BPI in the parallel BPM
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_type the replacement policy, LRU-K or a latch-free clock
+   */
+  BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                            DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRUK);
 
   /**
    * @brief Destroy an existing BufferPoolManagerInstance.
@@ -52,6 +76,37 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
+  /**
+   * @brief Start the background writer thread.
+   *
+   * Every background_writer_interval, the writer looks at the next `target_clean_ratio * pool_size` victims of the
+   * replacer and writes the dirty ones back to disk, so that NewPgImp()/FetchPgImp() rarely have to write a dirty
+   * victim on the caller's thread. The writer never touches pinned frames. While it writes a frame, it holds a pin and
+   * the page read latch, so the frame cannot be evicted and writers (who take the write latch) wait for it.
+   *
+   * @param target_clean_ratio fraction of the pool, counted from the next victim, that the writer keeps clean
+   * @param max_writes_per_second upper bound on the number of pages the writer writes per second
+   */
+  void StartBackgroundWriter(double target_clean_ratio = BG_WRITER_CLEAN_RATIO,
+                             size_t max_writes_per_second = BG_WRITER_MAX_WRITES_PER_SEC);
+
+  /** @brief Stop and join the background writer thread, if it is running. */
+  void StopBackgroundWriter();
+
+  /** @return the number of dirty victims written back on the caller's thread by NewPgImp()/FetchPgImp() */
+  auto GetNumSyncWritebacks() const -> size_t { return metrics_.Get(BufferPoolCounter::SYNC_WRITEBACK); }
+
+  /** @return the number of dirty frames cleaned by the background writer */
+  auto GetNumBackgroundWritebacks() const -> size_t { return metrics_.Get(BufferPoolCounter::BACKGROUND_WRITEBACK); }
+
+  /** @return the number of pages loaded by read-ahead */
+  auto GetNumPrefetchedPages() const -> size_t { return metrics_.Get(BufferPoolCounter::PREFETCHED_PAGE); }
+
+  /** @return a snapshot of the metrics of this instance */
+  auto GetStats() -> BufferPoolStats override { return metrics_.Snapshot(); }
+
+  void ReservePageIds(page_id_t end_page_id) override;
+
  protected:
   /**
    * TODO(P1): Add implementation
@@ -85,10 +140,15 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    *
    * In addition, remember to disable eviction and record the access history of the frame like you did for NewPgImp().
    *
+   * A page that is read in for AccessType::Scan or AccessType::BulkLoad goes to the scan ring: once the ring holds
+   * SCAN_RING_SIZE frames, such a miss recycles the oldest unpinned frame of the ring instead of evicting from the rest
+   * of the pool. A Normal fetch of a page in the ring takes it out of the ring for good.
+   *
    * @param page_id id of page to be fetched
+   * @param access_type how the page is going to be used
    * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
    */
-  auto FetchPgImp(page_id_t page_id) -> Page * override;
+  auto FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * override;
 
   /**
    * TODO(P1): Add implementation
@@ -140,8 +200,26 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   auto DeletePgImp(page_id_t page_id) -> bool override;
 
+  /**
+   * @brief Start loading the pages of [first_page_id, first_page_id + count) owned by this instance.
+   *
+   * Each page that is allocated but not resident gets a frame, just like FetchPgImp() would give it, and is entered in
+   * the page table right away. The frame stays pinned and marked as in flight until the prefetch thread has read it,
+   * so it cannot be evicted, and FetchPgImp()/FlushPgImp() on it wait for the read to land. At most a quarter of the
+   * pool is in flight at any time; the rest of the range is dropped.
+   *
+   * @param first_page_id id of the first page to load
+   * @param count number of consecutive page ids to load
+   * @param access_type how the pages are going to be used
+   */
+  void PrefetchPgsImp(page_id_t first_page_id, size_t count, AccessType access_type) override;
+
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
+  /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
+  const uint32_t num_instances_ = 1;
+  /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
+  const uint32_t instance_index_ = 0;
   /** The next page id to be allocated  */
   std::atomic<page_id_t> next_page_id_ = 0;
   /** Bucket size for the extendible hash table */
@@ -156,11 +234,13 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** Page table for keeping track of buffer pool pages. */
   ExtendibleHashTable<page_id_t, frame_id_t> *page_table_;
   /** Replacer to find unpinned pages for replacement. */
-  LRUKReplacer *replacer_;
+  Replacer *replacer_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** This latch protects the page table, the replacer, the free list and the frame metadata of pages_. */
   std::mutex latch_;
+  /** Counters and I/O latencies of this instance. */
+  BufferPoolMetrics metrics_;
 
   /**
    * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
@@ -176,6 +256,88 @@ class BufferPoolManagerInstance : public BufferPoolManager {
     // This is a no-nop right now without a more complex data structure to track deallocated pages
   }
 
-  // TODO(student): You may add additional private members and helper functions
+  /**
+   * @brief Validate that the page_id being used is accessible to this BPI. This can be used in all of the functions
+   * to validate input data and ensure that a parallel BPM is routing requests to the correct BPI.
+   * @param page_id the page id to validate
+   */
+  void ValidatePageId(page_id_t page_id) const;
+
+  /**
+   * @brief Pick a frame for a new resident page, from the free list first and then from the replacer. Scans and bulk
+   * loads recycle a frame of the full scan ring before either. A dirty victim is written back and its page table entry
+   * is dropped. Caller should acquire the latch before calling this function.
+   * @param[out] frame_id the frame that is now free to be reused
+   * @param access_type how the page that moves into the frame is going to be used
+   * @return false if every frame is pinned, true otherwise
+   */
+  auto AcquireFrame(frame_id_t *frame_id, AccessType access_type) -> bool;
+
+  /**
+   * @brief Take the oldest unpinned frame of the scan ring out of the replacer. Caller should acquire the latch.
+   * @param[out] frame_id the recycled frame, still holding its old page
+   * @return false if every frame of the ring is pinned
+   */
+  auto RecycleRingFrame(frame_id_t *frame_id) -> bool;
+
+  /** @brief Drop a frame from the scan ring, if it is in there. Caller should acquire the latch. */
+  void LeaveScanRing(frame_id_t frame_id);
+
+  /**
+   * @brief Look up a page in the page table, counting the lookup and its probes. Caller should acquire the latch.
+   * @param page_id the page to look up
+   * @param[out] frame_id the frame holding the page, if it is resident
+   * @return true if the page is resident
+   */
+  auto FindFrame(page_id_t page_id, frame_id_t *frame_id) -> bool;
+
+  /** @brief Write a page to disk, recording the latency. */
+  void WritePageToDisk(page_id_t page_id, const char *page_data);
+
+  /** @brief Read a page from disk, recording the latency. */
+  void ReadPageFromDisk(page_id_t page_id, char *page_data);
+
+  /** @brief Main loop of the background writer thread. */
+  void RunBackgroundWriter();
+
+  /**
+   * @brief Write back a dirty, unpinned frame from the background writer. Does nothing if the frame got pinned or
+   * cleaned in the meantime. Caller must NOT hold the latch.
+   * @param frame_id the frame to clean
+   * @return true if the frame was written
+   */
+  auto CleanFrame(frame_id_t frame_id) -> bool;
+
+  /** @brief Main loop of the prefetch thread, which reads the batches queued by PrefetchPgsImp(). */
+  void RunPrefetcher();
+
+  /** Frames holding pages that were only ever fetched for scans and bulk loads, oldest first. */
+  std::list<frame_id_t> scan_ring_;
+  /** Position of each frame in scan_ring_, valid if in_scan_ring_ is set. */
+  std::vector<std::list<frame_id_t>::iterator> scan_ring_pos_;
+  std::vector<bool> in_scan_ring_;
+  /** Number of frames the scan ring may hold before it recycles its own frames. */
+  const size_t scan_ring_size_;
+
+  /** Fraction of the pool, next victims first, the background writer keeps clean. */
+  double target_clean_ratio_{BG_WRITER_CLEAN_RATIO};
+  /** Write budget of the background writer. */
+  size_t max_writes_per_second_{BG_WRITER_MAX_WRITES_PER_SEC};
+  std::atomic<bool> enable_background_writer_{false};
+  std::thread *background_writer_thread_{nullptr};
+
+  /** Frames whose page is still being read by the prefetch thread. Protected by latch_. */
+  std::vector<bool> prefetching_;
+  /** Number of frames set in prefetching_. */
+  size_t num_prefetching_{0};
+  /** Batches of frames waiting for the prefetch thread. Protected by latch_. */
+  std::deque<std::vector<frame_id_t>> prefetch_queue_;
+  /** Wakes up the prefetch thread. */
+  std::condition_variable prefetch_cv_;
+  /** Wakes up the callers waiting for a prefetched page to land. */
+  std::condition_variable prefetch_done_cv_;
+  bool enable_prefetcher_{true};
+  /** Started by the first PrefetchPgsImp() that queues any work. */
+  std::thread *prefetch_thread_{nullptr};
 };
 }  // namespace bustub
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_metrics.h
+//
+// Identification: src/include/buffer/buffer_pool_metrics.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstddef>
+#include <cstdint>
+
+namespace bustub {
+
+/** Events a buffer pool counts. */
+enum class BufferPoolCounter {
+  HIT = 0,               // FetchPage() found the page resident
+  MISS,                  // FetchPage() had to read the page from disk
+  EVICTION,              // a resident page was pushed out to make room for another one
+  SYNC_WRITEBACK,        // a dirty victim was written back on the caller's thread
+  BACKGROUND_WRITEBACK,  // a dirty frame was cleaned by the background writer
+  PREFETCHED_PAGE,       // a page was loaded by read-ahead
+  PIN_WAIT,              // a caller had to wait for the pool latch or an in-flight read before getting its pin
+  PAGE_TABLE_LOOKUP,     // a page table lookup
+  PAGE_TABLE_PROBE,      // an entry looked at by a page table lookup
+  NUM_COUNTERS
+};
+
+/**
+ * Latency histograms have one bucket per power of two of microseconds: bucket 0 counts latencies below 1us, bucket i
+ * counts [2^(i-1), 2^i) us, and the last bucket everything above.
+ */
+static constexpr size_t LATENCY_HISTOGRAM_BUCKETS = 24;
+
+using LatencyHistogram = std::array<uint64_t, LATENCY_HISTOGRAM_BUCKETS>;
+
+/** A point-in-time copy of the metrics of one buffer pool, or the sum of several. */
+struct BufferPoolStats {
+  std::array<uint64_t, static_cast<size_t>(BufferPoolCounter::NUM_COUNTERS)> counters_{};
+  /** Latency of disk reads issued by the buffer pool. A batched read counts once. */
+  LatencyHistogram read_latency_{};
+  /** Latency of disk writes issued by the buffer pool. A batched write counts once. */
+  LatencyHistogram write_latency_{};
+
+  auto Get(BufferPoolCounter counter) const -> uint64_t { return counters_[static_cast<size_t>(counter)]; }
+
+  /** @return hits / (hits + misses), 0 if nothing was fetched */
+  auto HitRatio() const -> double;
+
+  /** @return the average number of entries a page table lookup looked at */
+  auto AvgProbeLength() const -> double;
+
+  /**
+   * @param histogram a latency histogram
+   * @param quantile the quantile to look up, in [0, 1]
+   * @return the upper bound, in microseconds, of the bucket holding the quantile; 0 for an empty histogram
+   */
+  static auto LatencyQuantile(const LatencyHistogram &histogram, double quantile) -> uint64_t;
+
+  auto operator+=(const BufferPoolStats &that) -> BufferPoolStats &;
+};
+
+/**
+ * BufferPoolMetrics keeps the counters and latency histograms of one buffer pool.
+ *
+ * The counters are striped over METRICS_SLOTS cache-line aligned slots, and each thread updates the slot it was
+ * assigned the first time it counted anything. As long as there are no more threads than slots, every slot has a
+ * single writer and an update is an uncontended relaxed add on a line the thread already owns, so the metrics can stay
+ * on in production. Snapshot() sums the slots; it may miss updates that are in progress, but never tears a counter.
+ */
+class BufferPoolMetrics {
+ public:
+  /** Number of slots the counters are striped over. */
+  static constexpr size_t METRICS_SLOTS = 64;
+
+  BufferPoolMetrics() = default;
+
+  BufferPoolMetrics(const BufferPoolMetrics &) = delete;
+  auto operator=(const BufferPoolMetrics &) -> BufferPoolMetrics & = delete;
+
+  /** Count n events. */
+  void Add(BufferPoolCounter counter, uint64_t n = 1) {
+    LocalSlot().counters_[static_cast<size_t>(counter)].fetch_add(n, std::memory_order_relaxed);
+  }
+
+  /** Record the latency of a disk read. */
+  void RecordReadLatency(std::chrono::nanoseconds latency) { Record(&LocalSlot().read_latency_, latency); }
+
+  /** Record the latency of a disk write. */
+  void RecordWriteLatency(std::chrono::nanoseconds latency) { Record(&LocalSlot().write_latency_, latency); }
+
+  /** @return the number of events counted so far */
+  auto Get(BufferPoolCounter counter) const -> uint64_t;
+
+  /** @return a copy of all the counters and histograms */
+  auto Snapshot() const -> BufferPoolStats;
+
+ private:
+  using AtomicHistogram = std::array<std::atomic<uint64_t>, LATENCY_HISTOGRAM_BUCKETS>;
+
+  struct alignas(64) Slot {
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(BufferPoolCounter::NUM_COUNTERS)> counters_{};
+    AtomicHistogram read_latency_{};
+    AtomicHistogram write_latency_{};
+  };
+
+  /** @return the slot of the calling thread */
+  auto LocalSlot() -> Slot & { return slots_[ThreadSlotIndex()]; }
+
+  /** @return the slot index of the calling thread, the same for every BufferPoolMetrics */
+  static auto ThreadSlotIndex() -> size_t;
+
+  /** @return the histogram bucket of a latency */
+  static auto BucketOf(std::chrono::nanoseconds latency) -> size_t;
+
+  static void Record(AtomicHistogram *histogram, std::chrono::nanoseconds latency) {
+    (*histogram)[BucketOf(latency)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  std::array<Slot, METRICS_SLOTS> slots_;
+};
+
+}  // namespace bustub
@@ -12,8 +12,8 @@
 
 #pragma once
 
-#include <list>
-#include <mutex>  // NOLINT
+#include <atomic>
+#include <cstdint>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -23,6 +23,12 @@ namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * The replacer takes no latch. Every frame has one atomic byte holding its 'evictable' and reference bits, so
+ * Pin/Unpin/RecordAccess/SetEvictable are a single atomic read-modify-write on that frame only, and threads working on
+ * different frames never touch a shared cache line apart from the frame bytes themselves. Victim advances a shared
+ * atomic clock hand and claims a frame with a compare-and-swap; it gives up after two full sweeps, which can only
+ * happen when there is nothing to evict or concurrent accesses keep setting reference bits in front of the hand.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -39,14 +45,39 @@ class ClockReplacer : public Replacer {
 
   auto Victim(frame_id_t *frame_id) -> bool override;
 
+  /** Take the frame out of the replacer. */
   void Pin(frame_id_t frame_id) override;
 
+  /** Put the frame into the replacer with its reference bit set. */
   void Unpin(frame_id_t frame_id) override;
 
+  /** @return the number of evictable frames, counted by a sweep over all frames */
   auto Size() -> size_t override;
 
+  /** Set the reference bit of the frame. */
+  void RecordAccess(frame_id_t frame_id) override;
+
+  /** Toggle the 'evictable' bit of the frame, leaving its reference bit alone. */
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  /** Clear both bits of an evictable frame. */
+  void Remove(frame_id_t frame_id) override;
+
+  /**
+   * The frames the hand would take without concurrent accesses: first the evictable frames without reference bit in
+   * front of the hand, then the ones the hand only takes on its second lap.
+   */
+  auto GetEvictionOrder(size_t limit) -> std::vector<frame_id_t> override;
+
  private:
-  // TODO(student): implement me!
+  static constexpr uint8_t EVICTABLE = 1;
+  static constexpr uint8_t REFERENCED = 2;
+
+  const size_t num_pages_;
+  /** 'evictable' and reference bits of every frame. */
+  std::vector<std::atomic<uint8_t>> frames_;
+  /** The clock hand; taken modulo num_pages_. */
+  std::atomic<size_t> hand_{0};
 };
 
 }  // namespace bustub
@@ -13,11 +13,11 @@
 #pragma once
 
 #include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
 
@@ -33,8 +33,13 @@ namespace bustub {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multiple frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * All state is allocated up front, one node per frame, so nothing allocates on the hot path. The evictable frames sit
+ * in an indexed binary min-heap keyed by (has k accesses, earliest remembered timestamp): frames with +inf k-distance
+ * sort first by their first access, the others by their k-th most recent access. Evict, RecordAccess, SetEvictable and
+ * Remove are O(log n) in the number of evictable frames.
  */
-class LRUKReplacer {
+class LRUKReplacer : public Replacer {
  public:
   /**
    *
@@ -52,7 +57,7 @@ class LRUKReplacer {
    *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
 
   /**
    * TODO(P1): Add implementation
@@ -70,7 +75,7 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
    * TODO(P1): Add implementation
@@ -83,7 +88,7 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame that received a new access.
    */
-  void RecordAccess(frame_id_t frame_id);
+  void RecordAccess(frame_id_t frame_id) override;
 
   /**
    * TODO(P1): Add implementation
@@ -102,7 +107,7 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
   /**
    * TODO(P1): Add implementation
@@ -121,7 +126,16 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
+
+  /**
+   * @brief Return up to `limit` evictable frames in the order Evict() would pick them, without evicting anything.
+   * The buffer pool's background writer uses this to find the frames that are about to become victims.
+   *
+   * @param limit the maximum number of frames to return
+   * @return the next victims, first victim first
+   */
+  auto GetEvictionOrder(size_t limit) -> std::vector<frame_id_t> override;
 
   /**
    * TODO(P1): Add implementation
@@ -130,15 +144,51 @@ class LRUKReplacer {
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
+
+  /** Replacer interface: same as Evict(). */
+  auto Victim(frame_id_t *frame_id) -> bool override { return Evict(frame_id); }
+
+  /** Replacer interface: same as SetEvictable(frame_id, false). */
+  void Pin(frame_id_t frame_id) override { SetEvictable(frame_id, false); }
+
+  /** Replacer interface: same as SetEvictable(frame_id, true); frames without any recorded access stay untracked. */
+  void Unpin(frame_id_t frame_id) override { SetEvictable(frame_id, true); }
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  [[maybe_unused]] size_t current_timestamp_{0};
-  [[maybe_unused]] size_t curr_size_{0};
-  [[maybe_unused]] size_t replacer_size_;
-  [[maybe_unused]] size_t k_;
+  static constexpr size_t NOT_IN_HEAP = std::numeric_limits<size_t>::max();
+
+  /**
+   * Per-frame state. The most recent k timestamps live in history_[frame_id * k, (frame_id + 1) * k) as a ring buffer
+   * whose oldest entry is at head_. A frame with count_ == 0 is not tracked by the replacer.
+   */
+  struct FrameNode {
+    size_t head_{0};
+    size_t count_{0};
+    bool evictable_{false};
+    size_t heap_pos_{NOT_IN_HEAP};
+  };
+
+  /** @return the heap key of a tracked frame, smaller keys are evicted first */
+  auto Key(frame_id_t frame_id) const -> std::pair<bool, size_t> {
+    const auto &node = nodes_[frame_id];
+    return {node.count_ >= k_, history_[frame_id * k_ + node.head_]};
+  }
+
+  void HeapPush(frame_id_t frame_id);
+  void HeapErase(size_t pos);
+  void SiftUp(size_t pos);
+  void SiftDown(size_t pos);
+  void HeapSwap(size_t a, size_t b);
+
+  size_t current_timestamp_{0};
+  size_t curr_size_{0};
+  size_t replacer_size_;
+  size_t k_;
+  std::vector<FrameNode> nodes_;
+  std::vector<size_t> history_;
+  /** Indexed min-heap of the evictable frames. */
+  std::vector<frame_id_t> heap_;
   std::mutex latch_;
 };
 
@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards pages across several independent BufferPoolManagerInstances. Each shard has its own
+ * latch, page table, replacer and free list, so requests for pages living on different shards never contend.
+ *
+ * A page id is owned by the shard `page_id % num_instances`. NewPage hands out pages from the shards in a round-robin
+ * fashion, and every shard only allocates page ids that map back to itself.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * @brief Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer of each instance
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of each instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRUK);
+
+  /**
+   * @brief Destroy an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @brief Return the total size (number of frames) of all the buffer pool instances. */
+  auto GetPoolSize() -> size_t override;
+
+  /** @brief Return the number of BufferPoolManagerInstances in this pool. */
+  auto GetNumInstances() const -> size_t { return instances_.size(); }
+
+  /**
+   * @brief Start a background writer on every instance. See BufferPoolManagerInstance::StartBackgroundWriter().
+   * @param target_clean_ratio fraction of each instance, next victims first, that its writer keeps clean
+   * @param max_writes_per_second write budget of each instance's writer
+   */
+  void StartBackgroundWriter(double target_clean_ratio = BG_WRITER_CLEAN_RATIO,
+                             size_t max_writes_per_second = BG_WRITER_MAX_WRITES_PER_SEC);
+
+  /** @brief Stop the background writer of every instance. */
+  void StopBackgroundWriter();
+
+  /** @return the number of dirty victims written back on callers' threads, summed over all instances */
+  auto GetNumSyncWritebacks() const -> size_t;
+
+  /** @return the number of dirty frames cleaned by the background writers, summed over all instances */
+  auto GetNumBackgroundWritebacks() const -> size_t;
+
+  /** @return the number of pages loaded by read-ahead, summed over all instances */
+  auto GetNumPrefetchedPages() const -> size_t;
+
+  /** @return a snapshot of the metrics of every instance, summed up */
+  auto GetStats() -> BufferPoolStats override;
+
+  /** @brief Reserve the page ids below end_page_id in every instance. */
+  void ReservePageIds(page_id_t end_page_id) override;
+
+ protected:
+  /**
+   * @param page_id id of page
+   * @return pointer to the BufferPoolManagerInstance responsible for handling given page id
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance *;
+
+  /**
+   * @brief Fetch the requested page from the instance that owns it.
+   * @param page_id id of page to be fetched
+   * @param access_type how the page is going to be used
+   * @return the requested page
+   */
+  auto FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * override;
+
+  /**
+   * @brief Unpin the target page on the instance that owns it.
+   * @param page_id id of page to be unpinned
+   * @param is_dirty true if the page should be marked as dirty, false otherwise
+   * @return false if the page pin count is <= 0 before this call, true otherwise
+   */
+  auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
+
+  /**
+   * @brief Flush the target page to disk through the instance that owns it.
+   * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
+   * @return false if the page could not be found in the page table, true otherwise
+   */
+  auto FlushPgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Create a new page. Instances are asked in round-robin order, starting from a rotating index, until one of
+   * them has a frame to spare.
+   * @param[out] page_id id of created page
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgImp(page_id_t *page_id) -> Page * override;
+
+  /**
+   * @brief Delete a page through the instance that owns it.
+   * @param page_id id of page to be deleted
+   * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+   */
+  auto DeletePgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Flush all the pages of every instance to disk.
+   */
+  void FlushAllPgsImp() override;
+
+  /**
+   * @brief Hand the range to every instance; each one loads the pages it owns.
+   * @param first_page_id id of the first page to load
+   * @param count number of consecutive page ids to load
+   * @param access_type how the pages are going to be used
+   */
+  void PrefetchPgsImp(page_id_t first_page_id, size_t count, AccessType access_type) override;
+
+ private:
+  /** The shards of this buffer pool, indexed by `page_id % num_instances`. */
+  std::vector<std::unique_ptr<BufferPoolManagerInstance>> instances_;
+  /** Size of each individual shard. */
+  const size_t pool_size_;
+  /** The instance NewPgImp starts probing from; advanced on every call. */
+  std::atomic<size_t> next_instance_{0};
+};
+
+}  // namespace bustub
@@ -12,10 +12,15 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** The replacement policies a BufferPoolManagerInstance can run with. */
+enum class ReplacerType { LRUK, CLOCK };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -45,6 +50,51 @@ class Replacer {
 
   /** @return the number of elements in the replacer that can be victimized */
   virtual auto Size() -> size_t = 0;
+
+  /*
+   * The buffer pool drives a replacer through the calls below. Their defaults map them onto Victim/Pin/Unpin for
+   * policies that keep no access history.
+   */
+
+  /**
+   * Record the event that the given frame is accessed, creating an entry for it if there is none.
+   * @param frame_id id of frame that received a new access
+   */
+  virtual void RecordAccess(frame_id_t frame_id) {}
+
+  /**
+   * Toggle whether a frame may be evicted.
+   * @param frame_id id of frame whose 'evictable' status will be modified
+   * @param set_evictable whether the given frame is evictable or not
+   */
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) {
+    if (set_evictable) {
+      Unpin(frame_id);
+    } else {
+      Pin(frame_id);
+    }
+  }
+
+  /**
+   * Evict the frame chosen by the replacement policy and forget about it.
+   * @param[out] frame_id id of frame that is evicted
+   * @return true if a frame is evicted successfully, false if no frames can be evicted
+   */
+  virtual auto Evict(frame_id_t *frame_id) -> bool { return Victim(frame_id); }
+
+  /**
+   * Forget about an evictable frame, no matter where it stands in the eviction order.
+   * @param frame_id id of frame to be removed
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+  /**
+   * Return up to `limit` evictable frames in the order Evict() would pick them, without evicting anything. The order
+   * may be approximate for policies that cannot tell it without changing their state.
+   * @param limit the maximum number of frames to return
+   * @return the next victims, first victim first
+   */
+  virtual auto GetEvictionOrder(size_t limit) -> std::vector<frame_id_t> { return {}; }
 };
 
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -24,6 +25,7 @@
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
+#include "storage/page/header_page.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -35,6 +37,14 @@ using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
 using index_oid_t = uint32_t;
 
+/** The kinds of index the catalog can build. */
+enum class IndexType {
+  /** A B+ tree; supports point lookups and ordered scans */
+  BPlusTreeIndex,
+  /** A disk extendible hash table; supports point lookups only */
+  HashTableIndex,
+};
+
 /**
  * The TableInfo class maintains metadata about a table.
  */
@@ -70,15 +80,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The kind of index
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPlusTreeIndex)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -91,12 +103,42 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The kind of index */
+  const IndexType index_type_;
+};
+
+/**
+ * What a persistent catalog keeps of an index in the database file: enough to open the index again, without reading
+ * any of its entries, once the caller has picked the key type the index was created with.
+ */
+struct PersistedIndex {
+  /** The unique OID for the index */
+  index_oid_t index_oid_;
+  /** The name of the index */
+  std::string name_;
+  /** The name of the table on which the index is created */
+  std::string table_name_;
+  /** The table columns of the key */
+  std::vector<uint32_t> key_attrs_;
+  /** The table columns stored along with the keys */
+  std::vector<uint32_t> include_attrs_;
+  /** The size of the index key, in bytes */
+  size_t key_size_;
+  /** The kind of index */
+  IndexType index_type_;
+  /** The page to open the index from, see Index::GetFirstPageId() */
+  page_id_t first_page_id_;
 };
 
 /**
- * The Catalog is a non-persistent catalog that is designed for
+ * The Catalog is a catalog that is designed for
  * use by executors within the DBMS execution engine. It handles
  * table creation, table lookup, index creation, and index lookup.
+ *
+ * The catalog lives in memory only, unless it is made persistent with
+ * EnablePersistence() or Open(). A persistent catalog writes its tables
+ * and indexes into a chain of CatalogPages whenever one is created, so that
+ * a database file can be opened again without rebuilding anything.
  */
 class Catalog {
  public:
@@ -151,6 +193,7 @@ class Catalog {
     table_names_.emplace(table_name, table_oid);
     index_names_.emplace(table_name, std::unordered_map<std::string, index_oid_t>{});
 
+    Persist();
     return tmp;
   }
 
@@ -196,58 +239,83 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
+   * @param index_type The kind of index to build
+   * @param include_attrs The columns a covering index stores along with the keys; only variable length B+ tree keys
+   * can hold them
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
-                   HashFunction<KeyType> hash_function) -> IndexInfo * {
+                   HashFunction<KeyType> hash_function, IndexType index_type = IndexType::BPlusTreeIndex,
+                   const std::vector<uint32_t> &include_attrs = {}) -> IndexInfo * {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
     }
 
-    // If the table exists, an entry for the table should already be present in index_names_
-    BUSTUB_ASSERT((index_names_.find(table_name) != index_names_.end()), "Broken Invariant");
+    // Reject hash indexes on variable length keys, which only use a prefix of the key type
+    if constexpr (IsVarlenKey<KeyType>::value) {
+      if (index_type == IndexType::HashTableIndex) {
+        return NULL_INDEX_INFO;
+      }
+    } else if (!include_attrs.empty()) {
+      // Reject included columns in fixed length keys, which compare equal keys bitwise in places
+      return NULL_INDEX_INFO;
+    }
 
-    // Determine if the requested index already exists for this table
-    auto &table_indexes = index_names_.find(table_name)->second;
-    if (table_indexes.find(index_name) != table_indexes.end()) {
-      // The requested index already exists for this table
+    // Index names are unique in the database, as they are in PostgreSQL: a B+ tree records its root in the header page
+    // under the name of its index, which has to fit into a record
+    auto same_name = [&index_name](const auto &index) { return index.second->name_ == index_name; };
+    if (std::any_of(indexes_.begin(), indexes_.end(), same_name) ||
+        (index_type == IndexType::BPlusTreeIndex && index_name.length() >= HeaderPage::NAME_SIZE)) {
       return NULL_INDEX_INFO;
     }
 
     // Construct index metdata
-    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
-
-    // Construct the index, take ownership of metadata
-    // TODO(Kyle): We should update the API for CreateIndex
-    // to allow specification of the index type itself, not
-    // just the key, value, and comparator types
+    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs, include_attrs);
 
-    // TODO(chi): support both hash index and btree index
-    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
-
-    // Populate the index with all tuples in table heap
+    // Construct the index, take ownership of metadata, and populate it with all tuples in table heap
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+    auto index = MakeIndex<KeyType, ValueType, KeyComparator>(
+        std::move(meta), index_type, hash_function, INVALID_PAGE_ID,
+        [&](auto *tree_index) { BulkLoadTreeIndex(tree_index, heap, schema, txn); });
+    if (index_type == IndexType::HashTableIndex) {
+      for (auto tuple = heap->Begin(txn, AccessType::BulkLoad); tuple != heap->End(); ++tuple) {
+        index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+      }
     }
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
 
-    // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
-    auto *tmp = index_info.get();
-
-    // Update internal tracking
-    indexes_.emplace(index_oid, std::move(index_info));
-    table_indexes.emplace(index_name, index_oid);
+    auto *index_info = RegisterIndex(key_schema, index_name, std::move(index), index_oid, table_name, keysize,
+                                     index_type);
+    Persist();
+    return index_info;
+  }
 
-    return tmp;
+  /**
+   * Open an index that is recorded in the database file, see Open(), without reading any of its entries.
+   * @param persisted The index as the catalog recorded it
+   * @param hash_function The hash function for the index
+   * @return A (non-owning) pointer to the metadata of the index, NULL_INDEX_INFO if its table does not exist
+   */
+  template <class KeyType, class ValueType, class KeyComparator>
+  auto AttachIndex(const PersistedIndex &persisted, HashFunction<KeyType> hash_function) -> IndexInfo * {
+    const auto *table_meta = GetTable(persisted.table_name_);
+    if (table_meta == NULL_TABLE_INFO) {
+      return NULL_INDEX_INFO;
+    }
+    auto meta = std::make_unique<IndexMetadata>(persisted.name_, persisted.table_name_, &table_meta->schema_,
+                                                persisted.key_attrs_, persisted.include_attrs_);
+    auto index = MakeIndex<KeyType, ValueType, KeyComparator>(std::move(meta), persisted.index_type_, hash_function,
+                                                              persisted.first_page_id_,
+                                                              [](auto *tree_index) { tree_index->Reattach(); });
+    return RegisterIndex(Schema::CopySchema(&table_meta->schema_, persisted.key_attrs_), persisted.name_,
+                         std::move(index), persisted.index_oid_, persisted.table_name_, persisted.key_size_,
+                         persisted.index_type_);
   }
 
   /**
@@ -298,7 +366,7 @@ class Catalog {
    * @param index_oid The OID of the index for which to query
    * @return A (non-owning) pointer to the metadata for the index
    */
-  auto GetIndex(index_oid_t index_oid) -> IndexInfo * {
+  auto GetIndex(index_oid_t index_oid) const -> IndexInfo * {
     auto index = indexes_.find(index_oid);
     if (index == indexes_.end()) {
       return NULL_INDEX_INFO;
@@ -341,7 +409,107 @@ class Catalog {
     return result;
   }
 
+  /**
+   * Make the catalog persistent: write it into the chain of CatalogPages that starts at catalog_page_id, a new page,
+   * and keep it up to date there from now on.
+   * @param catalog_page_id The first page of the chain
+   */
+  void EnablePersistence(page_id_t catalog_page_id);
+
+  /**
+   * Open the catalog that a database file holds in the chain of CatalogPages at catalog_page_id, and keep it up to
+   * date there from now on. The tables are reopened on their existing heaps. The indexes are returned for the caller
+   * to open with AttachIndex(), with the key types that they were created with. Nothing but the catalog pages is read.
+   * The catalog has to be empty.
+   * @param catalog_page_id The first page of the chain
+   * @return The indexes the catalog holds
+   */
+  auto Open(page_id_t catalog_page_id) -> std::vector<PersistedIndex>;
+
+  /** @return true if the catalog keeps itself in the database file */
+  auto IsPersistent() const -> bool { return catalog_page_id_ != INVALID_PAGE_ID; }
+
  private:
+  /** Write the catalog into its pages, if it is persistent. */
+  void Persist();
+
+  /** Take ownership of index and make it known under index_name and index_oid. */
+  auto RegisterIndex(const Schema &key_schema, const std::string &index_name, std::unique_ptr<Index> &&index,
+                     index_oid_t index_oid, const std::string &table_name, size_t keysize, IndexType index_type)
+      -> IndexInfo * {
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
+    auto *tmp = index_info.get();
+    indexes_.emplace(index_oid, std::move(index_info));
+    index_names_.find(table_name)->second.emplace(index_name, index_oid);
+    return tmp;
+  }
+
+  /**
+   * Construct the index meta describes, of the page types its key type calls for. A hash index is opened at
+   * first_page_id, or created if that is INVALID_PAGE_ID; a B+ tree index is created empty and then handed to
+   * prepare_tree, which fills it or reattaches it to its pages.
+   */
+  template <class KeyType, class ValueType, class KeyComparator, class TreeCallback>
+  auto MakeIndex(std::unique_ptr<IndexMetadata> &&meta, IndexType index_type,
+                 const HashFunction<KeyType> &hash_function, page_id_t first_page_id, TreeCallback &&prepare_tree)
+      -> std::unique_ptr<Index> {
+    if constexpr (IsVarlenKey<KeyType>::value) {
+      // variable length keys are stored in as many bytes as they take, in slotted leaves and, if they can be
+      // normalized, as compressed separators
+      using LeafPage = BPlusTreeSlottedLeafPage<KeyType, ValueType, KeyComparator>;
+      if (KeyComparator(meta->GetKeySchema()).CanNormalize()) {
+        return MakeTreeIndex<KeyType, ValueType, KeyComparator,
+                             BPlusTreeCompressedInternalPage<KeyType, page_id_t, KeyComparator>, LeafPage>(
+            std::move(meta), prepare_tree);
+      }
+      return MakeTreeIndex<KeyType, ValueType, KeyComparator, BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>,
+                           LeafPage>(std::move(meta), prepare_tree);
+    } else if (index_type == IndexType::HashTableIndex) {
+      using HashIndex = ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>;
+      if (first_page_id == INVALID_PAGE_ID) {
+        return std::make_unique<HashIndex>(std::move(meta), bpm_, hash_function);
+      }
+      return std::make_unique<HashIndex>(std::move(meta), bpm_, hash_function, first_page_id);
+    } else if (sizeof(KeyType) >= COMPRESSED_INDEX_MIN_KEY_SIZE && KeyComparator(meta->GetKeySchema()).CanNormalize()) {
+      // wide keys get compressed separators, so that more of them fit into an internal page
+      return MakeTreeIndex<KeyType, ValueType, KeyComparator,
+                           BPlusTreeCompressedInternalPage<KeyType, page_id_t, KeyComparator>>(std::move(meta),
+                                                                                               prepare_tree);
+    } else {
+      return MakeTreeIndex<KeyType, ValueType, KeyComparator, BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>(
+          std::move(meta), prepare_tree);
+    }
+  }
+
+  template <class KeyType, class ValueType, class KeyComparator, class InternalPage,
+            class LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>, class TreeCallback>
+  auto MakeTreeIndex(std::unique_ptr<IndexMetadata> &&meta, TreeCallback &&prepare_tree) -> std::unique_ptr<Index> {
+    auto tree_index =
+        std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator, InternalPage, LeafPage>>(std::move(meta),
+                                                                                                    bpm_);
+    prepare_tree(tree_index.get());
+    return tree_index;
+  }
+
+  /**
+   * Build a B+ tree index over all tuples of heap: sort the keys and build the tree bottom-up instead of descending it
+   * once per tuple. The entries are taken from the tuples by the entry schema of the index.
+   */
+  template <class KeyType, class ValueType, class KeyComparator, class InternalPage, class LeafPage>
+  void BulkLoadTreeIndex(BPlusTreeIndex<KeyType, ValueType, KeyComparator, InternalPage, LeafPage> *tree_index,
+                         TableHeap *heap, const Schema &schema, Transaction *txn) {
+    const auto &entry_schema = *tree_index->GetEntrySchema();
+    const auto &entry_attrs = tree_index->GetEntryAttrs();
+    std::vector<std::pair<KeyType, ValueType>> entries;
+    for (auto tuple = heap->Begin(txn, AccessType::BulkLoad); tuple != heap->End(); ++tuple) {
+      KeyType index_key;
+      index_key.SetFromKey(tuple->KeyFromTuple(schema, entry_schema, entry_attrs));
+      entries.emplace_back(index_key, tuple->GetRid());
+    }
+    tree_index->BulkLoad(&entries, txn);
+  }
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
@@ -371,6 +539,9 @@ class Catalog {
 
   /** The next index identifier to be used. */
   std::atomic<index_oid_t> next_index_oid_{0};
+
+  /** The first of the pages the catalog keeps itself in, INVALID_PAGE_ID if it is not persistent. */
+  page_id_t catalog_page_id_{INVALID_PAGE_ID};
 };
 
 }  // namespace bustub
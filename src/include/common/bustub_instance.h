@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "buffer/buffer_pool_metrics.h"
 #include "catalog/catalog.h"
 #include "common/config.h"
 #include "common/util/string_util.h"
@@ -210,10 +211,34 @@ class BustubInstance {
    */
   auto MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext>;
 
+  /**
+   * Allocate the system pages of a new database: the header page and, if the catalog is to be persistent, the first
+   * catalog page.
+   */
+  void CreateSystemPages(bool persistent);
+
+  /**
+   * Open the database that the database file holds: reattach its tables and indexes to their pages as the catalog
+   * recorded them. No table or index is read, so this takes as long for a large database as for a small one.
+   */
+  void OpenDatabase();
+
  public:
-  explicit BustubInstance(const std::string &db_file_name);
+  /**
+   * Create a BusTub instance backed by a database file. A new file gets a persistent catalog; a file that holds a
+   * database already is opened again, with the tables and indexes it holds.
+   * @param db_file_name the database file
+   * @param bpm_num_instances the number of buffer pool shards; more than one shard uses a ParallelBufferPoolManager
+   * @param posix_io whether to read and write the file through a DiskManagerPosix, which serves the batched reads and
+   * writes of the buffer pool on I/O threads, rather than through the fstream based DiskManager
+   */
+  explicit BustubInstance(const std::string &db_file_name, size_t bpm_num_instances = 1, bool posix_io = false);
 
-  BustubInstance();
+  /**
+   * Create a BusTub instance backed by memory.
+   * @param bpm_num_instances the number of buffer pool shards; more than one shard uses a ParallelBufferPoolManager
+   */
+  explicit BustubInstance(size_t bpm_num_instances = 1);
 
   ~BustubInstance();
 
@@ -227,6 +252,12 @@ class BustubInstance {
    */
   auto ExecuteSqlTxn(const std::string &sql, ResultWriter &writer, Transaction *txn) -> bool;
 
+  /**
+   * Get the metrics of the buffer pool: hits, misses, evictions, write-backs, pin waits, page table probes and disk
+   * latencies, summed over all shards. Also shown by the `\stats` command.
+   */
+  auto GetBufferPoolStats() -> BufferPoolStats;
+
   /**
    * FOR TEST ONLY. Generate test tables in this BusTub instance.
    * It's used in the shell to predefine some tables, as we don't support
@@ -270,6 +301,7 @@ class BustubInstance {
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
+  void CmdDisplayStats(ResultWriter &writer);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
   std::unordered_map<std::string, std::string> session_variables_;
 };
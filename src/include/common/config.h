@@ -27,15 +27,24 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** A running buffer pool background writer wakes up every BACKGROUND_WRITER_INTERVAL milliseconds. */
+extern std::chrono::milliseconds background_writer_interval;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
+static constexpr int CATALOG_PAGE_ID = 1;                                            // first page of the catalog
 static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // size of a data page in byte
 static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr double BG_WRITER_CLEAN_RATIO = 0.25;  // fraction of frames, next victims first, kept clean
+static constexpr int BG_WRITER_MAX_WRITES_PER_SEC = 1000;  // write budget of the background writer
+static constexpr int DISK_IO_THREADS = 4;                   // I/O threads of DiskManagerPosix for batched requests
+static constexpr int TABLE_READ_AHEAD_PAGES = 8;            // pages a table scan keeps in flight ahead of itself
+static constexpr int SCAN_RING_SIZE = 32;                   // frames of a BPI that scans and bulk loads cycle through
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -30,6 +30,11 @@ namespace bustub {
  * Implementation of extendible hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table grows/shrinks dynamically as buckets become full/empty.
+ *
+ * Operations crab through the page latches: lookups, inserts and removes read latch the directory page only until
+ * they hold the latch of their bucket, so they run in parallel on different buckets and never wait for a split of
+ * another bucket. A split or merge write latches the directory and then only the buckets it rewrites. Latches are
+ * always taken directory first, and nobody waits for the directory while holding a bucket latch.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class DiskExtendibleHashTable {
@@ -44,6 +49,21 @@ class DiskExtendibleHashTable {
   explicit DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                    const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
 
+  /**
+   * Opens a DiskExtendibleHashTable that is already in the database file, without reading any of its pages.
+   *
+   * @param directory_page_id the directory page of the hash table, see GetDirectoryPageId()
+   */
+  DiskExtendibleHashTable(BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                          HashFunction<KeyType> hash_fn, page_id_t directory_page_id)
+      : directory_page_id_(directory_page_id),
+        buffer_pool_manager_(buffer_pool_manager),
+        comparator_(comparator),
+        hash_fn_(std::move(hash_fn)) {}
+
+  /** @return the page id of the directory page, which stays the same for the lifetime of the hash table */
+  auto GetDirectoryPageId() const -> page_id_t { return directory_page_id_; }
+
   /**
    * Inserts a key-value pair into the hash table.
    *
@@ -110,7 +130,7 @@ class DiskExtendibleHashTable {
    * @param dir_page to use for lookup of global depth
    * @return the directory index
    */
-  auto KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t;
+  auto KeyToDirectoryIndex(KeyType key, const HashTableDirectoryPage *dir_page) -> uint32_t;
 
   /**
    * Get the bucket page_id corresponding to a key.
@@ -119,10 +139,11 @@ class DiskExtendibleHashTable {
    * @param dir_page a pointer to the hash table's directory page
    * @return the bucket page_id corresponding to the input key
    */
-  auto KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t;
+  auto KeyToPageId(KeyType key, const HashTableDirectoryPage *dir_page) -> page_id_t;
 
   /**
    * Fetches the directory page from the buffer pool manager.
+   * Throws OUT_OF_MEMORY if the buffer pool has no free frame for it.
    *
    * @return a pointer to the directory page
    */
@@ -130,6 +151,7 @@ class DiskExtendibleHashTable {
 
   /**
    * Fetches the a bucket page from the buffer pool manager using the bucket's page_id.
+   * Throws OUT_OF_MEMORY if the buffer pool has no free frame for it.
    *
    * @param bucket_page_id the page_id to fetch
    * @return a pointer to a bucket page
@@ -166,7 +188,8 @@ class DiskExtendibleHashTable {
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writers are splits and merges
+  // Taken exclusively by splits and merges, and shared by GetGlobalDepth() and VerifyIntegrity(), which read the
+  // directory page without latching it. Lookups, inserts and removes only latch pages.
   ReaderWriterLatch table_latch_;
   HashFunction<KeyType> hash_fn_;
 };
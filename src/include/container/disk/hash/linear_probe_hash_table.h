@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <string>
 #include <vector>
@@ -29,7 +30,14 @@ namespace bustub {
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
- * table dynamically grows once full.
+ * table is rebuilt once too many of its slots are occupied, at a size picked
+ * from the number of live entries: it grows, keeps its size or shrinks, and
+ * leaves the tombstones of removed entries behind either way.
+ *
+ * Resizing is incremental. A resize only allocates the new set of block pages and makes it the one inserts go to;
+ * the old set stays live, and lookups and removes look at both. Every Insert() and Remove() then moves the entries
+ * of the next MIGRATION_BATCH_SLOTS old slots over, under a short exclusive hold of the table latch, until the old set
+ * is empty and freed. No operation ever waits for more than one batch to move.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable {
@@ -73,10 +81,19 @@ class LinearProbeHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
-   * @param initial_size the initial size of the hash table
+   * Resizes the table to twice its size. Only sets up the new block pages; the entries move over incrementally, see
+   * FinishResize(). Does nothing if a resize is already in progress, or if the table has grown past initial_size
+   * already.
+   * @param initial_size the size of the hash table the caller saw
+   * @return false if the table cannot grow, true once it is bigger than initial_size or on its way there
    */
-  void Resize(size_t initial_size);
+  auto Resize(size_t initial_size) -> bool;
+
+  /**
+   * Moves all entries that are still in the old block pages of a resize over, one batch at a time, and waits until
+   * the old block pages are freed. Returns right away if there is no resize in progress.
+   */
+  void FinishResize();
 
   /**
    * Gets the size of the hash table
@@ -84,22 +101,72 @@ class LinearProbeHashTable {
    */
   auto GetSize() -> size_t;
 
+  /** Number of old slots an Insert() or Remove() moves over while a resize is in progress. */
+  static constexpr size_t MIGRATION_BATCH_SLOTS = 64;
+
+  /**
+   * A rebuild starts once this fraction of the slots is occupied, counting tombstones. The table grows if more than
+   * half of that is live, and shrinks while a quarter of it would still hold every live entry in a table half the size.
+   */
+  static constexpr double MAX_LOAD_FACTOR = 0.75;
+
  private:
-  auto GetHeaderPage() -> HashTableHeaderPage *;
-  auto GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE *;
-  void ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value);
-  void DeleteBlockPages(HashTableHeaderPage *old_header_page);
-  void CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks);
-  auto GetValueLatchFree(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
+  enum class InsertResult { INSERTED, DUPLICATE, TABLE_FULL };
+
+  /** Allocates a header page and enough zeroed block pages for num_buckets slots; INVALID_PAGE_ID on failure. */
+  auto CreateBlockPages(size_t num_buckets) -> page_id_t;
+
+  /** Frees a header page and its block pages. */
+  void DeleteBlockPages(page_id_t header_page_id);
+
+  /** Collects the values of key from the block pages of header_page_id. */
+  auto LookupIn(page_id_t header_page_id, const KeyType &key, std::vector<ValueType> *result) -> bool;
+
+  /** Puts a pair in the first never occupied slot of its probe sequence in the block pages of header_page_id. */
+  auto InsertInto(page_id_t header_page_id, const KeyType &key, const ValueType &value) -> InsertResult;
+
+  /** Removes a pair from the block pages of header_page_id. */
+  auto RemoveFrom(page_id_t header_page_id, const KeyType &key, const ValueType &value) -> bool;
+
+  /**
+   * Rebuilds the table at a size that fits its live entries, unless a resize is in progress or the table is no longer
+   * past MAX_LOAD_FACTOR.
+   */
+  void Rebuild();
+
+  /** Allocates new_size slots and makes them the ones inserts go to. Needs resizing_ set; clears it on failure. */
+  auto StartResize(size_t new_size) -> bool;
+
+  /** Moves one batch of old slots over if a resize is in progress. */
+  void HelpResize();
+
+  /**
+   * Moves up to max_slots old slots over, and frees the old block pages after the last one. Needs the table latch
+   * held exclusively.
+   */
+  void MigrateSlots(size_t max_slots);
 
   // member variable
   page_id_t header_page_id_;
+  // A rebuild never shrinks the table below the number of buckets it was created with
+  size_t min_size_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // Readers are lookups, inserts and removes; writers install a new set of block pages or move a batch of slots
   ReaderWriterLatch table_latch_;
 
+  // Header page of the block pages being emptied by a resize, INVALID_PAGE_ID if there is none
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
+  // Next old slot to move over
+  size_t migrate_cursor_{0};
+  // Set from the moment a resize starts allocating until its old block pages are freed
+  std::atomic<bool> resizing_{false};
+  // Occupied slots, including tombstones, in the block pages of header_page_id_
+  std::atomic<size_t> num_occupied_{0};
+  // Live entries, in both the block pages of header_page_id_ and those of old_header_page_id_
+  std::atomic<size_t> num_live_{0};
+
   // Hash function
   HashFunction<KeyType> hash_fn_;
 };
@@ -17,9 +17,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <shared_mutex>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -29,6 +32,12 @@ namespace bustub {
 
 /**
  * ExtendibleHashTable implements a hash table using the extendible hashing algorithm.
+ *
+ * The table is safe for concurrent use. The directory has a reader-writer latch and every bucket has its own latch.
+ * Find() and Remove() take the directory latch shared and then only the latch of the one bucket they touch, so
+ * operations on different buckets run in parallel. Insert() does the same unless the bucket is full; only then does it
+ * come back for the directory latch in exclusive mode to split the bucket and, if needed, double the directory.
+ *
  * @tparam K key type
  * @tparam V value type
  */
@@ -77,6 +86,15 @@ class ExtendibleHashTable : public HashTable<K, V> {
    */
   auto Find(const K &key, V &value) -> bool override;
 
+  /**
+   * @brief Find(), also reporting how many entries of the bucket were looked at.
+   * @param key The key to be searched.
+   * @param[out] value The value associated with the key.
+   * @param[out] probes The number of entries compared against the key.
+   * @return True if the key is found, false otherwise.
+   */
+  auto Find(const K &key, V &value, size_t *probes) -> bool;
+
   /**
    *
    * TODO(P1): Add implementation
@@ -99,7 +117,12 @@ class ExtendibleHashTable : public HashTable<K, V> {
    * TODO(P1): Add implementation
    *
    * @brief Given the key, remove the corresponding key-value pair in the hash table.
-   * Shrink & Combination is not required for this project
+   *
+   * A bucket that drops to the low-water mark (a quarter full) is merged with its split image if both together fill at
+   * most half a bucket, repeatedly, and the directory is halved while no bucket needs its full depth. The gap between
+   * the two marks keeps a workload that hovers around one size from splitting and merging the same buckets over and
+   * over.
+   *
    * @param key The key to be deleted.
    * @return True if the key exists, false otherwise.
    */
@@ -107,21 +130,58 @@ class ExtendibleHashTable : public HashTable<K, V> {
 
   /**
    * Bucket class for each hash table bucket that the directory points to.
+   *
+   * If both K and V are trivially copyable, a bucket keeps its entries in fixed-capacity arrays allocated once with the
+   * bucket: the keys, the values, and a one-byte tag per entry taken from the key's hash. A lookup scans the tags (or,
+   * for 32-bit integral keys, the keys themselves, four at a time with SSE2) and only compares the keys whose tag
+   * matches, so it touches a couple of cache lines and never allocates. Other types fall back to a std::list.
    */
   class Bucket {
    public:
+    /** True if the bucket uses the flat array layout. */
+    static constexpr bool FLAT = std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>;
+
     explicit Bucket(size_t size, int depth = 0);
 
     /** @brief Check if a bucket is full. */
-    inline auto IsFull() const -> bool { return list_.size() == size_; }
+    inline auto IsFull() const -> bool { return Count() == size_; }
+
+    /** @brief Get the number of entries in the bucket. */
+    inline auto Count() const -> size_t {
+      if constexpr (FLAT) {
+        return count_;
+      } else {
+        return list_.size();
+      }
+    }
 
     /** @brief Get the local depth of the bucket. */
     inline auto GetDepth() const -> int { return depth_; }
 
+    /** @brief The latch of this bucket, taken with the directory latch held in shared mode. */
+    inline auto GetLatch() -> std::shared_mutex & { return latch_; }
+
     /** @brief Increment the local depth of a bucket. */
     inline void IncrementDepth() { depth_++; }
 
-    inline auto GetItems() -> std::list<std::pair<K, V>> & { return list_; }
+    /** @brief Decrement the local depth of a bucket. */
+    inline void DecrementDepth() { depth_--; }
+
+    /** @brief Get any key of a non-empty bucket. */
+    auto AnyKey() const -> const K &;
+
+    /**
+     * @brief Move every entry whose key hash has the given bit set into another bucket.
+     * @param image The bucket to move the entries to.
+     * @param high_bit The hash bit that tells the entries apart.
+     */
+    void SplitInto(Bucket *image, size_t high_bit);
+
+    /**
+     * @brief Move every entry of another bucket into this one, which must have room for them.
+     * @param image The bucket to take the entries from.
+     */
+    void MergeFrom(Bucket *image);
 
     /**
      *
@@ -130,9 +190,10 @@ class ExtendibleHashTable : public HashTable<K, V> {
      * @brief Find the value associated with the given key in the bucket.
      * @param key The key to be searched.
      * @param[out] value The value associated with the key.
+     * @param[out] probes If not null, the number of entries compared against the key.
      * @return True if the key is found, false otherwise.
      */
-    auto Find(const K &key, V &value) -> bool;
+    auto Find(const K &key, V &value, size_t *probes = nullptr) -> bool;
 
     /**
      *
@@ -158,10 +219,28 @@ class ExtendibleHashTable : public HashTable<K, V> {
     auto Insert(const K &key, const V &value) -> bool;
 
    private:
-    // TODO(student): You may add additional private members and helper functions
+    /** @return the position of key in the flat arrays, or -1 */
+    auto FindIndex(const K &key, size_t *probes) const -> int;
+
+    /** @brief Drop the entry at a position of the flat arrays, moving the last entry into its place. */
+    void EraseAt(size_t index);
+
+    /** @brief Append an entry to the flat arrays, which must not be full. */
+    void Append(const K &key, const V &value);
+
+    /** @return the tag of a key, taken from the bits of its hash the directory does not use first */
+    static auto TagOf(const K &key) -> uint8_t;
+
     size_t size_;
     int depth_;
+    // The flat layout: entries [0, count_) of the three arrays, each allocated with size_ slots.
+    size_t count_{0};
+    std::vector<uint8_t> tags_;
+    std::vector<K> keys_;
+    std::vector<V> values_;
+    // The list layout.
     std::list<std::pair<K, V>> list_;
+    std::shared_mutex latch_;
   };
 
  private:
@@ -171,7 +250,8 @@ class ExtendibleHashTable : public HashTable<K, V> {
   int global_depth_;    // The global depth of the directory
   size_t bucket_size_;  // The size of a bucket
   int num_buckets_;     // The number of buckets in the hash table
-  mutable std::mutex latch_;
+  /** Shared to look up a bucket, exclusive to change the directory or split a bucket. */
+  mutable std::shared_mutex latch_;
   std::vector<std::shared_ptr<Bucket>> dir_;  // The directory of the hash table
 
   // The following functions are completely optional, you can delete them if you have your own ideas.
@@ -186,6 +266,20 @@ class ExtendibleHashTable : public HashTable<K, V> {
    * Must acquire latch_ first before calling the below functions. *
    *****************************************************************/
 
+  /**
+   * @brief Insert into a full bucket, splitting it until the key fits. Must hold latch_ in exclusive mode.
+   * @param key The key to be inserted.
+   * @param value The value to be inserted.
+   */
+  void InsertWithSplit(const K &key, const V &value);
+
+  /**
+   * @brief Merge the bucket of key with its split image for as long as both fit in half a bucket, then halve the
+   * directory while every local depth is below the global depth. Must hold latch_ in exclusive mode.
+   * @param key A key that hashes to the bucket to merge.
+   */
+  void MergeBucket(const K &key);
+
   /**
    * @brief For the given key, return the entry index in the directory where the key hashes to.
    * @param key The key to be hashed.
@@ -12,18 +12,26 @@
 
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/index_scan_plan.h"
+#include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * IndexScanExecutor executes an index scan over a table.
+ * IndexScanExecutor executes an index scan over a table. Init() collects the RIDs of the plan's key range from the
+ * index, which reads them a leaf at a time; Next() fetches the tuples in key order and filters them. An index-only scan
+ * collects the index entries instead, and Next() builds the tuples out of them.
+ *
+ * A scan with a limit collects only as many RIDs as it is to produce tuples. If some of them point to tuples that are
+ * gone, Next() collects more, starting past the key of the last one, until it has produced limit_ tuples or the key
+ * range runs out.
  */
 
 class IndexScanExecutor : public AbstractExecutor {
@@ -42,7 +50,41 @@ class IndexScanExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Produce the next tuple of an index-only scan out of entries_. */
+  auto NextEntry(Tuple *tuple, RID *rid) -> bool;
+
+  /** Collect the next num_entries RIDs, or entries, of the key range, past last_key_ if it is set. */
+  void Fetch(size_t num_entries);
+
+  /**
+   * Collect more RIDs, or entries, once the ones collected are used up, if the scan has produced fewer tuples than its
+   * limit and the key range holds more.
+   * @return false if there is nothing more to collect
+   */
+  auto Refill() -> bool;
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+  /** The index to scan. */
+  const IndexInfo *index_info_;
+  /** The table the index points into. */
+  TableHeap *table_heap_;
+  /** The RIDs in the key range, in key order. */
+  std::vector<RID> rids_;
+  /** The entries in the key range, in key order, for an index-only scan. */
+  std::vector<std::pair<Tuple, RID>> entries_;
+  /** For each output column, its position in the index entries, or -1 if the index does not hold it. */
+  std::vector<int> entry_positions_;
+  /** The position of the next RID to fetch in rids_, or of the next entry in entries_. */
+  size_t cursor_{0};
+  /** The bounds of the key range, nullptr if it is open on that side. */
+  std::unique_ptr<Tuple> lower_bound_;
+  std::unique_ptr<Tuple> upper_bound_;
+  /** The key of the last entry collected by a scan with a limit, nullptr before the first one. */
+  std::unique_ptr<Tuple> last_key_;
+  /** The number of tuples produced so far. */
+  size_t num_produced_{0};
+  /** Whether the RIDs, or entries, collected are all there are in the key range. */
+  bool exhausted_{false};
 };
 }  // namespace bustub
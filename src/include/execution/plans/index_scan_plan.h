@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -22,6 +23,18 @@
 namespace bustub {
 /**
  * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
+ *
+ * The scan runs over the keys of a B+ tree index in order, from lower_bound_ to upper_bound_ inclusive. Each bound is
+ * a constant of the single index key column, or nullptr if the scan is open on that side. The tuples found are then
+ * checked against filter_predicate_, which holds whatever the bounds do not express.
+ *
+ * A reverse scan runs from upper_bound_ down to lower_bound_, producing the tuples in descending key order. Without a
+ * filter predicate, the scan may also stop after limit_ tuples, for an ORDER BY ... LIMIT served by the index. Only
+ * the tuples it produces count towards the limit; index entries whose tuples are gone do not.
+ *
+ * An index-only scan reads the column values from the index entries and never fetches the tuples from the table. It
+ * is planned only if the entries of the index, its key and included columns, hold every column the query reads; the
+ * other columns of the output are NULL.
  */
 class IndexScanPlanNode : public AbstractPlanNode {
  public:
@@ -29,9 +42,24 @@ class IndexScanPlanNode : public AbstractPlanNode {
    * Creates a new index scan plan node.
    * @param output the output format of this scan plan node
    * @param table_oid the identifier of table to be scanned
+   * @param lower_bound the smallest key to scan, nullptr to start at the first key
+   * @param upper_bound the largest key to scan, nullptr to scan to the last key
+   * @param filter_predicate the predicate the tuples have to satisfy, nullptr for all tuples
+   * @param reverse whether to scan in descending key order
+   * @param limit the most tuples to produce, std::nullopt for no limit
+   * @param index_only whether to produce the tuples out of the index entries alone
    */
-  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
-      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, AbstractExpressionRef lower_bound = nullptr,
+                    AbstractExpressionRef upper_bound = nullptr, AbstractExpressionRef filter_predicate = nullptr,
+                    bool reverse = false, std::optional<size_t> limit = std::nullopt, bool index_only = false)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        lower_bound_(std::move(lower_bound)),
+        upper_bound_(std::move(upper_bound)),
+        filter_predicate_(std::move(filter_predicate)),
+        reverse_(reverse),
+        limit_(limit),
+        index_only_(index_only) {}
 
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
@@ -43,11 +71,44 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** The smallest key to scan, nullptr if there is no lower bound. */
+  AbstractExpressionRef lower_bound_;
+
+  /** The largest key to scan, nullptr if there is no upper bound. */
+  AbstractExpressionRef upper_bound_;
+
+  /** The predicate to filter the scanned tuples with, nullptr if there is none. */
+  AbstractExpressionRef filter_predicate_;
+
+  /** Whether the keys are scanned in descending order. */
+  bool reverse_;
+
+  /** The most tuples to produce, std::nullopt if there is no limit. */
+  std::optional<size_t> limit_;
+
+  /** Whether the tuples are produced out of the index entries, without reading the table. */
+  bool index_only_;
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    auto str = fmt::format("IndexScan {{ index_oid={}", index_oid_);
+    if (lower_bound_ != nullptr || upper_bound_ != nullptr || filter_predicate_ != nullptr) {
+      auto to_string = [](const AbstractExpressionRef &expr) {
+        return expr == nullptr ? std::string("none") : expr->ToString();
+      };
+      str += fmt::format(", lower={}, upper={}, filter={}", to_string(lower_bound_), to_string(upper_bound_),
+                         to_string(filter_predicate_));
+    }
+    if (reverse_) {
+      str += ", reverse=true";
+    }
+    if (limit_.has_value()) {
+      str += fmt::format(", limit={}", *limit_);
+    }
+    if (index_only_) {
+      str += ", index_only=true";
+    }
+    return str + " }";
   }
 };
 
@@ -81,10 +81,23 @@ class Optimizer {
   auto IsPredicateTrue(const AbstractExpression &expr) -> bool;
 
   /**
-   * @brief optimize order by as index scan if there's an index on a table
+   * @brief optimize order by as index scan if there's an index on a table, scanning it in reverse for desc; a limit
+   * over such a scan stops it after that many tuples
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief optimize filter over seq scan as a B+ tree index scan bounded by the comparisons of an index key column with
+   * constants, e.g. `x >= 3 AND x < 7` scans the keys from 3 to 7 and filters out 7
+   */
+  auto OptimizeFilterAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief optimize index scan as index-only scan if the entries of the index, its key and included columns, hold every
+   * column that the scan filter and the plan above the scan read
+   */
+  auto OptimizeIndexOnlyScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /** @brief check if the index can be matched */
   auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
       -> std::optional<std::tuple<index_oid_t, std::string>>;
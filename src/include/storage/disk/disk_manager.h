@@ -17,6 +17,7 @@
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 
@@ -42,7 +43,7 @@ class DiskManager {
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
    * Write a page to the database file.
@@ -58,6 +59,22 @@ class DiskManager {
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Write a batch of pages to the database file. The default implementation writes them one by one; disk managers
+   * that can overlap I/O override it.
+   * @param page_ids ids of the pages
+   * @param page_data raw page data, page_data[i] belongs to page_ids[i]
+   */
+  virtual void WritePages(const std::vector<page_id_t> &page_ids, const std::vector<const char *> &page_data);
+
+  /**
+   * Read a batch of pages from the database file. The default implementation reads them one by one; disk managers
+   * that can overlap I/O override it.
+   * @param page_ids ids of the pages
+   * @param[out] page_data output buffers, page_data[i] receives page_ids[i]
+   */
+  virtual void ReadPages(const std::vector<page_id_t> &page_ids, const std::vector<char *> &page_data);
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -83,6 +100,9 @@ class DiskManager {
   /** @return the number of disk writes */
   auto GetNumWrites() const -> int;
 
+  /** @return the number of pages the database file holds, i.e. the page id past the last page written to it */
+  auto GetNumPages() const -> page_id_t;
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -101,7 +121,7 @@ class DiskManager {
   std::fstream db_io_;
   std::string file_name_;
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
   // With multiple buffer pool instances, need to protect file access
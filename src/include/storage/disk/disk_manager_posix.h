@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.h
+//
+// Identification: src/include/storage/disk/disk_manager_posix.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/uio.h>
+
+#include <condition_variable>  // NOLINT
+#include <functional>
+#include <mutex>  // NOLINT
+#include <queue>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerPosix reads and writes pages with positional I/O (pread/pwrite) on a raw file descriptor. Unlike the
+ * fstream based DiskManager there is no seek position to protect, so requests for different pages from different
+ * threads (e.g. different ParallelBufferPoolManager shards) go to the kernel concurrently.
+ *
+ * Batched requests are sorted by page id, pages with consecutive ids are merged into a single preadv()/pwritev(), and
+ * the merged runs are spread over a small pool of I/O threads. The log file is still handled by DiskManager.
+ */
+class DiskManagerPosix : public DiskManager {
+ public:
+  /**
+   * Creates a new disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param num_io_threads number of I/O threads serving batched requests, 0 runs every batch on the caller's thread
+   */
+  explicit DiskManagerPosix(const std::string &db_file, size_t num_io_threads = DISK_IO_THREADS);
+
+  ~DiskManagerPosix() override;
+
+  /**
+   * Stop the I/O threads and close all the file resources.
+   */
+  void ShutDown() override;
+
+  /**
+   * Write a page to the database file.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Read a page from the database file. Reading past the end of the file yields a zeroed page.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Write a batch of pages to the database file. Returns once every page is written.
+   * @param page_ids ids of the pages
+   * @param page_data raw page data, page_data[i] belongs to page_ids[i]
+   */
+  void WritePages(const std::vector<page_id_t> &page_ids, const std::vector<const char *> &page_data) override;
+
+  /**
+   * Read a batch of pages from the database file. Returns once every page is read.
+   * @param page_ids ids of the pages
+   * @param[out] page_data output buffers, page_data[i] receives page_ids[i]
+   */
+  void ReadPages(const std::vector<page_id_t> &page_ids, const std::vector<char *> &page_data) override;
+
+ private:
+  /** Pages with consecutive ids, transferred by one preadv()/pwritev() starting at first_page_id_. */
+  struct IORun {
+    page_id_t first_page_id_;
+    std::vector<iovec> iov_;
+  };
+
+  /**
+   * Sort the batch by page id and merge consecutive pages into runs. A page written more than once gets only its last
+   * write of the batch.
+   */
+  static auto BuildRuns(const std::vector<page_id_t> &page_ids, const std::vector<char *> &buffers, bool is_write)
+      -> std::vector<IORun>;
+
+  /**
+   * Transfer a run, retrying short transfers. A read that hits the end of the file zero-fills the rest of the run. An
+   * I/O error is logged as a warning, and the pages it left unwritten are not counted as writes.
+   */
+  void TransferRun(const IORun &run, bool is_write);
+
+  /** Transfer all runs, spreading them over the I/O threads and the caller's thread. */
+  void TransferRuns(const std::vector<IORun> &runs, bool is_write);
+
+  /** Main loop of an I/O thread. */
+  void RunWorker();
+
+  /** Stop and join the I/O threads, if they are running. */
+  void StopWorkers();
+
+  int db_fd_{-1};
+
+  std::vector<std::thread> workers_;
+  /** Protects tasks_ and stop_workers_. */
+  std::mutex task_latch_;
+  std::condition_variable task_cv_;
+  std::queue<std::function<void()>> tasks_;
+  bool stop_workers_{false};
+};
+
+}  // namespace bustub
@@ -10,18 +10,28 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <deque>
+#include <functional>
 #include <queue>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "common/rwlatch.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
+#include "storage/page/b_plus_tree_compressed_internal_page.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_slotted_leaf_page.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
-#define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
+#define BPLUSTREE_TEMPLATE_ARGUMENTS \
+  template <typename KeyType, typename ValueType, typename KeyComparator, typename InternalPage, typename LeafPage>
+#define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator, InternalPage, LeafPage>
 
 /**
  * Main class providing the API for the Interactive B+ Tree.
@@ -32,15 +42,51 @@ namespace bustub {
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * Concurrency: readers descend through internal pages optimistically. They pin each page and remember its version
+ * instead of taking its latch, and only read-latch the leaf. Writers first descend the same way and write-latch only
+ * the leaf; if the leaf is safe for the operation nothing above it can change, and the write completes there. Otherwise
+ * the writer starts over and crabs down with write latches from the root, releasing the ancestors once a page is safe.
+ * A writer bumps the version of every page it latches, which sends a concurrent optimistic descent that crossed the
+ * page back to the root. root_latch_ protects root_page_id_ and is only held exclusively by pessimistic writers.
+ *
+ * InternalPage is BPlusTreeInternalPage, or BPlusTreeCompressedInternalPage to store separators compressed. The tree
+ * routes with the page's SeparatorType and leaves it to the page to tell whether a separator fits.
+ *
+ * LeafPage is BPlusTreeLeafPage, or BPlusTreeSlottedLeafPage for variable length keys. Likewise, the leaf page tells
+ * whether an entry fits and where to split, so that leaves may be full or underfull by bytes rather than entries.
  */
-INDEX_TEMPLATE_ARGUMENTS
+template <typename KeyType, typename ValueType, typename KeyComparator,
+          typename InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>,
+          typename LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>
 class BPlusTree {
-  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
-  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using SeparatorType = typename InternalPage::SeparatorType;
 
  public:
+  using EntryIterator = typename std::vector<std::pair<KeyType, ValueType>>::const_iterator;
+  /** Takes a batch of entries of a range scan; returns false to end the scan. */
+  using ScanCallback = std::function<bool(const std::vector<std::pair<KeyType, ValueType>> &)>;
+
+  /** @return the default internal max size: as many entries as fit into a page */
+  static constexpr auto DefaultInternalMaxSize() -> int {
+    if constexpr (std::is_same_v<InternalPage, BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>) {
+      return INTERNAL_PAGE_SIZE;
+    } else {
+      return COMPRESSED_INTERNAL_PAGE_SIZE;
+    }
+  }
+
+  /** @return the default leaf max size: as many entries as fit into a page */
+  static constexpr auto DefaultLeafMaxSize() -> int {
+    if constexpr (std::is_same_v<LeafPage, BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>) {
+      return LEAF_PAGE_SIZE;
+    } else {
+      return SLOTTED_LEAF_PAGE_SIZE;
+    }
+  }
+
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = DefaultLeafMaxSize(), int internal_max_size = DefaultInternalMaxSize());
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
@@ -51,17 +97,50 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
+  /**
+   * Build the tree bottom-up out of sorted entries: leaves are filled left to right, then each level of internal pages
+   * is built over the one below it. Equal keys keep their first value, as they would with Insert().
+   * @param fill_factor the fraction of each page to fill, leaving room for later inserts
+   * @return false, leaving the tree untouched, if the tree is not empty or the entries are not sorted
+   */
+  auto BulkLoad(EntryIterator first, EntryIterator last, double fill_factor = 1.0) -> bool;
+
   // return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
 
+  /**
+   * Scan the entries with lo <= key <= hi in key order, a leaf at a time. The entries of a leaf that are in range are
+   * copied out under a single read latch, and the read of the next leaf is started before they are.
+   * @param lo the smallest key to return, nullptr to start at the first key
+   * @param hi the largest key to return, nullptr to scan to the last key
+   * @param callback called with each non-empty batch, with no latch held
+   */
+  void Scan(const KeyType *lo, const KeyType *hi, const ScanCallback &callback);
+
+  /**
+   * Scan the entries with lo <= key <= hi like Scan(), but in reverse key order, following the leaves' previous page
+   * ids. Each batch holds the entries of one leaf, largest key first.
+   */
+  void ReverseScan(const KeyType *lo, const KeyType *hi, const ScanCallback &callback);
+
   // return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
+  /**
+   * Take up the root that the header page records under the name of this tree, for a tree that is already in the
+   * database file, e.g. one that is opened again. The tree is empty if there is no record of it.
+   */
+  void Reattach();
+
   // index iterator
   auto Begin() -> INDEXITERATOR_TYPE;
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
   auto End() -> INDEXITERATOR_TYPE;
 
+  // reverse index iterator: starts at the last entry, or the last one not greater than key, and moves with operator--
+  auto RBegin() -> INDEXITERATOR_TYPE;
+  auto RBegin(const KeyType &key) -> INDEXITERATOR_TYPE;
+
   // print the B+ tree
   void Print(BufferPoolManager *bpm);
 
@@ -75,6 +154,79 @@ class BPlusTree {
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
 
  private:
+  enum class Operation { INSERT, REMOVE };
+  /** Which leaf a descent ends at: the one for a key, or the first or last leaf of the tree. */
+  enum class Descent { KEY, LEFTMOST, RIGHTMOST };
+
+  /** Pages a writer holds latched on its way down, from the highest latched ancestor to the leaf. */
+  struct WriteContext {
+    bool root_latched_{false};
+    std::deque<WritePageGuard> write_set_;
+    std::vector<page_id_t> deleted_pages_;
+  };
+
+  /** Pin a page of the tree for an optimistic read, throwing if the buffer pool has no frame for it. */
+  auto FetchTreePageOptimistic(page_id_t page_id) -> OptimisticReadGuard;
+
+  /** Fetch a page of the tree, throwing if the buffer pool has no frame for it. */
+  auto FetchTreePage(page_id_t page_id) -> BasicPageGuard;
+
+  /** Allocate a page for the tree, throwing if the buffer pool has no frame for it. */
+  auto NewTreePage(page_id_t *page_id) -> BasicPageGuard;
+
+  /**
+   * Descend to the leaf for key (or the leftmost or rightmost leaf) with optimistic reads of the internal pages.
+   * @return the pinned, unlatched leaf, whose version still has to be validated when latching it; an empty guard if
+   * the tree is empty
+   */
+  auto FindLeafOptimistic(const KeyType &key, Descent descent) -> OptimisticReadGuard;
+
+  /**
+   * Find the leaf for key (or the leftmost or rightmost leaf) with optimistic reads of the internal pages.
+   * @return the read guard of the leaf, or an empty guard if the tree is empty
+   */
+  auto FindLeafRead(const KeyType &key, Descent descent) -> ReadPageGuard;
+
+  /**
+   * Find the leaf for key and the index of the first entry in it that is not less than key. Iterators use it to find
+   * their way back when a split or merge relinked the leaves they step over.
+   */
+  auto Locate(const KeyType &key) -> std::pair<ReadPageGuard, int>;
+
+  /** @return Locate() for the iterators of this tree */
+  auto MakeLocateFunction() -> typename INDEXITERATOR_TYPE::LocateFunction;
+
+  /** Point the prev page id of the leaf after leaf, if there is one, back at leaf, which has to be write-latched. */
+  void LinkNextLeafBack(const LeafPage *leaf);
+
+  /**
+   * Find the leaf for key with optimistic reads of the internal pages and write-latch it.
+   * @return the write guard of the leaf, or an empty guard if the tree is empty or op may not be safe on the leaf
+   */
+  auto FindSafeLeafWrite(const KeyType &key, Operation op) -> WritePageGuard;
+
+  /**
+   * Find the leaf for key with write latch crabbing. Returns with the leaf and its unsafe ancestors latched in ctx,
+   * the leaf being ctx->write_set_.back().
+   * @return false if the tree is empty (root_latch_ is still held then)
+   */
+  auto FindLeafWrite(const KeyType &key, Operation op, WriteContext *ctx) -> bool;
+
+  /** @return true if op on node cannot change its parent */
+  auto IsSafe(const BPlusTreePage *node, Operation op) const -> bool;
+
+  /** Release the pages in ctx, except the last keep ones, and release root_latch_ if held. */
+  void ReleaseAncestors(WriteContext *ctx, size_t keep = 1);
+
+  /** Release everything in ctx, then delete the pages removed by merges. */
+  void ReleaseAll(WriteContext *ctx);
+
+  void StartNewTree(const KeyType &key, const ValueType &value);
+  void InsertIntoParent(BPlusTreePage *old_node, const SeparatorType &key, BPlusTreePage *new_node, WriteContext *ctx,
+                        size_t depth);
+  void HandleUnderflow(BPlusTreePage *node, WriteContext *ctx, size_t depth);
+  void AdjustRoot(BPlusTreePage *old_root, WriteContext *ctx);
+
   void UpdateRootPageId(int insert_record = 0);
 
   /* Debug Routines for FREE!! */
@@ -84,6 +236,7 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
+  mutable ReaderWriterLatch root_latch_;
   page_id_t root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
@@ -14,17 +14,27 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree.h"
 #include "storage/index/index.h"
+#include "storage/index/varlen_key.h"
 
 namespace bustub {
 
-#define BPLUSTREE_INDEX_TYPE BPlusTreeIndex<KeyType, ValueType, KeyComparator>
+#define BPLUSTREE_INDEX_TYPE BPlusTreeIndex<KeyType, ValueType, KeyComparator, InternalPage, LeafPage>
 
-INDEX_TEMPLATE_ARGUMENTS
+/** Fraction of each page a bulk loaded index fills, so that inserts right after the load do not split every page. */
+static constexpr double BULK_LOAD_FILL_FACTOR = 0.9;
+
+/** Keys at least this wide are worth compressing the separators of, see BPlusTreeCompressedInternalPage. */
+static constexpr size_t COMPRESSED_INDEX_MIN_KEY_SIZE = 16;
+
+template <typename KeyType, typename ValueType, typename KeyComparator,
+          typename InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>,
+          typename LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>
 class BPlusTreeIndex : public Index {
  public:
   BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
@@ -35,6 +45,22 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void ScanRange(const Tuple *lo, const Tuple *hi, bool reverse, size_t limit, std::vector<RID> *result,
+                 Transaction *transaction) override;
+
+  void ScanRangeEntries(const Tuple *lo, const Tuple *hi, bool reverse, size_t limit,
+                        std::vector<std::pair<Tuple, RID>> *result, Transaction *transaction) override;
+
+  /**
+   * Build the index in one go out of all the entries it should hold. The entries are sorted here, and the tree is bulk
+   * loaded bottom-up with BULK_LOAD_FILL_FACTOR. The index must be empty.
+   * @param entries (key, rid) pairs in any order; sorted on return
+   */
+  void BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries, Transaction *transaction);
+
+  /** Take up the tree of the same name that is already in the database file, see BPlusTree::Reattach(). */
+  void Reattach() { container_.Reattach(); }
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
@@ -42,10 +68,17 @@ class BPlusTreeIndex : public Index {
   auto GetEndIterator() -> INDEXITERATOR_TYPE;
 
  protected:
+  /**
+   * Visit the entries between lo and hi in key order, or in reverse key order, until limit of them are visited.
+   * @param visit called with the key and the value of each entry
+   */
+  template <typename Visitor>
+  void VisitRange(const Tuple *lo, const Tuple *hi, bool reverse, size_t limit, Visitor &&visit);
+
   // comparator for key
   KeyComparator comparator_;
   // container
-  BPlusTree<KeyType, ValueType, KeyComparator> container_;
+  BPlusTree<KeyType, ValueType, KeyComparator, InternalPage, LeafPage> container_;
 };
 
 /** We only support index table with one integer key for now in BusTub. Hardcode everything here. */
@@ -59,4 +92,11 @@ using BPlusTreeIndexIteratorForOneIntegerColumn =
     IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using IntegerHashFunctionType = HashFunction<IntegerKeyType>;
 
+/** Any other key schema, such as VARCHAR or composite keys, gets a B+ tree of variable length keys. */
+
+constexpr static const auto VARLEN_KEY_SIZE = 256;
+using VarlenKeyType = VarlenKey<VARLEN_KEY_SIZE>;
+using VarlenComparatorType = VarlenComparator<VARLEN_KEY_SIZE>;
+using VarlenHashFunctionType = HashFunction<VarlenKeyType>;
+
 }  // namespace bustub
@@ -31,6 +31,10 @@ class ExtendibleHashTableIndex : public Index {
   ExtendibleHashTableIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
                            const HashFunction<KeyType> &hash_fn);
 
+  /** Open the hash index whose directory is at directory_page_id, which is already in the database file. */
+  ExtendibleHashTableIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                           const HashFunction<KeyType> &hash_fn, page_id_t directory_page_id);
+
   ~ExtendibleHashTableIndex() override = default;
 
   void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
@@ -39,6 +43,9 @@ class ExtendibleHashTableIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /** @return the directory page of the hash table */
+  auto GetFirstPageId() const -> page_id_t override { return container_.GetDirectoryPageId(); }
+
  protected:
   // comparator for key
   KeyComparator comparator_;
@@ -12,7 +12,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
+#include <iomanip>
+#include <ios>
 
 #include "storage/table/tuple.h"
 #include "type/value.h"
@@ -70,13 +74,116 @@ class GenericKey {
   char data_[KeySize];
 };
 
+/**
+ * The normalized form of a GenericKey: its columns encoded so that comparing the bytes with memcmp orders keys as
+ * GenericComparator does, a key that is a prefix of another ordering first. Compressed B+ tree internal pages keep
+ * their separators in this form, truncated to the bytes that tell two neighbouring keys apart.
+ */
+template <size_t KeySize>
+class NormalizedKey {
+ public:
+  /** @return the most bytes a normalized key can have */
+  static constexpr auto Capacity() -> size_t { return KeySize; }
+
+  inline auto Size() const -> size_t { return size_; }
+
+  inline auto Data() const -> const char * { return data_; }
+
+  inline void Assign(const char *data, size_t size) {
+    size_ = static_cast<uint16_t>(size);
+    memcpy(data_, data, size);
+  }
+
+  /** Append size bytes to the key. */
+  inline void Append(const char *data, size_t size) {
+    memcpy(data_ + size_, data, size);
+    size_ += static_cast<uint16_t>(size);
+  }
+
+  /** Append an integer column stored little-endian in width bytes: big-endian, with the sign bit flipped if signed. */
+  inline void AppendInteger(const char *data, size_t width, bool is_signed) {
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "key columns are stored little-endian");
+    uint64_t bits = 0;
+    memcpy(&bits, data, width);
+    if (is_signed) {
+      bits ^= uint64_t{1} << (width * 8 - 1);
+    }
+    for (size_t i = 0; i < width; i++) {
+      data_[size_ + i] = static_cast<char>(bits >> ((width - 1 - i) * 8));
+    }
+    size_ += static_cast<uint16_t>(width);
+  }
+
+  /**
+   * Append a string column. Zero bytes are escaped as 00 FF and the string ends with 00 00, so that a string orders
+   * before every string it is a prefix of, whatever columns follow. Takes at most 2 * size + 2 bytes.
+   */
+  inline void AppendString(const char *data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+      data_[size_++] = data[i];
+      if (data[i] == '\0') {
+        data_[size_++] = static_cast<char>(0xFF);
+      }
+    }
+    data_[size_++] = '\0';
+    data_[size_++] = '\0';
+  }
+
+  /** Keep only the first size bytes. */
+  inline void Truncate(size_t size) { size_ = static_cast<uint16_t>(std::min<size_t>(size_, size)); }
+
+  /** @return the length of the longest common prefix of the two keys */
+  inline auto CommonPrefix(const NormalizedKey &that) const -> size_t {
+    size_t size = std::min(size_, that.size_);
+    size_t i = 0;
+    while (i < size && data_[i] == that.data_[i]) {
+      i++;
+    }
+    return i;
+  }
+
+  /** @return a negative number, 0 or a positive number as this key orders before, with or after that */
+  inline auto Compare(const NormalizedKey &that) const -> int {
+    int cmp = memcmp(data_, that.data_, std::min(size_, that.size_));
+    return cmp != 0 ? cmp : static_cast<int>(size_) - static_cast<int>(that.size_);
+  }
+
+  inline auto operator==(const NormalizedKey &that) const -> bool { return Compare(that) == 0; }
+
+  // NOTE: for debug purpose only
+  // print the bytes in hex
+  friend auto operator<<(std::ostream &os, const NormalizedKey &key) -> std::ostream & {
+    std::ios_base::fmtflags flags(os.flags());
+    os << std::hex << std::setfill('0');
+    for (size_t i = 0; i < key.size_; i++) {
+      os << std::setw(2) << static_cast<int>(static_cast<uint8_t>(key.data_[i]));
+    }
+    os.flags(flags);
+    return os;
+  }
+
+ private:
+  uint16_t size_{0};
+  char data_[KeySize];
+};
+
 /**
  * Function object returns true if lhs < rhs, used for trees
  */
 template <size_t KeySize>
 class GenericComparator {
  public:
+  using NormalizedKeyType = NormalizedKey<KeySize>;
+
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    switch (integer_key_width_) {
+      case sizeof(int32_t):
+        return CompareIntegers<int32_t>(lhs, rhs);
+      case sizeof(int64_t):
+        return CompareIntegers<int64_t>(lhs, rhs);
+      default:
+        break;
+    }
     uint32_t column_count = key_schema_->GetColumnCount();
 
     for (uint32_t i = 0; i < column_count; i++) {
@@ -94,13 +201,77 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  /**
+   * @return the width of the key if it is a single INTEGER or BIGINT column, which is compared as the integer stored
+   * at the start of the key; 0 otherwise. NULL, stored as the smallest value of the type, then orders first.
+   */
+  inline auto IntegerKeyWidth() const -> size_t { return integer_key_width_; }
+
+  /**
+   * @return true if two keys compare equal exactly when their bytes are equal, which holds when every key column is
+   * an integer type: SetFromKey() zero fills the key, and each integer value has a single encoding
+   */
+  inline auto HasBitwiseEquality() const -> bool { return bitwise_equality_; }
+
+  /** @return true if keys can be normalized, which holds for the same integer key columns as bitwise equality */
+  inline auto CanNormalize() const -> bool { return bitwise_equality_; }
+
+  /**
+   * Encode key so that memcmp orders the encodings as this comparator orders the keys: the key columns are written one
+   * after the other, big-endian, with the sign bit of signed integers flipped. Only valid if CanNormalize(). NULLs,
+   * which compare equal to anything here, are encoded as the smallest value of their type.
+   */
+  inline auto Normalize(const GenericKey<KeySize> &key) const -> NormalizedKey<KeySize> {
+    NormalizedKey<KeySize> normalized;
+    for (const auto &column : key_schema_->GetColumns()) {
+      normalized.AppendInteger(key.data_ + column.GetOffset(), Type::GetTypeSize(column.GetType()),
+                               column.GetType() != TypeId::TIMESTAMP);
+    }
+    return normalized;
+  }
+
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_},
+        bitwise_equality_{other.bitwise_equality_},
+        integer_key_width_{other.integer_key_width_} {}
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {
+    for (const auto &column : key_schema_->GetColumns()) {
+      switch (column.GetType()) {
+        case TypeId::BOOLEAN:
+        case TypeId::TINYINT:
+        case TypeId::SMALLINT:
+        case TypeId::INTEGER:
+        case TypeId::BIGINT:
+        case TypeId::TIMESTAMP:
+          break;
+        default:
+          bitwise_equality_ = false;
+      }
+    }
+    if (key_schema_->GetColumnCount() == 1) {
+      TypeId type = key_schema_->GetColumn(0).GetType();
+      if ((type == TypeId::INTEGER && KeySize >= sizeof(int32_t)) ||
+          (type == TypeId::BIGINT && KeySize >= sizeof(int64_t))) {
+        integer_key_width_ = Type::GetTypeSize(type);
+      }
+    }
+  }
 
  private:
+  template <typename Integer>
+  inline auto CompareIntegers(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    Integer lhs_value;
+    Integer rhs_value;
+    memcpy(&lhs_value, lhs.data_, sizeof(Integer));
+    memcpy(&rhs_value, rhs.data_, sizeof(Integer));
+    return (lhs_value > rhs_value) - (lhs_value < rhs_value);
+  }
+
   Schema *key_schema_;
+  bool bitwise_equality_{true};
+  size_t integer_key_width_{0};
 };
 
 }  // namespace bustub
@@ -18,6 +18,8 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/config.h"
+#include "common/exception.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -32,6 +34,11 @@ class Transaction;
  * index, since the external callers does not know the actual structure of
  * the index key, so it is the index's responsibility to maintain such a
  * mapping relation and does the conversion between tuple key and index key
+ *
+ * A covering index also stores the values of included columns with each key.
+ * They are not part of the key: keys are compared on the key attributes only.
+ * The entries of such an index hold the key attributes followed by the included
+ * ones, laid out by the entry schema, which is the key schema if there are none.
  */
 class IndexMetadata {
  public:
@@ -43,11 +50,18 @@ class IndexMetadata {
    * @param table_name The name of the table on which the index is created
    * @param tuple_schema The schema of the indexed key
    * @param key_attrs The mapping from indexed columns to base table columns
+   * @param include_attrs The base table columns whose values are stored along with the keys
    */
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, const std::vector<uint32_t> &include_attrs = {})
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        include_attrs_(include_attrs) {
     key_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, key_attrs_));
+    entry_attrs_ = key_attrs_;
+    entry_attrs_.insert(entry_attrs_.end(), include_attrs_.begin(), include_attrs_.end());
+    entry_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, entry_attrs_));
   }
 
   ~IndexMetadata() = default;
@@ -72,6 +86,15 @@ class IndexMetadata {
   /** @return The mapping relation between indexed columns and base table columns */
   inline auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return key_attrs_; }
 
+  /** @return The base table columns stored along with the keys, empty unless the index is covering */
+  inline auto GetIncludeAttrs() const -> const std::vector<uint32_t> & { return include_attrs_; }
+
+  /** @return The base table columns of an entry: the key attributes followed by the included ones */
+  inline auto GetEntryAttrs() const -> const std::vector<uint32_t> & { return entry_attrs_; }
+
+  /** @return A schema object pointer that represents the stored entries */
+  inline auto GetEntrySchema() const -> Schema * { return entry_schema_.get(); }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -94,6 +117,12 @@ class IndexMetadata {
   const std::vector<uint32_t> key_attrs_;
   /** The schema of the indexed key */
   std::shared_ptr<Schema> key_schema_;
+  /** The base table columns stored along with the keys */
+  const std::vector<uint32_t> include_attrs_;
+  /** The key attributes followed by the included ones */
+  std::vector<uint32_t> entry_attrs_;
+  /** The schema of the stored entries */
+  std::shared_ptr<Schema> entry_schema_;
 };
 
 /////////////////////////////////////////////////////////////////////
@@ -139,6 +168,21 @@ class Index {
   /** @return The index key attributes */
   auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetKeyAttrs(); }
 
+  /** @return The index entry schema */
+  auto GetEntrySchema() const -> Schema * { return metadata_->GetEntrySchema(); }
+
+  /** @return The index entry attributes */
+  auto GetEntryAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetEntryAttrs(); }
+
+  /** @return The included attributes of a covering index */
+  auto GetIncludeAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetIncludeAttrs(); }
+
+  /**
+   * @return The page to open the index again from, once it is in the database file; INVALID_PAGE_ID for an index
+   * that finds its pages by itself, as a B+ tree does through the header page
+   */
+  virtual auto GetFirstPageId() const -> page_id_t { return INVALID_PAGE_ID; }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -153,7 +197,7 @@ class Index {
 
   /**
    * Insert an entry into the index.
-   * @param key The index key
+   * @param key The index entry, laid out by the entry schema: the key and the included columns, if any
    * @param rid The RID associated with the key
    * @param transaction The transaction context
    */
@@ -175,6 +219,30 @@ class Index {
    */
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  /**
+   * Search the index for the keys in [lo, hi], in key order. Only indexes that keep their keys ordered support it.
+   * @param lo The smallest index key, nullptr for no lower bound
+   * @param hi The largest index key, nullptr for no upper bound
+   * @param reverse Whether to return the keys in descending order, starting at hi
+   * @param limit The most RIDs to return
+   * @param result The collection of RIDs that is populated with results of the search
+   * @param transaction The transaction context
+   */
+  virtual void ScanRange(const Tuple *lo, const Tuple *hi, bool reverse, size_t limit, std::vector<RID> *result,
+                         Transaction *transaction) {
+    throw NotImplementedException("range scan is not supported by this index");
+  }
+
+  /**
+   * Search the index like ScanRange(), but return the stored entries along with their RIDs, so that the values of
+   * the key and included columns can be read without fetching the tuples.
+   * @param result The collection of entries, laid out by the entry schema, and their RIDs
+   */
+  virtual void ScanRangeEntries(const Tuple *lo, const Tuple *hi, bool reverse, size_t limit,
+                                std::vector<std::pair<Tuple, RID>> *result, Transaction *transaction) {
+    throw NotImplementedException("range scan is not supported by this index");
+  }
+
  private:
   /** The Index structure owns its metadata */
   std::unique_ptr<IndexMetadata> metadata_;
@@ -13,31 +13,82 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <functional>
+#include <utility>
+
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
-#define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
+#define INDEXITERATOR_TEMPLATE_ARGUMENTS \
+  template <typename KeyType, typename ValueType, typename KeyComparator, typename LeafPage>
+#define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator, LeafPage>
 
-INDEX_TEMPLATE_ARGUMENTS
+/**
+ * IndexIterator walks the leaf level of a B+ tree, from left to right with operator++ and from right to left with
+ * operator--. It keeps the current leaf pinned and read-latched and moves to a neighbouring leaf only after releasing
+ * the latch on the current one, so writers that latch a leaf and then its sibling cannot deadlock with it. An iterator
+ * that has run past the last or the first entry equals End().
+ *
+ * Moving left, the previous leaf may be split or merged in the moment no latch is held. The iterator then finds its
+ * way back by key through the tree, with the LocateFunction the tree gave it.
+ *
+ * LeafPage is the leaf page type of the tree. Dereferencing yields what its GetItem() does: a reference into the page
+ * for BPlusTreeLeafPage, a copy for BPlusTreeSlottedLeafPage.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator,
+          typename LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>
 class IndexIterator {
  public:
-  // you may define your own constructor based on your member variables
+  using ReferenceType = decltype(std::declval<const LeafPage &>().GetItem(0));
+  /** Finds the read-latched leaf for a key and the index of the first entry in it that is not less than the key. */
+  using LocateFunction = std::function<std::pair<ReadPageGuard, int>(const KeyType &)>;
+
+  /** Create an iterator at the end of the tree. */
   IndexIterator();
+  /**
+   * Create an iterator positioned at an entry of a leaf.
+   * @param bpm the buffer pool manager of the tree
+   * @param guard the read guard of the leaf
+   * @param index position inside the leaf, may be GetSize() to start at the next leaf
+   * @param locate how to find a leaf of the tree by key, needed to move left with operator--
+   */
+  IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index, LocateFunction locate = {});
   ~IndexIterator();  // NOLINT
 
+  IndexIterator(const IndexIterator &) = delete;
+  auto operator=(const IndexIterator &) -> IndexIterator & = delete;
+  IndexIterator(IndexIterator &&that) noexcept;
+  auto operator=(IndexIterator &&that) noexcept -> IndexIterator &;
+
   auto IsEnd() -> bool;
 
-  auto operator*() -> const MappingType &;
+  auto operator*() -> ReferenceType;
 
   auto operator++() -> IndexIterator &;
 
-  auto operator==(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator--() -> IndexIterator &;
 
-  auto operator!=(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator==(const IndexIterator &itr) const -> bool { return leaf_ == itr.leaf_ && index_ == itr.index_; }
+
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  /** Skip to the next non-empty leaf if the iterator is past the end of the current one. */
+  void SkipExhaustedLeaves();
+
+  /** Move to the last entry less than key, which is the first key of the current leaf, in the leaves before it. */
+  void StepBack(const KeyType &key);
+
+  /** Unlatch and unpin the current leaf. */
+  void Release();
+
+  BufferPoolManager *bpm_{nullptr};
+  ReadPageGuard guard_;
+  const LeafPage *leaf_{nullptr};
+  int index_{0};
+  LocateFunction locate_;
 };
 
 }  // namespace bustub
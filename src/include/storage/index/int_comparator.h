@@ -29,5 +29,8 @@ class IntComparator {
     }
     return 0;
   }
+
+  /** @return true, two ints compare equal exactly when their bytes are equal */
+  inline auto HasBitwiseEquality() const -> bool { return true; }
 };
 }  // namespace bustub
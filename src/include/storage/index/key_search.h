@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_search.h
+//
+// Identification: src/include/storage/index/key_search.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+/**
+ * Binary search over the sorted (key, value) entries of a B+ tree page, comparing through the comparator.
+ */
+template <typename KeyType, typename KeyComparator>
+struct ComparatorKeySearch {
+  /** @return the first index in [begin, end) whose key is >= key, or end if there is none */
+  template <typename Entry>
+  static auto LowerBound(const Entry *entries, int begin, int end, const KeyType &key, const KeyComparator &comparator)
+      -> int {
+    while (begin < end) {
+      int mid = begin + (end - begin) / 2;
+      if (comparator(entries[mid].first, key) < 0) {
+        begin = mid + 1;
+      } else {
+        end = mid;
+      }
+    }
+    return begin;
+  }
+
+  /** @return the first index in [begin, end) whose key is > key, or end if there is none */
+  template <typename Entry>
+  static auto UpperBound(const Entry *entries, int begin, int end, const KeyType &key, const KeyComparator &comparator)
+      -> int {
+    while (begin < end) {
+      int mid = begin + (end - begin) / 2;
+      if (comparator(entries[mid].first, key) <= 0) {
+        begin = mid + 1;
+      } else {
+        end = mid;
+      }
+    }
+    return begin;
+  }
+};
+
+/**
+ * The search B+ tree pages use to find a key among their entries. It is specialized for key types that can be
+ * searched without going through the comparator.
+ */
+template <typename KeyType, typename KeyComparator>
+struct KeySearch : ComparatorKeySearch<KeyType, KeyComparator> {};
+
+/**
+ * For a GenericKey of a single INTEGER or BIGINT column, see GenericComparator::IntegerKeyWidth(), the search reads
+ * the integers straight out of the keys and halves the range without branching on the comparison, which compiles to
+ * conditional moves. Other key schemas fall back to the comparator.
+ */
+template <size_t KeySize>
+struct KeySearch<GenericKey<KeySize>, GenericComparator<KeySize>> {
+  using Fallback = ComparatorKeySearch<GenericKey<KeySize>, GenericComparator<KeySize>>;
+
+  template <typename Entry>
+  static auto LowerBound(const Entry *entries, int begin, int end, const GenericKey<KeySize> &key,
+                         const GenericComparator<KeySize> &comparator) -> int {
+    switch (comparator.IntegerKeyWidth()) {
+      case sizeof(int32_t):
+        return IntegerSearch<int32_t, false>(entries, begin, end, key);
+      case sizeof(int64_t):
+        return IntegerSearch<int64_t, false>(entries, begin, end, key);
+      default:
+        return Fallback::LowerBound(entries, begin, end, key, comparator);
+    }
+  }
+
+  template <typename Entry>
+  static auto UpperBound(const Entry *entries, int begin, int end, const GenericKey<KeySize> &key,
+                         const GenericComparator<KeySize> &comparator) -> int {
+    switch (comparator.IntegerKeyWidth()) {
+      case sizeof(int32_t):
+        return IntegerSearch<int32_t, true>(entries, begin, end, key);
+      case sizeof(int64_t):
+        return IntegerSearch<int64_t, true>(entries, begin, end, key);
+      default:
+        return Fallback::UpperBound(entries, begin, end, key, comparator);
+    }
+  }
+
+ private:
+  template <typename Integer>
+  static auto Load(const GenericKey<KeySize> &key) -> Integer {
+    Integer value;
+    memcpy(&value, key.data_, sizeof(Integer));
+    return value;
+  }
+
+  /**
+   * Keep a window [base, base + size] that holds the answer and halve it each step. Whether the window moves up only
+   * decides how far base moves, so there is no branch to mispredict.
+   * @return the first index in [begin, end) whose key is > key if upper, >= key otherwise, or end
+   */
+  template <typename Integer, bool Upper, typename Entry>
+  static auto IntegerSearch(const Entry *entries, int begin, int end, const GenericKey<KeySize> &key) -> int {
+    if (begin >= end) {
+      return begin;
+    }
+    const Integer target = Load<Integer>(key);
+    auto before = [target](Integer value) { return Upper ? value <= target : value < target; };
+    int base = begin;
+    int size = end - begin;
+    while (size > 1) {
+      int half = size / 2;
+      base += before(Load<Integer>(entries[base + half].first)) ? half : 0;
+      size -= half;
+    }
+    return base + (before(Load<Integer>(entries[base].first)) ? 1 : 0);
+  }
+};
+
+}  // namespace bustub
@@ -0,0 +1,214 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_key.h
+//
+// Identification: src/include/storage/index/varlen_key.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <ios>
+#include <string>
+#include <type_traits>
+
+#include "common/exception.h"
+#include "storage/index/generic_key.h"
+#include "storage/table/tuple.h"
+#include "type/type_util.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Variable length key, for key schemas with VARCHAR columns or several columns.
+ *
+ * The key holds the serialized key tuple: the inlined columns at their schema offsets, followed by the VARCHAR
+ * values, each a 4-byte length and the characters, which their inlined part points at by offset. Only the first
+ * Size() bytes are meaningful, and slotted B+ tree leaf pages store only those. Keys longer than MaxSize are rejected
+ * instead of truncated.
+ */
+template <size_t MaxSize>
+class VarlenKey {
+ public:
+  inline void SetFromKey(const Tuple &tuple) {
+    if (tuple.GetLength() > MaxSize) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "index key is longer than " + std::to_string(MaxSize) + " bytes");
+    }
+    Assign(tuple.GetData(), tuple.GetLength());
+  }
+
+  // NOTE: for test purpose only
+  inline void SetFromInteger(int64_t key) { Assign(reinterpret_cast<const char *>(&key), sizeof(int64_t)); }
+
+  /** Set the key to size serialized bytes, as stored in a page. */
+  inline void Assign(const char *data, size_t size) {
+    size_ = static_cast<uint16_t>(size);
+    memcpy(data_, data, size);
+  }
+
+  inline auto Size() const -> size_t { return size_; }
+
+  inline auto Data() const -> const char * { return data_; }
+
+  inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
+    const auto &col = schema->GetColumn(column_idx);
+    if (col.IsInlined()) {
+      return Value::DeserializeFrom(data_ + col.GetOffset(), col.GetType());
+    }
+    uint32_t offset;
+    memcpy(&offset, data_ + col.GetOffset(), sizeof(uint32_t));
+    return Value::DeserializeFrom(data_ + offset, col.GetType());
+  }
+
+  /**
+   * Find the characters of a VARCHAR column, leaving out the terminating zero. Offsets and lengths are clamped to the
+   * key, so that a key read from a page that is being written never leads outside of it.
+   * @return false if the value is NULL
+   */
+  inline auto StringAt(const Column &column, const char **data, size_t *size) const -> bool {
+    const size_t limit = std::min<size_t>(size_, MaxSize);
+    uint32_t offset;
+    memcpy(&offset, data_ + column.GetOffset(), sizeof(uint32_t));
+    if (offset + sizeof(uint32_t) > limit) {
+      *data = data_;
+      *size = 0;
+      return true;
+    }
+    uint32_t length;
+    memcpy(&length, data_ + offset, sizeof(uint32_t));
+    if (length == BUSTUB_VALUE_NULL) {
+      return false;
+    }
+    *data = data_ + offset + sizeof(uint32_t);
+    *size = std::min<size_t>(length == 0 ? 0 : length - 1, limit - offset - sizeof(uint32_t));
+    return true;
+  }
+
+  // NOTE: for debug purpose only
+  // print the serialized bytes in hex
+  friend auto operator<<(std::ostream &os, const VarlenKey &key) -> std::ostream & {
+    std::ios_base::fmtflags flags(os.flags());
+    os << std::hex << std::setfill('0');
+    for (size_t i = 0; i < key.size_; i++) {
+      os << std::setw(2) << static_cast<int>(static_cast<uint8_t>(key.data_[i]));
+    }
+    os.flags(flags);
+    return os;
+  }
+
+ private:
+  uint16_t size_{0};
+  char data_[MaxSize];
+};
+
+/** IsVarlenKey<KeyType>::value is true for VarlenKey, which B+ trees keep in slotted leaf pages. */
+template <typename KeyType>
+struct IsVarlenKey : std::false_type {};
+
+template <size_t MaxSize>
+struct IsVarlenKey<VarlenKey<MaxSize>> : std::true_type {};
+
+/**
+ * Function object that compares VarlenKeys column by column on their serialized encoding. Inlined columns compare as
+ * Values; VARCHAR columns compare their characters in place, the way VarlenType does, without copying them out.
+ */
+template <size_t MaxSize>
+class VarlenComparator {
+ public:
+  /** A normalized key takes at most twice the bytes of the key: a VARCHAR takes twice its characters plus two. */
+  using NormalizedKeyType = NormalizedKey<2 * MaxSize>;
+
+  inline auto operator()(const VarlenKey<MaxSize> &lhs, const VarlenKey<MaxSize> &rhs) const -> int {
+    uint32_t column_count = key_schema_->GetColumnCount();
+    for (uint32_t i = 0; i < column_count; i++) {
+      const auto &column = key_schema_->GetColumn(i);
+      if (column.IsInlined()) {
+        Value lhs_value = lhs.ToValue(key_schema_, i);
+        Value rhs_value = rhs.ToValue(key_schema_, i);
+        if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
+          return -1;
+        }
+        if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
+          return 1;
+        }
+        continue;
+      }
+      const char *lhs_data;
+      const char *rhs_data;
+      size_t lhs_size;
+      size_t rhs_size;
+      // NULL compares equal to anything, as it does for Values
+      if (!lhs.StringAt(column, &lhs_data, &lhs_size) || !rhs.StringAt(column, &rhs_data, &rhs_size)) {
+        continue;
+      }
+      int cmp = TypeUtil::CompareStrings(lhs_data, static_cast<int>(lhs_size), rhs_data, static_cast<int>(rhs_size));
+      if (cmp != 0) {
+        return cmp < 0 ? -1 : 1;
+      }
+    }
+    // equals
+    return 0;
+  }
+
+  /** @return true if keys can be normalized, which holds if every key column is an integer type or a VARCHAR */
+  inline auto CanNormalize() const -> bool { return can_normalize_; }
+
+  /**
+   * Encode key so that memcmp orders the encodings as this comparator orders the keys, see
+   * GenericComparator::Normalize(). VARCHARs are encoded by NormalizedKey::AppendString(), NULL ones as the empty
+   * string. Only valid if CanNormalize().
+   */
+  inline auto Normalize(const VarlenKey<MaxSize> &key) const -> NormalizedKeyType {
+    NormalizedKeyType normalized;
+    for (const auto &column : key_schema_->GetColumns()) {
+      if (column.IsInlined()) {
+        normalized.AppendInteger(key.Data() + column.GetOffset(), Type::GetTypeSize(column.GetType()),
+                                 column.GetType() != TypeId::TIMESTAMP);
+        continue;
+      }
+      const char *data = nullptr;
+      size_t size = 0;
+      if (!key.StringAt(column, &data, &size)) {
+        size = 0;
+      }
+      normalized.AppendString(data, size);
+    }
+    return normalized;
+  }
+
+  VarlenComparator(const VarlenComparator &other)
+      : key_schema_{other.key_schema_}, can_normalize_{other.can_normalize_} {}
+
+  // constructor
+  explicit VarlenComparator(Schema *key_schema) : key_schema_(key_schema) {
+    for (const auto &column : key_schema_->GetColumns()) {
+      switch (column.GetType()) {
+        case TypeId::BOOLEAN:
+        case TypeId::TINYINT:
+        case TypeId::SMALLINT:
+        case TypeId::INTEGER:
+        case TypeId::BIGINT:
+        case TypeId::TIMESTAMP:
+        case TypeId::VARCHAR:
+          break;
+        default:
+          can_normalize_ = false;
+      }
+    }
+  }
+
+ private:
+  Schema *key_schema_;
+  bool can_normalize_{true};
+};
+
+}  // namespace bustub
@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_compressed_internal_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_compressed_internal_page.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE BPlusTreeCompressedInternalPage<KeyType, ValueType, KeyComparator>
+#define COMPRESSED_INTERNAL_PAGE_HEADER_SIZE 28
+#define COMPRESSED_INTERNAL_PAGE_SIZE \
+  ((BUSTUB_PAGE_SIZE - COMPRESSED_INTERNAL_PAGE_HEADER_SIZE) / (sizeof(page_id_t) + sizeof(uint16_t)))
+
+/**
+ * An internal page that stores its separators compressed, for keys whose comparator can normalize them (see
+ * GenericComparator::Normalize()). It can stand in for BPlusTreeInternalPage in a BPlusTree.
+ *
+ * Separators are normalized keys, which compare with memcmp, and are suffix truncated: the separator pushed up when a
+ * leaf splits is the shortest prefix of the normalized first key of the right leaf that still orders after the last
+ * key of the left one. The prefix all separators of a page share is stored once. Lookup() compares the normalized
+ * search key against the prefix once and then against the stored suffixes; separators are never rebuilt to search.
+ *
+ * Entries take different space, so the page has room for a separator when its bytes fit, and it is underfull when it
+ * is both below min size and less than half full. Max size still caps the number of entries. Every change rewrites
+ * the page as a whole; internal pages only change on splits, merges and redistributions below them.
+ *
+ * Compressed internal page format (KEY(0), the invalid first key, is stored whole; the separators KEY(1) to KEY(n-1)
+ * share PREFIX, and only their SUFFIXes are stored):
+ *  -------------------------------------------------------------------------------------------------
+ * | HEADER | PrefixSize (2) | Unused (2) | PAGE_ID(0) | ... | PAGE_ID(n-1) | END(0) | ... | END(n-1) |
+ *  -------------------------------------------------------------------------------------------------
+ * | PREFIX | KEY(0) | SUFFIX(1) | ... | SUFFIX(n-1) |
+ *  -------------------------------------------------
+ * END(i) is the offset, from the start of PREFIX, at which the bytes of KEY(0) or SUFFIX(i) end.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeCompressedInternalPage : public BPlusTreePage {
+ public:
+  using SeparatorType = typename KeyComparator::NormalizedKeyType;
+
+  /** @return the separator to Lookup() key with */
+  static auto MakeProbe(const KeyType &key, const KeyComparator &comparator) -> SeparatorType {
+    return comparator.Normalize(key);
+  }
+
+  /** @return the separator of two neighbouring pages, given the last key of the left one and the first of the right */
+  static auto MakeSeparator(const KeyType &left, const KeyType &right, const KeyComparator &comparator)
+      -> SeparatorType;
+
+  // must call initialize method after "create" a new node
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = COMPRESSED_INTERNAL_PAGE_SIZE);
+
+  auto KeyAt(int index) const -> SeparatorType;
+  void SetKeyAt(int index, const SeparatorType &key);
+  auto ValueAt(int index) const -> ValueType;
+  void SetValueAt(int index, const ValueType &value);
+  auto ValueIndex(const ValueType &value) const -> int;
+
+  // lookup
+  auto Lookup(const SeparatorType &probe, const KeyComparator &comparator) const -> ValueType;
+
+  // insertion
+  void PopulateNewRoot(const ValueType &old_value, const SeparatorType &new_key, const ValueType &new_value);
+  auto InsertNodeAt(int index, const SeparatorType &new_key, const ValueType &new_value) -> int;
+
+  // removal
+  void Remove(int index);
+
+  // space management
+  auto IsInsertSafe() const -> bool;
+  auto IsRemoveSafe() const -> bool;
+  auto IsUnderfull() const -> bool;
+  auto CanInsertAt(int index, const SeparatorType &key) const -> bool;
+  auto CanSetKeyAt(int index, const SeparatorType &key) const -> bool;
+  auto SplitSize(int index, const SeparatorType &key) const -> int;
+  auto CanMerge(const BPlusTreeCompressedInternalPage *right, const SeparatorType &middle_key) const -> bool;
+  auto CanMoveFirstToEndOf(const BPlusTreeCompressedInternalPage *recipient, const SeparatorType &middle_key) const
+      -> bool;
+  auto CanMoveLastToFrontOf(const BPlusTreeCompressedInternalPage *recipient, const SeparatorType &middle_key) const
+      -> bool;
+  /** @return true if the page takes up at least fill_factor of its space */
+  auto IsFilledTo(double fill_factor) const -> bool;
+
+  // split, merge and redistribute; children that change page get their parent id updated through bpm
+  void MoveLatterHalfTo(BPlusTreeCompressedInternalPage *recipient, int start_index,
+                        BufferPoolManager *buffer_pool_manager);
+  void MoveAllTo(BPlusTreeCompressedInternalPage *recipient, const SeparatorType &middle_key,
+                 BufferPoolManager *buffer_pool_manager);
+  void MoveFirstToEndOf(BPlusTreeCompressedInternalPage *recipient, const SeparatorType &middle_key,
+                        BufferPoolManager *buffer_pool_manager);
+  void MoveLastToFrontOf(BPlusTreeCompressedInternalPage *recipient, const SeparatorType &middle_key,
+                         BufferPoolManager *buffer_pool_manager);
+
+ private:
+  using Entry = std::pair<SeparatorType, ValueType>;
+
+  /** Sizes of pages holding all entries but one, or the entries up to or from some index, without building them. */
+  class RangeSizes {
+   public:
+    explicit RangeSizes(const std::vector<Entry> &entries);
+
+    /** @return the size of a page holding entries [first, last), where first is 0 or last is the number of entries */
+    auto PageSize(size_t first, size_t last) const -> size_t;
+
+    /** @return the size of a page holding all entries but the separator at index */
+    auto PageSizeWithout(size_t index) const -> size_t;
+
+   private:
+    static auto PageSize(size_t num_entries, size_t first_key_size, size_t separators_size, size_t prefix_size)
+        -> size_t;
+
+    // the prefix separators 1 to i share; the prefix separators i to n-1 share; the key sizes of entries before i
+    std::vector<size_t> head_prefix_;
+    std::vector<size_t> tail_prefix_;
+    std::vector<size_t> key_sizes_;
+  };
+
+  /** @return the bytes a page holding entries takes up */
+  static auto EncodedSize(const std::vector<Entry> &entries) -> size_t;
+
+  /** @return the length of the prefix the separators of entries share */
+  static auto SharedPrefix(const std::vector<Entry> &entries) -> size_t;
+
+  /** @return true if a page holding entries would be underfull */
+  auto IsUnderfull(const std::vector<Entry> &entries) const -> bool;
+
+  /** @return true if entries fit into this page */
+  auto Fits(const std::vector<Entry> &entries) const -> bool;
+
+  /** @return all entries, with their separators decompressed */
+  auto Entries() const -> std::vector<Entry>;
+
+  /** Rewrite the page to hold entries, which have to fit. */
+  void Assign(const std::vector<Entry> &entries);
+
+  /** Append entries to the page, adopting their children. */
+  void Append(const std::vector<Entry> &entries, BufferPoolManager *buffer_pool_manager);
+
+  /** @return the bytes the page takes up */
+  auto UsedSize() const -> size_t;
+
+  auto Values() const -> const ValueType * { return reinterpret_cast<const ValueType *>(data_); }
+  auto Values() -> ValueType * { return reinterpret_cast<ValueType *>(data_); }
+  auto Ends() const -> const uint16_t * { return reinterpret_cast<const uint16_t *>(data_ + EndsOffset(GetSize())); }
+  auto Heap() const -> const char * { return data_ + HeapOffset(GetSize()); }
+
+  static auto EndsOffset(size_t size) -> size_t { return size * sizeof(ValueType); }
+  static auto HeapOffset(size_t size) -> size_t { return size * (sizeof(ValueType) + sizeof(uint16_t)); }
+
+  /**
+   * @return the stored bytes of KEY(0) or SUFFIX(index), setting *size to their length. Bounds are clamped to the
+   * page, so that a torn optimistic read never reads past it.
+   */
+  auto StoredBytes(int index, int size, size_t *length) const -> const char *;
+
+  uint16_t prefix_size_;
+  uint16_t unused_;
+  // Flexible array member for page data.
+  char data_[1];
+};
+
+}  // namespace bustub
@@ -31,18 +31,67 @@ namespace bustub {
  *  --------------------------------------------------------------------------
  * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
  *  --------------------------------------------------------------------------
+ *
+ * The tree reaches internal pages through SeparatorType and the space management methods below, which
+ * BPlusTreeCompressedInternalPage implements as well. Here separators are whole keys and space is counted in entries.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
  public:
+  using SeparatorType = KeyType;
+
+  /** @return the separator to Lookup() key with */
+  static auto MakeProbe(const KeyType &key, const KeyComparator &comparator) -> KeyType { return key; }
+
+  /** @return the separator of two neighbouring pages, given the last key of the left one and the first of the right */
+  static auto MakeSeparator(const KeyType &left, const KeyType &right, const KeyComparator &comparator) -> KeyType {
+    return right;
+  }
+
   // must call initialize method after "create" a new node
   void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE);
 
   auto KeyAt(int index) const -> KeyType;
   void SetKeyAt(int index, const KeyType &key);
   auto ValueAt(int index) const -> ValueType;
+  void SetValueAt(int index, const ValueType &value);
+  auto ValueIndex(const ValueType &value) const -> int;
+
+  // lookup
+  auto Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType;
+
+  // insertion
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+  auto InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value) -> int;
+  auto InsertNodeAt(int index, const KeyType &new_key, const ValueType &new_value) -> int;
+
+  // removal
+  void Remove(int index);
+
+  // space management
+  auto IsInsertSafe() const -> bool;
+  auto IsRemoveSafe() const -> bool;
+  auto IsUnderfull() const -> bool;
+  auto CanInsertAt(int index, const KeyType &key) const -> bool;
+  auto CanSetKeyAt(int index, const KeyType &key) const -> bool;
+  auto SplitSize(int index, const KeyType &key) const -> int;
+  auto CanMerge(const BPlusTreeInternalPage *right, const KeyType &middle_key) const -> bool;
+  auto CanMoveFirstToEndOf(const BPlusTreeInternalPage *recipient, const KeyType &middle_key) const -> bool;
+  auto CanMoveLastToFrontOf(const BPlusTreeInternalPage *recipient, const KeyType &middle_key) const -> bool;
+
+  // split, merge and redistribute; children that change page get their parent id updated through bpm
+  void MoveLatterHalfTo(BPlusTreeInternalPage *recipient, int start_index, BufferPoolManager *buffer_pool_manager);
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key, BufferPoolManager *buffer_pool_manager);
+  void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                        BufferPoolManager *buffer_pool_manager);
+  void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                         BufferPoolManager *buffer_pool_manager);
 
  private:
+  void CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager);
+  void CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
+  void CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
+
   // Flexible array member for page data.
   MappingType array_[1];
 };
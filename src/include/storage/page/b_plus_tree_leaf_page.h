@@ -18,7 +18,7 @@
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 28
+#define LEAF_PAGE_HEADER_SIZE 32
 #define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
 
 /**
@@ -31,13 +31,18 @@ namespace bustub {
  * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
  *  ----------------------------------------------------------------------
  *
- *  Header format (size in byte, 28 bytes in total):
+ *  Header format (size in byte, 32 bytes in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  -----------------------------------------------
- * | ParentPageId (4) | PageId (4) | NextPageId (4)
- *  -----------------------------------------------
+ *  ----------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | PrevPageId (4)
+ *  ----------------------------------------------------------------
+ *
+ * Leaves are linked both ways, so that the tree can be scanned in either order.
+ *
+ * The page is full at max size entries. The space management methods tell the tree when it is, so that it can use
+ * BPlusTreeSlottedLeafPage, whose entries differ in size, the same way.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
@@ -48,10 +53,37 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
+  auto GetPrevPageId() const -> page_id_t;
+  void SetPrevPageId(page_id_t prev_page_id);
   auto KeyAt(int index) const -> KeyType;
+  auto ValueAt(int index) const -> ValueType;
+  auto GetItem(int index) const -> const MappingType &;
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  // insert and delete methods
+  auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) -> int;
+  auto Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const -> bool;
+  auto RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) -> int;
+
+  // space management
+  auto IsInsertSafe() const -> bool;
+  auto IsRemoveSafe() const -> bool;
+  auto IsUnderfull() const -> bool;
+  auto CanInsert(const KeyType &key) const -> bool;
+  auto SplitSize(int index, const KeyType &key) const -> int;
+  auto CanMerge(const BPlusTreeLeafPage *right) const -> bool;
+  auto CanMoveFirstToEndOf(const BPlusTreeLeafPage *recipient) const -> bool;
+  auto CanMoveLastToFrontOf(const BPlusTreeLeafPage *recipient) const -> bool;
+
+  // split, merge and redistribute
+  void MoveLatterHalfTo(BPlusTreeLeafPage *recipient, int start_index);
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
  private:
   page_id_t next_page_id_;
+  page_id_t prev_page_id_;
   // Flexible array member for page data.
   MappingType array_[1];
 };
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_slotted_leaf_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_slotted_leaf_page.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE BPlusTreeSlottedLeafPage<KeyType, ValueType, KeyComparator>
+#define SLOTTED_LEAF_PAGE_HEADER_SIZE 36
+#define SLOTTED_LEAF_PAGE_SLOT_SIZE (2 * sizeof(uint16_t) + sizeof(ValueType))
+#define SLOTTED_LEAF_PAGE_SIZE \
+  ((BUSTUB_PAGE_SIZE - SLOTTED_LEAF_PAGE_HEADER_SIZE) / (SLOTTED_LEAF_PAGE_SLOT_SIZE + 1))
+
+/**
+ * A leaf page for variable length keys (see VarlenKey), which stores each key in as many bytes as it takes. It can
+ * stand in for BPlusTreeLeafPage in a BPlusTree; KeyType has to provide Size(), Data() and Assign(data, size).
+ *
+ * The slot array grows from the header towards the end of the page, and the keys grow from the end of the page
+ * towards the slots. A slot holds the offset and size of its key along with the value, and slots are kept in key
+ * order. Removing an entry only gives up its slot; the bytes of its key are reclaimed when an insert finds the free
+ * space between slots and keys too small and compacts the keys.
+ *
+ * Entries take different space, so the page is full when a new entry does not fit, and it is underfull when it is
+ * both below min size and less than half full. Max size still caps the number of entries.
+ *
+ * Slotted leaf page format:
+ *  ----------------------------------------------------------------------------------
+ * | HEADER | SLOT(0) | SLOT(1) | ... | SLOT(n-1) | free space | KEY(?) | ... | KEY(?) |
+ *  ----------------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 36 bytes in total):
+ *  -----------------------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) | ParentPageId (4) | PageId (4) |
+ *  -----------------------------------------------------------------------------------
+ *  ---------------------------------------------------------------------
+ * | NextPageId (4) | PrevPageId (4) | KeysBegin (2) | FreeKeyBytes (2) |
+ *  ---------------------------------------------------------------------
+ *  Slot format: | KeyOffset (2) | KeySize (2) | Value |
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeSlottedLeafPage : public BPlusTreePage {
+ public:
+  // After creating a new leaf page from buffer pool, must call initialize
+  // method to set default values
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = SLOTTED_LEAF_PAGE_SIZE);
+  // helper methods
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+  auto GetPrevPageId() const -> page_id_t;
+  void SetPrevPageId(page_id_t prev_page_id);
+  auto KeyAt(int index) const -> KeyType;
+  auto ValueAt(int index) const -> ValueType;
+  /** @return a copy of the entry at index; unlike a fixed size one, it does not exist in the page as such */
+  auto GetItem(int index) const -> MappingType;
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  // insert and delete methods
+  auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) -> int;
+  auto Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const -> bool;
+  auto RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) -> int;
+
+  // space management
+  auto IsInsertSafe() const -> bool;
+  auto IsRemoveSafe() const -> bool;
+  auto IsUnderfull() const -> bool;
+  auto CanInsert(const KeyType &key) const -> bool;
+  auto SplitSize(int index, const KeyType &key) const -> int;
+  auto CanMerge(const BPlusTreeSlottedLeafPage *right) const -> bool;
+  auto CanMoveFirstToEndOf(const BPlusTreeSlottedLeafPage *recipient) const -> bool;
+  auto CanMoveLastToFrontOf(const BPlusTreeSlottedLeafPage *recipient) const -> bool;
+  /** @return true if the page takes up at least fill_factor of its space */
+  auto IsFilledTo(double fill_factor) const -> bool;
+
+  // split, merge and redistribute
+  void MoveLatterHalfTo(BPlusTreeSlottedLeafPage *recipient, int start_index);
+  void MoveAllTo(BPlusTreeSlottedLeafPage *recipient);
+  void MoveFirstToEndOf(BPlusTreeSlottedLeafPage *recipient);
+  void MoveLastToFrontOf(BPlusTreeSlottedLeafPage *recipient);
+
+ private:
+  struct Slot {
+    uint16_t offset_;
+    uint16_t size_;
+    ValueType value_;
+  };
+  static_assert(sizeof(Slot) == SLOTTED_LEAF_PAGE_SLOT_SIZE, "slots are packed");
+
+  /** @return the bytes of the key at index */
+  auto KeyData(int index) const -> const char * { return reinterpret_cast<const char *>(this) + slots_[index].offset_; }
+
+  /** @return the bytes the page takes up */
+  auto UsedSize() const -> size_t;
+
+  /** @return the bytes left for entries, counting the ones of removed keys */
+  auto FreeSize() const -> size_t { return BUSTUB_PAGE_SIZE - UsedSize(); }
+
+  /** @return the size of the entry at index */
+  auto EntrySize(int index) const -> size_t { return sizeof(Slot) + slots_[index].size_; }
+
+  /** Insert an entry at index, which has to fit. */
+  void InsertAt(int index, const char *key_data, size_t key_size, const ValueType &value);
+
+  /** Remove the entry at index. */
+  void RemoveAt(int index);
+
+  /** Move the keys to the end of the page, so that the free space is all between slots and keys. */
+  void Compact();
+
+  page_id_t next_page_id_;
+  page_id_t prev_page_id_;
+  uint16_t keys_begin_;
+  uint16_t free_key_bytes_;
+  // Flexible array member for page data.
+  Slot slots_[1];
+};
+
+}  // namespace bustub
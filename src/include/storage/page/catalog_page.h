@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// catalog_page.h
+//
+// Identification: src/include/storage/page/catalog_page.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * The pages of the catalog form a chain that starts at CATALOG_PAGE_ID. Together they hold the catalog, serialized by
+ * Catalog: each page holds the next Size() bytes of it.
+ *
+ * Format (size in byte):
+ *  ------------------------------------------------
+ * | NextPageId (4) | Size (4) | Data (up to 4088) |
+ *  ------------------------------------------------
+ */
+class CatalogPage {
+ public:
+  /** The most bytes of the catalog a page holds. */
+  static constexpr size_t CAPACITY = BUSTUB_PAGE_SIZE - sizeof(page_id_t) - sizeof(uint32_t);
+
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    size_ = 0;
+  }
+
+  /** @return the next page of the chain, INVALID_PAGE_ID if this is the last one */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /** @return the number of bytes of the catalog this page holds */
+  auto GetSize() const -> size_t { return size_; }
+
+  auto GetData() const -> const char * { return data_; }
+
+  /** Hold the size bytes at data, at most CAPACITY of them. */
+  void SetData(const char *data, size_t size) {
+    size_ = static_cast<uint32_t>(size);
+    memcpy(data_, data, size);
+  }
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t size_;
+  char data_[CAPACITY];
+};
+
+static_assert(sizeof(CatalogPage) == BUSTUB_PAGE_SIZE);
+
+}  // namespace bustub
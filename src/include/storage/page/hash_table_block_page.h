@@ -93,6 +93,30 @@ class HashTableBlockPage {
    */
   auto IsReadable(slot_offset_t bucket_ind) const -> bool;
 
+  /**
+   * @return the first index in [from, to) that was never occupied, or to if all of them were
+   */
+  auto NextUnoccupied(slot_offset_t from, slot_offset_t to) const -> slot_offset_t;
+
+  /**
+   * @return the first readable index in [from, to), or to if there is none
+   */
+  auto NextReadable(slot_offset_t from, slot_offset_t to) const -> slot_offset_t;
+
+  /**
+   * Collects the values of the readable indexes in [from, to) that hold key.
+   *
+   * @return true if at least one key matched
+   */
+  auto GetValues(slot_offset_t from, slot_offset_t to, const KeyType &key, KeyComparator cmp,
+                 std::vector<ValueType> *result) const -> bool;
+
+  /**
+   * @return the readable index in [from, to) that holds the key and value, or to if there is none
+   */
+  auto FindPair(slot_offset_t from, slot_offset_t to, const KeyType &key, const ValueType &value,
+                KeyComparator cmp) const -> slot_offset_t;
+
   /**
    * Scan the bucket and collect values that have the matching key
    *
@@ -139,6 +163,10 @@ class HashTableBlockPage {
   void PrintBucket();
 
  private:
+  // the bitmaps are only scanned in bulk under the page latch, when nobody is flipping bits
+  auto Occupied() const -> const uint8_t * { return reinterpret_cast<const uint8_t *>(occupied_); }
+  auto Readable() const -> const uint8_t * { return reinterpret_cast<const uint8_t *>(readable_); }
+
   std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
 
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
@@ -45,7 +45,7 @@ class HashTableBucketPage {
    *
    * @return true if at least one key matched
    */
-  auto GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool;
+  auto GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) const -> bool;
 
   /**
    * Attempts to insert a key and value in the bucket.  Uses the occupied_
@@ -120,17 +120,17 @@ class HashTableBucketPage {
   /**
    * @return the number of readable elements, i.e. current size
    */
-  auto NumReadable() -> uint32_t;
+  auto NumReadable() const -> uint32_t;
 
   /**
    * @return whether the bucket is full
    */
-  auto IsFull() -> bool;
+  auto IsFull() const -> bool;
 
   /**
    * @return whether the bucket is empty
    */
-  auto IsEmpty() -> bool;
+  auto IsEmpty() const -> bool;
 
   /**
    * Prints the bucket's occupancy information
@@ -138,6 +138,12 @@ class HashTableBucketPage {
   void PrintBucket();
 
  private:
+  /** @return the number of slots that were ever occupied; they are always the first ones */
+  auto NumOccupied() const -> uint32_t;
+
+  auto Occupied() const -> const uint8_t * { return reinterpret_cast<const uint8_t *>(occupied_); }
+  auto Readable() const -> const uint8_t * { return reinterpret_cast<const uint8_t *>(readable_); }
+
   //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
   char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
@@ -82,20 +82,25 @@ class HashTableHeaderPage {
    * @param index the index of the block
    * @return the page_id for the block.
    */
-  auto GetBlockPageId(size_t index) -> page_id_t;
+  auto GetBlockPageId(size_t index) const -> page_id_t;
 
   /**
    * @return the number of blocks currently stored in the header page
    */
-  auto NumBlocks() -> size_t;
+  auto NumBlocks() const -> size_t;
+
+  /**
+   * @return the number of block page_ids a header page has room for
+   */
+  static auto MaxBlocks() -> size_t;
 
  private:
-  __attribute__((unused)) lsn_t lsn_;
-  __attribute__((unused)) size_t size_;
-  __attribute__((unused)) page_id_t page_id_;
-  __attribute__((unused)) size_t next_ind_;
+  lsn_t lsn_;
+  size_t size_;
+  page_id_t page_id_;
+  size_t next_ind_;
   // Flexible array member for page data.
-  __attribute__((unused)) page_id_t block_page_ids_[1];
+  page_id_t block_page_ids_[1];
 };
 
 }  // namespace bustub
@@ -0,0 +1,177 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_probe.h
+//
+// Identification: src/include/storage/page/hash_table_probe.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace bustub {
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "slot bitmaps are read a word at a time");
+
+/**
+ * HashTableProbe scans the slot bitmaps and key arrays of the hash table pages in bulk instead of slot by slot.
+ *
+ * Bitmaps keep the bit of slot i in bit i % 8 of byte i / 8. They are read 128 bits at a time with SSE2 to skip
+ * runs that hold nothing of interest, and 64 bits at a time otherwise. Keys of comparators that have bitwise
+ * equality are compared as bytes, and 4-byte keys four at a time with SSE2. Every path has a scalar fallback with
+ * the same result.
+ */
+class HashTableProbe {
+ public:
+  /** @return the first slot in [from, to) whose bit is set, or to if there is none */
+  static auto NextSetBit(const uint8_t *bitmap, size_t from, size_t to) -> size_t {
+    return NextBit<false>(bitmap, from, to);
+  }
+
+  /** @return the first slot in [from, to) whose bit is clear, or to if there is none */
+  static auto NextClearBit(const uint8_t *bitmap, size_t from, size_t to) -> size_t {
+    return NextBit<true>(bitmap, from, to);
+  }
+
+  /** @return the number of set bits in the first num_bytes bytes of bitmap */
+  static auto CountSetBits(const uint8_t *bitmap, size_t num_bytes) -> size_t {
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= num_bytes; i += 8) {
+      uint64_t word;
+      std::memcpy(&word, bitmap + i, 8);
+      count += __builtin_popcountll(word);
+    }
+    for (; i < num_bytes; i++) {
+      count += __builtin_popcount(bitmap[i]);
+    }
+    return count;
+  }
+
+  /** @return whether any of the first num_bytes bytes of bitmap has a bit set */
+  static auto AnySet(const uint8_t *bitmap, size_t num_bytes) -> bool {
+    return NextSetBit(bitmap, 0, num_bytes * 8) < num_bytes * 8;
+  }
+
+  /**
+   * Compares the 4-byte keys of four slots that are stride bytes apart against key.
+   *
+   * @param first the key of the first slot
+   * @return a mask with bit i set if the key of slot i equals key bitwise
+   */
+  static auto MatchKeys4(const char *first, size_t stride, uint32_t key) -> uint32_t {
+    uint32_t keys[4];
+    for (size_t i = 0; i < 4; i++) {
+      std::memcpy(&keys[i], first + i * stride, sizeof(uint32_t));
+    }
+#ifdef __SSE2__
+    const __m128i cmp = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys)),
+                                        _mm_set1_epi32(static_cast<int>(key)));
+    return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(cmp)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < 4; i++) {
+      mask |= static_cast<uint32_t>(keys[i] == key) << i;
+    }
+    return mask;
+#endif
+  }
+
+  /** @return whether two keys are equal, bitwise if the comparator allows it */
+  template <typename KeyType, typename KeyComparator>
+  static auto KeysEqual(const KeyType &lhs, const KeyType &rhs, const KeyComparator &cmp, bool bitwise) -> bool {
+    return bitwise ? std::memcmp(&lhs, &rhs, sizeof(KeyType)) == 0 : cmp(lhs, rhs) == 0;
+  }
+
+  /**
+   * Calls on_match(slot) for every slot in [from, to) whose readable bit is set and whose key equals key, in slot
+   * order, until on_match returns false.
+   *
+   * @param readable the readable bitmap of the page
+   * @param slots the (key, value) array of the page
+   */
+  template <typename SlotType, typename KeyType, typename KeyComparator, typename OnMatch>
+  static void ForEachMatch(const uint8_t *readable, const SlotType *slots, size_t from, size_t to,
+                           const KeyType &key, const KeyComparator &cmp, OnMatch &&on_match) {
+    const bool bitwise = cmp.HasBitwiseEquality();
+    size_t slot = NextSetBit(readable, from, to);
+    if constexpr (sizeof(KeyType) == sizeof(uint32_t)) {
+      if (bitwise) {
+        uint32_t probe;
+        std::memcpy(&probe, &key, sizeof(uint32_t));
+        while (slot < to) {
+          // the group starts at a readable slot, so sparse pages skip straight to their entries
+          const size_t group_end = std::min(slot + 4, to);
+          uint32_t matches = 0;
+          if (group_end - slot == 4) {
+            matches = MatchKeys4(reinterpret_cast<const char *>(&slots[slot].first), sizeof(SlotType), probe);
+          } else {
+            for (size_t i = slot; i < group_end; i++) {
+              matches |= static_cast<uint32_t>(std::memcmp(&slots[i].first, &probe, sizeof(uint32_t)) == 0)
+                         << (i - slot);
+            }
+          }
+          for (size_t i = slot; i < group_end; i++) {
+            const bool is_readable = ((readable[i / 8] >> (i % 8)) & 1) != 0;
+            if (is_readable && (matches & (1U << (i - slot))) != 0 && !on_match(i)) {
+              return;
+            }
+          }
+          slot = NextSetBit(readable, group_end, to);
+        }
+        return;
+      }
+    }
+    for (; slot < to; slot = NextSetBit(readable, slot + 1, to)) {
+      if (KeysEqual(slots[slot].first, key, cmp, bitwise) && !on_match(slot)) {
+        return;
+      }
+    }
+  }
+
+ private:
+  template <bool CLEAR>
+  static auto NextBit(const uint8_t *bitmap, size_t from, size_t to) -> size_t {
+    // bytes past the last one that holds a bit below to are never read
+    const size_t end_byte = (to + 7) / 8;
+    while (from < to) {
+      const size_t byte = from / 8;
+#ifdef __SSE2__
+      if (from % 8 == 0 && byte + 16 <= end_byte) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bitmap + byte));
+        const __m128i nothing = CLEAR ? _mm_set1_epi8(-1) : _mm_setzero_si128();
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, nothing)) == 0xFFFF) {
+          from += 128;
+          continue;
+        }
+      }
+#endif
+      const size_t num_bytes = std::min<size_t>(8, end_byte - byte);
+      uint64_t word = 0;
+      std::memcpy(&word, bitmap + byte, num_bytes);
+      if constexpr (CLEAR) {
+        word = ~word;
+      }
+      word >>= from % 8;
+      if (word != 0) {
+        return std::min(to, from + __builtin_ctzll(word));
+      }
+      from = (byte + num_bytes) * 8;
+    }
+    return to;
+  }
+};
+
+}  // namespace bustub
@@ -28,6 +28,9 @@ namespace bustub {
  */
 class HeaderPage : public Page {
  public:
+  /** The size of the name field of a record; names are shorter, to leave room for their terminating zero. */
+  static constexpr size_t NAME_SIZE = 32;
+
   void Init() { SetRecordCount(0); }
   /**
    * Record related
@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <thread>  // NOLINT
 
 #include "common/config.h"
 #include "common/rwlatch.h"
@@ -48,11 +50,17 @@ class Page {
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline auto IsDirty() -> bool { return is_dirty_; }
 
-  /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  /** Acquire the page write latch. Until it is released, the version is odd and optimistic reads fail. */
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.fetch_add(1);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.fetch_add(1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -60,6 +68,26 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /**
+   * Start an optimistic read of the page, waiting for a writer that holds the latch to finish first. The page data read
+   * afterwards may be torn by a concurrent writer; it can only be trusted once ValidateVersion() succeeds.
+   * @return the version to validate against
+   */
+  inline auto ReadVersion() -> uint64_t {
+    uint64_t version = version_.load(std::memory_order_acquire);
+    while ((version & 1) != 0) {
+      std::this_thread::yield();
+      version = version_.load(std::memory_order_acquire);
+    }
+    return version;
+  }
+
+  /** @return true if no writer has latched the page since ReadVersion() returned version */
+  inline auto ValidateVersion(uint64_t version) -> bool {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
   /** @return the page LSN. */
   inline auto GetLSN() -> lsn_t { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -88,6 +116,8 @@ class Page {
   bool is_dirty_ = false;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Bumped by every write latch and unlatch, odd while a writer holds the latch. */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
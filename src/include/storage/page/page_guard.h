@@ -0,0 +1,278 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard.h
+//
+// Identification: src/include/storage/page/page_guard.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "storage/page/page.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+class ReadPageGuard;
+class WritePageGuard;
+
+/**
+ * BasicPageGuard owns one pin on a page and unpins it when it goes out of scope, marking the page dirty if it was
+ * handed out for writing through GetDataMut() / AsMut() / AsPageMut(). Guards are move-only; the moved-from guard is
+ * empty. Get one from BufferPoolManager::FetchPageBasic() or NewPageGuarded().
+ */
+class BasicPageGuard {
+  friend class ReadPageGuard;
+  friend class WritePageGuard;
+
+ public:
+  BasicPageGuard() = default;
+
+  /**
+   * Take over a pin. Call sites are only tracked for guards made by the buffer pool manager.
+   * @param bpm the buffer pool manager the page was pinned in
+   * @param page the pinned page, may be nullptr for an empty guard
+   */
+  BasicPageGuard(BufferPoolManager *bpm, Page *page) : bpm_(bpm), page_(page) {}
+
+  BasicPageGuard(const BasicPageGuard &) = delete;
+  auto operator=(const BasicPageGuard &) -> BasicPageGuard & = delete;
+
+  BasicPageGuard(BasicPageGuard &&that) noexcept;
+  auto operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard &;
+
+  ~BasicPageGuard() { Drop(); }
+
+  /** Unpin the page. The guard is empty afterwards. */
+  void Drop();
+
+  /** Take the read latch and hand the pin over to a read guard. This guard is empty afterwards. */
+  auto UpgradeRead() -> ReadPageGuard;
+
+  /** Take the write latch and hand the pin over to a write guard. This guard is empty afterwards. */
+  auto UpgradeWrite() -> WritePageGuard;
+
+  /** @return true if the guard holds a page */
+  auto IsValid() const -> bool { return page_ != nullptr; }
+
+  auto PageId() const -> page_id_t { return page_->GetPageId(); }
+
+  auto GetData() const -> const char * { return page_->GetData(); }
+
+  auto GetDataMut() -> char * {
+    is_dirty_ = true;
+    return page_->GetData();
+  }
+
+  /** View the page data as a page layout type (e.g. a B+ tree page). */
+  template <class T>
+  auto As() const -> const T * {
+    return reinterpret_cast<const T *>(GetData());
+  }
+
+  template <class T>
+  auto AsMut() -> T * {
+    return reinterpret_cast<T *>(GetDataMut());
+  }
+
+  /** View the page as one of the Page subclasses (e.g. TablePage), whose accessors are not const. */
+  template <class T>
+  auto AsPage() -> T * {
+    return static_cast<T *>(page_);
+  }
+
+  template <class T>
+  auto AsPageMut() -> T * {
+    is_dirty_ = true;
+    return static_cast<T *>(page_);
+  }
+
+ private:
+  friend class BufferPoolManager;
+
+  BufferPoolManager *bpm_{nullptr};
+  Page *page_{nullptr};
+  bool is_dirty_{false};
+  /** Where the pin was taken, for the pin leak report of debug builds. */
+  const char *file_{nullptr};
+  int line_{0};
+};
+
+/**
+ * ReadPageGuard owns one pin and the read latch of a page, and releases both when it goes out of scope.
+ * Get one from BufferPoolManager::FetchPageRead().
+ */
+class ReadPageGuard {
+ public:
+  ReadPageGuard() = default;
+
+  /** Take over a pin and a read latch that are already held. */
+  ReadPageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {}
+
+  /** Take over the pin of a basic guard; the read latch must already be held. */
+  explicit ReadPageGuard(BasicPageGuard &&guard) : guard_(std::move(guard)) {}
+
+  ReadPageGuard(const ReadPageGuard &) = delete;
+  auto operator=(const ReadPageGuard &) -> ReadPageGuard & = delete;
+
+  ReadPageGuard(ReadPageGuard &&that) noexcept = default;
+  auto operator=(ReadPageGuard &&that) noexcept -> ReadPageGuard &;
+
+  ~ReadPageGuard() { Drop(); }
+
+  /** Release the read latch and unpin the page. The guard is empty afterwards. */
+  void Drop();
+
+  auto IsValid() const -> bool { return guard_.IsValid(); }
+
+  auto PageId() const -> page_id_t { return guard_.PageId(); }
+
+  auto GetData() const -> const char * { return guard_.GetData(); }
+
+  template <class T>
+  auto As() const -> const T * {
+    return guard_.As<T>();
+  }
+
+  template <class T>
+  auto AsPage() -> T * {
+    return guard_.AsPage<T>();
+  }
+
+ private:
+  BasicPageGuard guard_;
+};
+
+/**
+ * WritePageGuard owns one pin and the write latch of a page, and releases both when it goes out of scope. The page is
+ * unpinned dirty if its data was handed out for writing. Get one from BufferPoolManager::FetchPageWrite().
+ */
+class WritePageGuard {
+ public:
+  WritePageGuard() = default;
+
+  /** Take over a pin and a write latch that are already held. */
+  WritePageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {}
+
+  /** Take over the pin of a basic guard; the write latch must already be held. */
+  explicit WritePageGuard(BasicPageGuard &&guard) : guard_(std::move(guard)) {}
+
+  WritePageGuard(const WritePageGuard &) = delete;
+  auto operator=(const WritePageGuard &) -> WritePageGuard & = delete;
+
+  WritePageGuard(WritePageGuard &&that) noexcept = default;
+  auto operator=(WritePageGuard &&that) noexcept -> WritePageGuard &;
+
+  ~WritePageGuard() { Drop(); }
+
+  /** Release the write latch and unpin the page. The guard is empty afterwards. */
+  void Drop();
+
+  auto IsValid() const -> bool { return guard_.IsValid(); }
+
+  auto PageId() const -> page_id_t { return guard_.PageId(); }
+
+  auto GetData() const -> const char * { return guard_.GetData(); }
+
+  auto GetDataMut() -> char * { return guard_.GetDataMut(); }
+
+  template <class T>
+  auto As() const -> const T * {
+    return guard_.As<T>();
+  }
+
+  template <class T>
+  auto AsMut() -> T * {
+    return guard_.AsMut<T>();
+  }
+
+  template <class T>
+  auto AsPage() -> T * {
+    return guard_.AsPage<T>();
+  }
+
+  template <class T>
+  auto AsPageMut() -> T * {
+    return guard_.AsPageMut<T>();
+  }
+
+ private:
+  BasicPageGuard guard_;
+};
+
+/**
+ * OptimisticReadGuard holds a pin on a page and the page version seen when the guard was created, without taking the
+ * page latch. Anything read through the guard is only valid if Validate() returns true afterwards; a failed validation
+ * means a writer got in between and the read has to be retried.
+ *
+ * The guard unpins the page (clean) when it goes out of scope, unless the pin was handed over with Release().
+ */
+class OptimisticReadGuard {
+ public:
+  OptimisticReadGuard() = default;
+
+  /**
+   * Take over a pinned page and start an optimistic read on it.
+   * @param bpm the buffer pool manager the page was pinned in
+   * @param page the pinned page
+   */
+  OptimisticReadGuard(BufferPoolManager *bpm, Page *page) : bpm_(bpm), page_(page), version_(page->ReadVersion()) {}
+
+  OptimisticReadGuard(const OptimisticReadGuard &) = delete;
+  auto operator=(const OptimisticReadGuard &) -> OptimisticReadGuard & = delete;
+
+  OptimisticReadGuard(OptimisticReadGuard &&that) noexcept;
+  auto operator=(OptimisticReadGuard &&that) noexcept -> OptimisticReadGuard &;
+
+  ~OptimisticReadGuard() { Drop(); }
+
+  /** Unpin the page. The guard is empty afterwards. */
+  void Drop();
+
+  /**
+   * Hand the pin over to the caller, who becomes responsible for unpinning the page.
+   * @return the page, or nullptr if the guard is empty
+   */
+  auto Release() -> Page *;
+
+  /**
+   * Turn the optimistic read into a latched one: take the read latch, then check that no writer got in since the guard
+   * was created. On success the caller owns the pinned, read-latched page and the guard is empty.
+   * @return the page, or nullptr if the validation failed; the guard still holds the (unlatched) pin then
+   */
+  auto TryRLatch() -> Page *;
+
+  /**
+   * Same as TryRLatch(), but with the write latch.
+   * @return the page, or nullptr if the validation failed; the guard still holds the (unlatched) pin then
+   */
+  auto TryWLatch() -> Page *;
+
+  /** @return true if no writer latched the page since the guard was created */
+  auto Validate() const -> bool { return page_->ValidateVersion(version_); }
+
+  /** @return true if the guard holds a page */
+  auto IsValid() const -> bool { return page_ != nullptr; }
+
+  auto PageId() const -> page_id_t { return page_->GetPageId(); }
+
+  auto GetData() const -> const char * { return page_->GetData(); }
+
+  template <class T>
+  auto As() const -> const T * {
+    return reinterpret_cast<const T *>(GetData());
+  }
+
+ private:
+  BufferPoolManager *bpm_{nullptr};
+  Page *page_{nullptr};
+  uint64_t version_{0};
+};
+
+}  // namespace bustub
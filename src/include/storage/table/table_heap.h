@@ -12,6 +12,10 @@
 
 #pragma once
 
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
@@ -99,8 +103,12 @@ class TableHeap {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
 
-  /** @return the begin iterator of this table */
-  auto Begin(Transaction *txn) -> TableIterator;
+  /**
+   * @param txn transaction performing the scan
+   * @param access_type the buffer pool hint for the pages of the scan
+   * @return the begin iterator of this table
+   */
+  auto Begin(Transaction *txn, AccessType access_type = AccessType::Scan) -> TableIterator;
 
   /** @return the end iterator of this table */
   auto End() -> TableIterator;
@@ -109,10 +117,36 @@ class TableHeap {
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
  private:
+  /**
+   * Remember that next_page_id follows page_id in the page chain. Pages are never unlinked, so the known part of the
+   * chain only grows at its end; a link that does not start at its last page is already known.
+   */
+  void LinkPage(page_id_t page_id, page_id_t next_page_id);
+
+  /**
+   * @param page_id a page of this table
+   * @param[out] position the position of page_id in the page chain
+   * @return false if page_id is not in the known part of the chain
+   */
+  auto FindChainPosition(page_id_t page_id, size_t *position) -> bool;
+
+  /**
+   * Collect the known pages at positions [begin, end) of the page chain.
+   * @param[out] page_ids receives the pages in chain order
+   */
+  void GetChainPages(size_t begin, size_t end, std::vector<page_id_t> *page_ids);
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  /**
+   * The page chain as far as it is known: every page a new heap links, or a heap that was opened has seen an insert
+   * or a scan walk past. Read-ahead follows it, since pages of several tables and indexes interleave on disk.
+   */
+  std::vector<page_id_t> chain_;
+  std::unordered_map<page_id_t, size_t> chain_positions_;
+  std::mutex chain_latch_;
 };
 
 }  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <cassert>
 
+#include "buffer/buffer_pool_manager.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
@@ -21,6 +22,7 @@
 namespace bustub {
 
 class TableHeap;
+class TablePage;
 
 /**
  * TableIterator enables the sequential scan of a TableHeap.
@@ -29,10 +31,15 @@ class TableIterator {
   friend class Cursor;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, AccessType access_type = AccessType::Scan);
 
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_),
+        tuple_(new Tuple(*other.tuple_)),
+        txn_(other.txn_),
+        access_type_(other.access_type_),
+        read_ahead_begin_(other.read_ahead_begin_),
+        read_ahead_end_(other.read_ahead_end_) {}
 
   ~TableIterator() { delete tuple_; }
 
@@ -54,13 +61,29 @@ class TableIterator {
     table_heap_ = other.table_heap_;
     *tuple_ = *other.tuple_;
     txn_ = other.txn_;
+    access_type_ = other.access_type_;
+    read_ahead_begin_ = other.read_ahead_begin_;
+    read_ahead_end_ = other.read_ahead_end_;
     return *this;
   }
 
  private:
+  /**
+   * Ask the buffer pool to read ahead of the page the scan has just entered, along the page chain the heap knows. A
+   * heap that was opened rather than created learns its chain as it is walked, so its first scan only reads one page
+   * ahead. The window is only moved once the scan has used up half of it, so most page crossings cost nothing.
+   * @param page the page the scan has just entered
+   */
+  void ReadAhead(TablePage *page);
+
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** The buffer pool hint for every page the iterator fetches. */
+  AccessType access_type_;
+  /** The pages at positions [read_ahead_begin_, read_ahead_end_) of the chain have been handed out for read-ahead. */
+  size_t read_ahead_begin_{0};
+  size_t read_ahead_end_{0};
 };
 
 }  // namespace bustub
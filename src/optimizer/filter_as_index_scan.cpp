@@ -0,0 +1,147 @@
+#include <memory>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the comparison that holds with its sides swapped, e.g. `a < b` as `b > a` */
+auto FlipComparison(ComparisonType comp_type) -> ComparisonType {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+/** Keep bound if there is none yet or if it is tighter than the current one, i.e. greater for a lower bound. */
+void TightenBound(const AbstractExpressionRef &bound, bool is_lower, AbstractExpressionRef *current) {
+  if (*current == nullptr) {
+    *current = bound;
+    return;
+  }
+  const auto &value = dynamic_cast<const ConstantValueExpression &>(*bound).val_;
+  const auto &current_value = dynamic_cast<const ConstantValueExpression &>(**current).val_;
+  auto tighter = is_lower ? value.CompareGreaterThan(current_value) : value.CompareLessThan(current_value);
+  if (tighter == CmpBool::CmpTrue) {
+    *current = bound;
+  }
+}
+
+/**
+ * Collect the bounds that the conjuncts of expr put on column col_idx, e.g. `#0.1 >= 3 AND #0.1 < 7` bounds column 1
+ * from 3 to 7. Bounds are inclusive, so a strict comparison yields the same bound as a non-strict one, and the
+ * predicate still has to be checked against the tuples. A disjunction yields no bounds.
+ */
+void CollectBounds(const AbstractExpressionRef &expr, uint32_t col_idx, TypeId col_type, AbstractExpressionRef *lower,
+                   AbstractExpressionRef *upper) {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get()); logic_expr != nullptr) {
+    if (logic_expr->logic_type_ == LogicType::And) {
+      CollectBounds(logic_expr->GetChildAt(0), col_idx, col_type, lower, upper);
+      CollectBounds(logic_expr->GetChildAt(1), col_idx, col_type, lower, upper);
+    }
+    return;
+  }
+  const auto *comparison_expr = dynamic_cast<const ComparisonExpression *>(expr.get());
+  if (comparison_expr == nullptr) {
+    return;
+  }
+  auto comp_type = comparison_expr->comp_type_;
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(comparison_expr->GetChildAt(0).get());
+  auto constant = comparison_expr->GetChildAt(1);
+  if (column_expr == nullptr) {
+    // `const op column`
+    column_expr = dynamic_cast<const ColumnValueExpression *>(comparison_expr->GetChildAt(1).get());
+    constant = comparison_expr->GetChildAt(0);
+    comp_type = FlipComparison(comp_type);
+  }
+  const auto *constant_expr = dynamic_cast<const ConstantValueExpression *>(constant.get());
+  if (column_expr == nullptr || constant_expr == nullptr || column_expr->GetTupleIdx() != 0 ||
+      column_expr->GetColIdx() != col_idx) {
+    return;
+  }
+  // the key is built from the constant as it is, so it has to be of the column type
+  if (constant_expr->val_.GetTypeId() != col_type || constant_expr->val_.IsNull()) {
+    return;
+  }
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      TightenBound(constant, true, lower);
+      TightenBound(constant, false, upper);
+      break;
+    case ComparisonType::GreaterThan:
+    case ComparisonType::GreaterThanOrEqual:
+      TightenBound(constant, true, lower);
+      break;
+    case ComparisonType::LessThan:
+    case ComparisonType::LessThanOrEqual:
+      TightenBound(constant, false, upper);
+      break;
+    default:
+      break;
+  }
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeFilterAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeFilterAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::Filter) {
+    const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+    BUSTUB_ASSERT(optimized_plan->children_.size() == 1, "must have exactly one children");
+    const auto &child_plan = *optimized_plan->children_[0];
+    if (child_plan.GetType() != PlanType::SeqScan) {
+      return optimized_plan;
+    }
+    const auto &seq_scan_plan = dynamic_cast<const SeqScanPlanNode &>(child_plan);
+    if (seq_scan_plan.filter_predicate_ != nullptr) {
+      return optimized_plan;
+    }
+    const auto *table_info = catalog_.GetTable(seq_scan_plan.GetTableOid());
+    for (const auto *index : catalog_.GetTableIndexes(table_info->name_)) {
+      // only a B+ tree can scan a range of keys
+      if (index->index_type_ != IndexType::BPlusTreeIndex) {
+        continue;
+      }
+      const auto &key_attrs = index->index_->GetKeyAttrs();
+      if (key_attrs.size() != 1) {
+        continue;
+      }
+      AbstractExpressionRef lower;
+      AbstractExpressionRef upper;
+      CollectBounds(filter_plan.GetPredicate(), key_attrs[0], index->key_schema_.GetColumn(0).GetType(), &lower,
+                    &upper);
+      if (lower != nullptr || upper != nullptr) {
+        return std::make_shared<IndexScanPlanNode>(filter_plan.output_schema_, index->index_oid_, lower, upper,
+                                                   filter_plan.GetPredicate());
+      }
+    }
+  }
+
+  return optimized_plan;
+}
+
+}  // namespace bustub
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** Add the columns of the first tuple that expr reads to columns. */
+void CollectColumns(const AbstractExpressionRef &expr, std::unordered_set<uint32_t> *columns) {
+  if (expr == nullptr) {
+    return;
+  }
+  if (const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr.get()); column_expr != nullptr) {
+    if (column_expr->GetTupleIdx() == 0) {
+      columns->insert(column_expr->GetColIdx());
+    }
+    return;
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeIndexOnlyScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  // mark child index-only if its index holds the columns read_columns, or all of them if nullptr, and its filter reads
+  auto as_index_only = [this](const AbstractPlanNodeRef &child,
+                              const std::unordered_set<uint32_t> *read_columns) -> AbstractPlanNodeRef {
+    if (child->GetType() != PlanType::IndexScan) {
+      return child;
+    }
+    const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*child);
+    if (index_scan.index_only_) {
+      return child;
+    }
+    const auto &entry_attrs = catalog_.GetIndex(index_scan.GetIndexOid())->index_->GetEntryAttrs();
+    std::unordered_set<uint32_t> columns;
+    if (read_columns != nullptr) {
+      columns = *read_columns;
+    } else {
+      for (uint32_t i = 0; i < index_scan.OutputSchema().GetColumnCount(); i++) {
+        columns.insert(i);
+      }
+    }
+    CollectColumns(index_scan.filter_predicate_, &columns);
+    for (auto column : columns) {
+      if (std::find(entry_attrs.begin(), entry_attrs.end(), column) == entry_attrs.end()) {
+        return child;
+      }
+    }
+    return std::make_shared<IndexScanPlanNode>(index_scan.output_schema_, index_scan.index_oid_,
+                                               index_scan.lower_bound_, index_scan.upper_bound_,
+                                               index_scan.filter_predicate_, index_scan.reverse_, index_scan.limit_,
+                                               true);
+  };
+
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeIndexOnlyScan(child));
+  }
+  if (plan->GetType() == PlanType::Projection) {
+    std::unordered_set<uint32_t> read_columns;
+    for (const auto &expr : dynamic_cast<const ProjectionPlanNode &>(*plan).GetExpressions()) {
+      CollectColumns(expr, &read_columns);
+    }
+    children[0] = as_index_only(children[0], &read_columns);
+  }
+  AbstractPlanNodeRef optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // whatever reads an index scan other than a projection may read any of its columns
+  return plan->GetType() == PlanType::IndexScan ? as_index_only(optimized_plan, nullptr) : optimized_plan;
+}
+
+}  // namespace bustub
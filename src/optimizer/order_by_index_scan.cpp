@@ -12,6 +12,7 @@
 #include "execution/plans/abstract_plan.h"
 #include "execution/plans/filter_plan.h"
 #include "execution/plans/index_scan_plan.h"
+#include "execution/plans/limit_plan.h"
 #include "execution/plans/nested_loop_join_plan.h"
 #include "execution/plans/projection_plan.h"
 #include "execution/plans/seq_scan_plan.h"
@@ -37,11 +38,12 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
       return optimized_plan;
     }
 
-    // Order type is asc or default
+    // Order type is asc, desc or default; a B+ tree index can be scanned both ways
     const auto &[order_type, expr] = order_bys[0];
-    if (!(order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT)) {
+    if (order_type == OrderByType::INVALID) {
       return optimized_plan;
     }
+    const bool reverse = order_type == OrderByType::DESC;
 
     // Order expression is a column value expression
     const auto *column_value_expr = dynamic_cast<ColumnValueExpression *>(expr.get());
@@ -61,14 +63,48 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
       const auto indices = catalog_.GetTableIndexes(table_info->name_);
 
       for (const auto *index : indices) {
+        // only a B+ tree keeps its keys in order
+        if (index->index_type_ != IndexType::BPlusTreeIndex) {
+          continue;
+        }
         const auto &columns = index->key_schema_.GetColumns();
         if (columns.size() == 1 &&
             columns[0].GetName() == table_info->schema_.GetColumn(order_by_column_id).GetName()) {
           // Index matched, return index scan instead
-          return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_);
+          return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_, nullptr,
+                                                     nullptr, nullptr, reverse);
         }
       }
     }
+
+    if (child_plan->GetType() == PlanType::IndexScan) {
+      // a bounded index scan produces its tuples in key order, in whichever direction it is asked to scan
+      const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*child_plan);
+      const auto *index = catalog_.GetIndex(index_scan.GetIndexOid());
+      const auto *table_info = catalog_.GetTable(index->table_name_);
+      const auto &columns = index->key_schema_.GetColumns();
+      if (!index_scan.limit_.has_value() && columns.size() == 1 &&
+          columns[0].GetName() == table_info->schema_.GetColumn(order_by_column_id).GetName()) {
+        return std::make_shared<IndexScanPlanNode>(index_scan.output_schema_, index_scan.index_oid_,
+                                                   index_scan.lower_bound_, index_scan.upper_bound_,
+                                                   index_scan.filter_predicate_, reverse);
+      }
+    }
+  }
+
+  if (optimized_plan->GetType() == PlanType::Limit) {
+    // the first tuples of an index scan without a filter are the first entries it scans, so it can stop after them
+    const auto &limit_plan = dynamic_cast<const LimitPlanNode &>(*optimized_plan);
+    const auto &child_plan = limit_plan.GetChildPlan();
+    if (child_plan->GetType() == PlanType::IndexScan) {
+      const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*child_plan);
+      if (index_scan.filter_predicate_ == nullptr) {
+        size_t limit = std::min(limit_plan.GetLimit(), index_scan.limit_.value_or(limit_plan.GetLimit()));
+        return std::make_shared<IndexScanPlanNode>(index_scan.output_schema_, index_scan.index_oid_,
+                                                   index_scan.lower_bound_, index_scan.upper_bound_, nullptr,
+                                                   index_scan.reverse_, limit);
+      }
+    }
   }
 
   return optimized_plan;
@@ -20,6 +20,7 @@
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/macros.h"
 #include "storage/disk/disk_manager.h"
 
 namespace bustub {
@@ -122,6 +123,26 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   }
 }
 
+/**
+ * Write a batch of pages, one page at a time
+ */
+void DiskManager::WritePages(const std::vector<page_id_t> &page_ids, const std::vector<const char *> &page_data) {
+  BUSTUB_ASSERT(page_ids.size() == page_data.size(), "every page needs a buffer");
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    WritePage(page_ids[i], page_data[i]);
+  }
+}
+
+/**
+ * Read a batch of pages, one page at a time
+ */
+void DiskManager::ReadPages(const std::vector<page_id_t> &page_ids, const std::vector<char *> &page_data) {
+  BUSTUB_ASSERT(page_ids.size() == page_data.size(), "every page needs a buffer");
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    ReadPage(page_ids[i], page_data[i]);
+  }
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
@@ -199,6 +220,15 @@ auto DiskManager::GetNumWrites() const -> int { return num_writes_; }
  */
 auto DiskManager::GetFlushState() const -> bool { return flush_log_; }
 
+auto DiskManager::GetNumPages() const -> page_id_t {
+  struct stat stat_buf;
+  if (stat(file_name_.c_str(), &stat_buf) != 0) {
+    return 0;
+  }
+  // a page that was cut short still has an id
+  return static_cast<page_id_t>((stat_buf.st_size + BUSTUB_PAGE_SIZE - 1) / BUSTUB_PAGE_SIZE);
+}
+
 /**
  * Private helper function to get disk file size
  */
@@ -0,0 +1,220 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.cpp
+//
+// Identification: src/storage/disk/disk_manager_posix.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_posix.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <future>  // NOLINT
+#include <memory>
+#include <numeric>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+DiskManagerPosix::DiskManagerPosix(const std::string &db_file, size_t num_io_threads) : DiskManager(db_file) {
+  {
+    // The base class opened the db file as a stream as well; pages go through db_fd_ only.
+    std::scoped_lock scoped_db_io_latch(db_io_latch_);
+    db_io_.close();
+  }
+  db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);  // NOLINT
+  if (db_fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+  for (size_t i = 0; i < num_io_threads; i++) {
+    workers_.emplace_back(&DiskManagerPosix::RunWorker, this);
+  }
+}
+
+DiskManagerPosix::~DiskManagerPosix() {
+  StopWorkers();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
+  }
+}
+
+void DiskManagerPosix::ShutDown() {
+  StopWorkers();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
+  }
+  DiskManager::ShutDown();
+}
+
+void DiskManagerPosix::WritePage(page_id_t page_id, const char *page_data) {
+  IORun run{page_id, {iovec{const_cast<char *>(page_data), BUSTUB_PAGE_SIZE}}};  // NOLINT
+  TransferRun(run, true);
+}
+
+void DiskManagerPosix::ReadPage(page_id_t page_id, char *page_data) {
+  IORun run{page_id, {iovec{page_data, BUSTUB_PAGE_SIZE}}};
+  TransferRun(run, false);
+}
+
+void DiskManagerPosix::WritePages(const std::vector<page_id_t> &page_ids, const std::vector<const char *> &page_data) {
+  BUSTUB_ASSERT(page_ids.size() == page_data.size(), "every page needs a buffer");
+  std::vector<char *> buffers;
+  buffers.reserve(page_data.size());
+  for (const auto *data : page_data) {
+    buffers.push_back(const_cast<char *>(data));  // NOLINT: pwritev() only reads from the iovecs
+  }
+  TransferRuns(BuildRuns(page_ids, buffers, true), true);
+}
+
+void DiskManagerPosix::ReadPages(const std::vector<page_id_t> &page_ids, const std::vector<char *> &page_data) {
+  BUSTUB_ASSERT(page_ids.size() == page_data.size(), "every page needs a buffer");
+  TransferRuns(BuildRuns(page_ids, page_data, false), false);
+}
+
+auto DiskManagerPosix::BuildRuns(const std::vector<page_id_t> &page_ids, const std::vector<char *> &buffers,
+                                 bool is_write) -> std::vector<IORun> {
+  std::vector<size_t> order(page_ids.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return page_ids[a] < page_ids[b]; });
+
+  std::vector<IORun> runs;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  for (auto i : order) {
+    if (!runs.empty() && page_ids[i] == prev_page_id && is_write) {
+      // Runs go to different threads and may land in any order, so only the last write of a page is issued. The sort
+      // is stable, which makes it the last one of the batch.
+      runs.back().iov_.back().iov_base = buffers[i];
+      continue;
+    }
+    // A page read twice starts a new run; both buffers get the same data whatever order the runs go in.
+    if (runs.empty() || page_ids[i] != prev_page_id + 1 || runs.back().iov_.size() == IOV_MAX) {
+      runs.push_back(IORun{page_ids[i], {}});
+    }
+    runs.back().iov_.push_back(iovec{buffers[i], BUSTUB_PAGE_SIZE});
+    prev_page_id = page_ids[i];
+  }
+  return runs;
+}
+
+void DiskManagerPosix::TransferRun(const IORun &run, bool is_write) {
+  const auto offset = static_cast<off_t>(run.first_page_id_) * BUSTUB_PAGE_SIZE;
+  const size_t total = run.iov_.size() * BUSTUB_PAGE_SIZE;
+  size_t done = 0;
+  std::vector<iovec> rest;
+  while (done < total) {
+    const iovec *iov = run.iov_.data();
+    int iov_cnt = static_cast<int>(run.iov_.size());
+    if (done > 0) {
+      // Resume a short transfer right after the last byte that made it.
+      const size_t first = done / BUSTUB_PAGE_SIZE;
+      const size_t skip = done % BUSTUB_PAGE_SIZE;
+      rest.assign(run.iov_.begin() + first, run.iov_.end());
+      rest[0].iov_base = static_cast<char *>(rest[0].iov_base) + skip;
+      rest[0].iov_len -= skip;
+      iov = rest.data();
+      iov_cnt = static_cast<int>(rest.size());
+    }
+    ssize_t n = is_write ? pwritev(db_fd_, iov, iov_cnt, offset + done) : preadv(db_fd_, iov, iov_cnt, offset + done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      LOG_WARN("I/O error while %s pages %d..%d: %s", is_write ? "writing" : "reading", run.first_page_id_,
+               run.first_page_id_ + static_cast<int>(run.iov_.size()) - 1, strerror(errno));
+      break;
+    }
+    if (n == 0) {
+      // only a read can come back empty, at the end of the file
+      break;
+    }
+    done += n;
+  }
+
+  if (is_write) {
+    // only the pages that made it to the file count as written
+    num_writes_ += static_cast<int>(done / BUSTUB_PAGE_SIZE);
+    return;
+  }
+  if (done < total) {
+    LOG_DEBUG("Read less than a page");
+    for (size_t i = done / BUSTUB_PAGE_SIZE; i < run.iov_.size(); i++) {
+      const size_t skip = i == done / BUSTUB_PAGE_SIZE ? done % BUSTUB_PAGE_SIZE : 0;
+      memset(static_cast<char *>(run.iov_[i].iov_base) + skip, 0, BUSTUB_PAGE_SIZE - skip);
+    }
+  }
+}
+
+void DiskManagerPosix::TransferRuns(const std::vector<IORun> &runs, bool is_write) {
+  const size_t num_groups = std::min(runs.size(), workers_.size() + 1);
+  if (num_groups <= 1) {
+    for (const auto &run : runs) {
+      TransferRun(run, is_write);
+    }
+    return;
+  }
+
+  // Group g takes every num_groups-th run. Groups 1.. go to the I/O threads, group 0 runs right here.
+  auto transfer_group = [this, &runs, num_groups, is_write](size_t group) {
+    for (size_t i = group; i < runs.size(); i += num_groups) {
+      TransferRun(runs[i], is_write);
+    }
+  };
+  std::vector<std::future<void>> pending;
+  {
+    std::scoped_lock<std::mutex> lock(task_latch_);
+    for (size_t group = 1; group < num_groups; group++) {
+      auto task = std::make_shared<std::packaged_task<void()>>([&transfer_group, group] { transfer_group(group); });
+      pending.push_back(task->get_future());
+      tasks_.emplace([task] { (*task)(); });
+    }
+  }
+  task_cv_.notify_all();
+  transfer_group(0);
+  for (auto &f : pending) {
+    f.wait();
+  }
+}
+
+void DiskManagerPosix::RunWorker() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(task_latch_);
+      task_cv_.wait(lock, [this] { return stop_workers_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    task();
+  }
+}
+
+void DiskManagerPosix::StopWorkers() {
+  {
+    std::scoped_lock<std::mutex> lock(task_latch_);
+    stop_workers_ = true;
+  }
+  task_cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+}  // namespace bustub
@@ -1,13 +1,32 @@
+#include <algorithm>
+#include <limits>
 #include <string>
 
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/rid.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/varlen_key.h"
 #include "storage/page/header_page.h"
 
 namespace bustub {
-INDEX_TEMPLATE_ARGUMENTS
+namespace {
+/**
+ * Number of pages a level of num_entries entries is spread over evenly by a bulk load. Each page gets about fill_factor
+ * of its capacity, but never less than min_size unless the whole level fits into one page.
+ */
+auto BulkLoadPageCount(size_t num_entries, int capacity, int min_size, double fill_factor) -> size_t {
+  auto target = static_cast<size_t>(std::clamp(fill_factor * capacity, 1.0, static_cast<double>(capacity)));
+  target = std::max(target, static_cast<size_t>(min_size));
+  size_t count = (num_entries + target - 1) / target;
+  if (count > 1 && num_entries / count < static_cast<size_t>(min_size)) {
+    count = std::max<size_t>(1, num_entries / min_size);
+  }
+  return count;
+}
+}  // namespace
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
                           int leaf_max_size, int internal_max_size)
     : index_name_(std::move(name)),
@@ -20,8 +39,13 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manag
 /*
  * Helper function to decide whether current b+tree is empty
  */
-INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return true; }
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
+  root_latch_.RLock();
+  bool is_empty = root_page_id_ == INVALID_PAGE_ID;
+  root_latch_.RUnlock();
+  return is_empty;
+}
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
@@ -30,9 +54,227 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return true; }
  * This method is used for point query
  * @return : true means key exists
  */
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
-  return false;
+  ReadPageGuard leaf_guard = FindLeafRead(key, Descent::KEY);
+  if (!leaf_guard.IsValid()) {
+    return false;
+  }
+  ValueType value;
+  bool found = leaf_guard.As<LeafPage>()->Lookup(key, &value, comparator_);
+  if (found) {
+    result->push_back(value);
+  }
+  return found;
+}
+
+/*
+ * Descend to a leaf without latching internal pages. Each step pins the child and takes its version, then checks that
+ * the parent has not been latched by a writer since it was read; otherwise the child pointer may be stale and the
+ * descent starts over from the root. Internal pages are therefore never written to by readers.
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafOptimistic(const KeyType &key, Descent descent) -> OptimisticReadGuard {
+  while (true) {
+    root_latch_.RLock();
+    if (root_page_id_ == INVALID_PAGE_ID) {
+      root_latch_.RUnlock();
+      return {};
+    }
+    OptimisticReadGuard guard;
+    try {
+      // The root's version is taken under root_latch_: installing a new root latches (and so bumps) the old one.
+      guard = FetchTreePageOptimistic(root_page_id_);
+    } catch (...) {
+      root_latch_.RUnlock();
+      throw;
+    }
+    root_latch_.RUnlock();
+
+    // the key of a leftmost or rightmost descent is a placeholder, which is not normalized
+    const SeparatorType probe = descent == Descent::KEY ? InternalPage::MakeProbe(key, comparator_) : SeparatorType{};
+    while (true) {
+      if (guard.As<BPlusTreePage>()->IsLeafPage()) {
+        return guard;
+      }
+      // A torn read can show any size; never index past the page before the read is validated.
+      const auto *internal = guard.As<InternalPage>();
+      int size = internal->GetSize();
+      if (size < 1 || size > internal_max_size_ + 1) {
+        break;
+      }
+      page_id_t child_page_id;
+      switch (descent) {
+        case Descent::LEFTMOST:
+          child_page_id = internal->ValueAt(0);
+          break;
+        case Descent::RIGHTMOST:
+          child_page_id = internal->ValueAt(size - 1);
+          break;
+        default:
+          child_page_id = internal->Lookup(probe, comparator_);
+      }
+      if (!guard.Validate()) {
+        break;
+      }
+      OptimisticReadGuard child_guard = FetchTreePageOptimistic(child_page_id);
+      if (!guard.Validate()) {
+        break;
+      }
+      guard = std::move(child_guard);
+    }
+  }
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafRead(const KeyType &key, Descent descent) -> ReadPageGuard {
+  while (true) {
+    OptimisticReadGuard guard = FindLeafOptimistic(key, descent);
+    if (!guard.IsValid()) {
+      return {};
+    }
+    Page *leaf_page = guard.TryRLatch();
+    if (leaf_page != nullptr) {
+      return ReadPageGuard(buffer_pool_manager_, leaf_page);
+    }
+  }
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Locate(const KeyType &key) -> std::pair<ReadPageGuard, int> {
+  ReadPageGuard guard = FindLeafRead(key, Descent::KEY);
+  if (!guard.IsValid()) {
+    return {std::move(guard), 0};
+  }
+  int index = guard.As<LeafPage>()->KeyIndex(key, comparator_);
+  return {std::move(guard), index};
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::MakeLocateFunction() -> typename INDEXITERATOR_TYPE::LocateFunction {
+  return [this](const KeyType &key) { return Locate(key); };
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::LinkNextLeafBack(const LeafPage *leaf) {
+  if (leaf->GetNextPageId() == INVALID_PAGE_ID) {
+    return;
+  }
+  // Latching to the right of a latched leaf cannot deadlock: writers only ever latch a leaf to the left of one they
+  // hold under a parent they hold as well, and iterators hold a single leaf at a time.
+  WritePageGuard next_guard = FetchTreePage(leaf->GetNextPageId()).UpgradeWrite();
+  next_guard.AsMut<LeafPage>()->SetPrevPageId(leaf->GetPageId());
+}
+
+/*
+ * Like IndexIterator, the scan pins the next leaf before letting go of the
+ * current one, so a merge cannot free it in between; the prefetch issued
+ * when the current leaf is latched lets its read overlap with the copying.
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Scan(const KeyType *lo, const KeyType *hi, const ScanCallback &callback) {
+  ReadPageGuard guard = lo == nullptr ? FindLeafRead(KeyType{}, Descent::LEFTMOST) : FindLeafRead(*lo, Descent::KEY);
+  if (!guard.IsValid()) {
+    return;
+  }
+  int index = lo == nullptr ? 0 : guard.As<LeafPage>()->KeyIndex(*lo, comparator_);
+  std::vector<std::pair<KeyType, ValueType>> batch;
+  while (true) {
+    const auto *leaf = guard.As<LeafPage>();
+    page_id_t next_page_id = leaf->GetNextPageId();
+    if (next_page_id != INVALID_PAGE_ID) {
+      buffer_pool_manager_->PrefetchPages(next_page_id, 1, AccessType::Scan);
+    }
+    batch.clear();
+    for (; index < leaf->GetSize(); index++) {
+      KeyType key = leaf->KeyAt(index);
+      if (hi != nullptr && comparator_(key, *hi) > 0) {
+        next_page_id = INVALID_PAGE_ID;
+        break;
+      }
+      batch.emplace_back(key, leaf->ValueAt(index));
+    }
+
+    BasicPageGuard next_guard;
+    if (next_page_id != INVALID_PAGE_ID) {
+      next_guard = FetchTreePage(next_page_id);
+    }
+    guard.Drop();
+    if (!batch.empty() && !callback(batch)) {
+      return;
+    }
+    if (!next_guard.IsValid()) {
+      return;
+    }
+    guard = next_guard.UpgradeRead();
+    index = 0;
+  }
+}
+
+/*
+ * Latching to the left of a latched leaf could deadlock with writers, so the
+ * reverse scan only pins the previous leaf while it holds the current one.
+ * Once it has latched the previous leaf, it checks that the two are still
+ * linked; if a split or merge came in between, it looks up the smallest key it
+ * has passed again, as IndexIterator::StepBack() does.
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReverseScan(const KeyType *lo, const KeyType *hi, const ScanCallback &callback) {
+  ReadPageGuard guard = hi == nullptr ? FindLeafRead(KeyType{}, Descent::RIGHTMOST) : FindLeafRead(*hi, Descent::KEY);
+  if (!guard.IsValid()) {
+    return;
+  }
+  // the entries before end are the ones left to return from the current leaf
+  int end = guard.As<LeafPage>()->GetSize();
+  KeyType passed_key{};
+  std::vector<std::pair<KeyType, ValueType>> batch;
+  while (true) {
+    const auto *leaf = guard.As<LeafPage>();
+    page_id_t prev_page_id = leaf->GetPrevPageId();
+    if (prev_page_id != INVALID_PAGE_ID) {
+      buffer_pool_manager_->PrefetchPages(prev_page_id, 1, AccessType::Scan);
+    }
+    batch.clear();
+    for (int index = end - 1; index >= 0; index--) {
+      KeyType key = leaf->KeyAt(index);
+      if (lo != nullptr && comparator_(key, *lo) < 0) {
+        prev_page_id = INVALID_PAGE_ID;
+        break;
+      }
+      // a leaf found again after a split or merge may hold keys that were inserted past hi meanwhile
+      if (hi == nullptr || comparator_(key, *hi) <= 0) {
+        batch.emplace_back(key, leaf->ValueAt(index));
+      }
+    }
+    if (leaf->GetSize() > 0) {
+      passed_key = leaf->KeyAt(0);
+    }
+
+    const page_id_t page_id = guard.PageId();
+    BasicPageGuard prev_guard;
+    if (prev_page_id != INVALID_PAGE_ID) {
+      prev_guard = FetchTreePage(prev_page_id);
+    }
+    guard.Drop();
+    if (!batch.empty() && !callback(batch)) {
+      return;
+    }
+    if (!prev_guard.IsValid()) {
+      return;
+    }
+    guard = prev_guard.UpgradeRead();
+    if (guard.As<LeafPage>()->GetNextPageId() == page_id) {
+      end = guard.As<LeafPage>()->GetSize();
+      continue;
+    }
+    // the previous leaf was split, or merged into, while no latch was held
+    guard.Drop();
+    guard = FindLeafRead(passed_key, Descent::KEY);
+    if (!guard.IsValid()) {
+      return;
+    }
+    end = guard.As<LeafPage>()->KeyIndex(passed_key, comparator_);
+  }
 }
 
 /*****************************************************************************
@@ -45,9 +287,279 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * @return: since we only support unique key, if user try to insert duplicate
  * keys return false, otherwise return true.
  */
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
-  return false;
+  WritePageGuard safe_leaf_guard = FindSafeLeafWrite(key, Operation::INSERT);
+  if (safe_leaf_guard.IsValid()) {
+    ValueType existing_value;
+    if (safe_leaf_guard.As<LeafPage>()->Lookup(key, &existing_value, comparator_)) {
+      return false;
+    }
+    safe_leaf_guard.AsMut<LeafPage>()->Insert(key, value, comparator_);
+    return true;
+  }
+
+  WriteContext ctx;
+  if (!FindLeafWrite(key, Operation::INSERT, &ctx)) {
+    StartNewTree(key, value);
+    ReleaseAll(&ctx);
+    return true;
+  }
+
+  WritePageGuard &leaf_guard = ctx.write_set_.back();
+  ValueType existing_value;
+  if (leaf_guard.As<LeafPage>()->Lookup(key, &existing_value, comparator_)) {
+    ReleaseAll(&ctx);
+    return false;
+  }
+  auto *leaf = leaf_guard.AsMut<LeafPage>();
+  if (leaf->CanInsert(key)) {
+    leaf->Insert(key, value, comparator_);
+    ReleaseAll(&ctx);
+    return true;
+  }
+
+  // The leaf is full. Split it; counting the new entry, the left half keeps left_size entries.
+  page_id_t new_page_id;
+  BasicPageGuard new_guard = NewTreePage(&new_page_id);
+  auto *new_leaf = new_guard.AsMut<LeafPage>();
+  new_leaf->Init(new_page_id, leaf->GetParentPageId(), leaf_max_size_);
+  int insert_index = leaf->KeyIndex(key, comparator_);
+  int left_size = leaf->SplitSize(insert_index, key);
+  if (insert_index < left_size) {
+    leaf->MoveLatterHalfTo(new_leaf, left_size - 1);
+    leaf->Insert(key, value, comparator_);
+  } else {
+    leaf->MoveLatterHalfTo(new_leaf, left_size);
+    new_leaf->Insert(key, value, comparator_);
+  }
+  new_leaf->SetNextPageId(leaf->GetNextPageId());
+  new_leaf->SetPrevPageId(leaf->GetPageId());
+  leaf->SetNextPageId(new_page_id);
+  LinkNextLeafBack(new_leaf);
+  SeparatorType separator =
+      InternalPage::MakeSeparator(leaf->KeyAt(leaf->GetSize() - 1), new_leaf->KeyAt(0), comparator_);
+  InsertIntoParent(leaf, separator, new_leaf, &ctx, ctx.write_set_.size() - 1);
+  ReleaseAll(&ctx);
+  return true;
+}
+
+/*
+ * Insert constant key & value pair into an empty tree
+ * User needs to first ask for new page from buffer pool manager(NOTICE: throw
+ * an "out of memory" exception if returned value is nullptr), then update b+
+ * tree's root page id and insert entry directly into leaf page.
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
+  page_id_t page_id;
+  BasicPageGuard guard = NewTreePage(&page_id);
+  auto *leaf = guard.AsMut<LeafPage>();
+  leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+  leaf->Insert(key, value, comparator_);
+  root_page_id_ = page_id;
+  UpdateRootPageId(1);
+}
+
+/*
+ * Insert key & value pair into internal page after split
+ * @param   old_node      input page from split() method
+ * @param   key
+ * @param   new_node      returned page from split() method
+ * @param   depth         position of old_node in ctx->write_set_
+ * User needs to first find the parent page of old_node, parent node must be
+ * adjusted to take info of new_node into account. Remember to deal with split
+ * recursively if necessary.
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const SeparatorType &key, BPlusTreePage *new_node,
+                                      WriteContext *ctx, size_t depth) {
+  if (old_node->IsRootPage()) {
+    // the old root was unsafe, so root_latch_ is still held
+    page_id_t root_page_id;
+    BasicPageGuard root_guard = NewTreePage(&root_page_id);
+    auto *root = root_guard.AsMut<InternalPage>();
+    root->Init(root_page_id, INVALID_PAGE_ID, internal_max_size_);
+    root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
+    old_node->SetParentPageId(root_page_id);
+    new_node->SetParentPageId(root_page_id);
+    root_page_id_ = root_page_id;
+    UpdateRootPageId(0);
+    return;
+  }
+
+  WritePageGuard &parent_guard = ctx->write_set_[depth - 1];
+  auto *parent = parent_guard.AsMut<InternalPage>();
+  int insert_index = parent->ValueIndex(old_node->GetPageId()) + 1;
+  if (parent->CanInsertAt(insert_index, key)) {
+    parent->InsertNodeAt(insert_index, key, new_node->GetPageId());
+    new_node->SetParentPageId(parent->GetPageId());
+    return;
+  }
+
+  // The parent is full. Split it; counting the new entry, the left half keeps left_size entries.
+  page_id_t sibling_page_id;
+  BasicPageGuard sibling_guard = NewTreePage(&sibling_page_id);
+  auto *sibling = sibling_guard.AsMut<InternalPage>();
+  sibling->Init(sibling_page_id, parent->GetParentPageId(), internal_max_size_);
+  int left_size = parent->SplitSize(insert_index, key);
+  if (insert_index < left_size) {
+    parent->MoveLatterHalfTo(sibling, left_size - 1, buffer_pool_manager_);
+    parent->InsertNodeAt(insert_index, key, new_node->GetPageId());
+    new_node->SetParentPageId(parent->GetPageId());
+  } else {
+    parent->MoveLatterHalfTo(sibling, left_size, buffer_pool_manager_);
+    sibling->InsertNodeAt(insert_index - left_size, key, new_node->GetPageId());
+    new_node->SetParentPageId(sibling_page_id);
+  }
+  InsertIntoParent(parent, sibling->KeyAt(0), sibling, ctx, depth - 1);
+}
+
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Build the tree one level at a time. Pages are spread evenly over a level, so
+ * none is left below min size, and every page is written once: parent ids are
+ * set when the level above is built. A page that runs out of space before
+ * taking its share of entries, which only happens to pages with compressed
+ * separators or slotted leaves, is closed early and the rest of the level
+ * moves on. Slotted leaves are filled by bytes rather than by entries. The
+ * last page of a level may then be left with whatever entries remain; it
+ * borrows from the page before it, as a remove would, until it is no longer
+ * underfull.
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(EntryIterator first, EntryIterator last, double fill_factor) -> bool {
+  auto less = [this](const auto &lhs, const auto &rhs) { return comparator_(lhs.first, rhs.first) < 0; };
+  if (!std::is_sorted(first, last, less)) {
+    return false;
+  }
+  auto is_duplicate = [this, first](EntryIterator it) {
+    return it != first && comparator_(std::prev(it)->first, it->first) == 0;
+  };
+  size_t num_entries = 0;
+  for (auto it = first; it != last; ++it) {
+    num_entries += is_duplicate(it) ? 0 : 1;
+  }
+
+  root_latch_.WLock();
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    root_latch_.WUnlock();
+    return false;
+  }
+  if (num_entries == 0) {
+    root_latch_.WUnlock();
+    return true;
+  }
+  try {
+    // the separator in front of and the page id of every page of the level built last
+    std::vector<std::pair<SeparatorType, page_id_t>> level;
+
+    const size_t num_leaves = BulkLoadPageCount(num_entries, leaf_max_size_ - 1, leaf_max_size_ / 2, fill_factor);
+    level.reserve(num_leaves);
+    BasicPageGuard prev_guard;
+    auto it = first;
+    for (size_t i = 0;; i++) {
+      while (it != last && is_duplicate(it)) {
+        ++it;
+      }
+      if (it == last) {
+        break;
+      }
+      const size_t leaf_size = i < num_leaves ? num_entries / num_leaves + (i < num_entries % num_leaves ? 1 : 0)
+                                              : std::numeric_limits<size_t>::max();
+      page_id_t page_id;
+      BasicPageGuard guard = NewTreePage(&page_id);
+      auto *leaf = guard.AsMut<LeafPage>();
+      leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+      for (size_t j = 0; j < leaf_size && it != last; ++it) {
+        if (is_duplicate(it)) {
+          continue;
+        }
+        if (j > 0 && !leaf->CanInsert(it->first)) {
+          break;
+        }
+        if constexpr (!std::is_same_v<LeafPage, BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>) {
+          if (j > 0 && leaf->IsFilledTo(fill_factor)) {
+            break;
+          }
+        }
+        leaf->Insert(it->first, it->second, comparator_);
+        j++;
+      }
+      if (prev_guard.IsValid()) {
+        auto *prev_leaf = prev_guard.AsMut<LeafPage>();
+        level.emplace_back(
+            InternalPage::MakeSeparator(prev_leaf->KeyAt(prev_leaf->GetSize() - 1), leaf->KeyAt(0), comparator_),
+            page_id);
+        prev_leaf->SetNextPageId(page_id);
+        leaf->SetPrevPageId(prev_leaf->GetPageId());
+      } else {
+        level.emplace_back(InternalPage::MakeProbe(leaf->KeyAt(0), comparator_), page_id);
+      }
+      prev_guard = std::move(guard);
+    }
+    if (level.size() > 1) {
+      auto *leaf = prev_guard.AsMut<LeafPage>();
+      BasicPageGuard donor_guard = FetchTreePage(level[level.size() - 2].second);
+      auto *donor = donor_guard.AsMut<LeafPage>();
+      bool moved = false;
+      while (leaf->IsUnderfull() && donor->CanMoveLastToFrontOf(leaf)) {
+        donor->MoveLastToFrontOf(leaf);
+        moved = true;
+      }
+      if (moved) {
+        level.back().first =
+            InternalPage::MakeSeparator(donor->KeyAt(donor->GetSize() - 1), leaf->KeyAt(0), comparator_);
+      }
+    }
+    prev_guard.Drop();
+
+    while (level.size() > 1) {
+      const size_t num_pages =
+          BulkLoadPageCount(level.size(), internal_max_size_, (internal_max_size_ + 1) / 2, fill_factor);
+      std::vector<std::pair<SeparatorType, page_id_t>> parents;
+      parents.reserve(num_pages);
+      size_t child = 0;
+      for (size_t i = 0; child < level.size(); i++) {
+        const size_t page_size = i < num_pages ? level.size() / num_pages + (i < level.size() % num_pages ? 1 : 0)
+                                               : level.size() - child;
+        page_id_t page_id;
+        BasicPageGuard guard = NewTreePage(&page_id);
+        auto *internal = guard.AsMut<InternalPage>();
+        internal->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+        parents.emplace_back(level[child].first, page_id);
+        for (size_t j = 0; j < page_size && child < level.size(); j++, child++) {
+          if (j > 0 && !internal->CanInsertAt(static_cast<int>(j), level[child].first)) {
+            break;
+          }
+          internal->InsertNodeAt(static_cast<int>(j), level[child].first, level[child].second);
+          FetchTreePage(level[child].second).template AsMut<BPlusTreePage>()->SetParentPageId(page_id);
+        }
+      }
+      if (parents.size() > 1) {
+        BasicPageGuard guard = FetchTreePage(parents.back().second);
+        auto *internal = guard.AsMut<InternalPage>();
+        BasicPageGuard donor_guard = FetchTreePage(parents[parents.size() - 2].second);
+        auto *donor = donor_guard.AsMut<InternalPage>();
+        while (internal->IsUnderfull() && donor->CanMoveLastToFrontOf(internal, parents.back().first)) {
+          SeparatorType separator = donor->KeyAt(donor->GetSize() - 1);
+          donor->MoveLastToFrontOf(internal, parents.back().first, buffer_pool_manager_);
+          parents.back().first = separator;
+        }
+      }
+      level = std::move(parents);
+    }
+
+    root_page_id_ = level[0].second;
+    UpdateRootPageId(1);
+  } catch (...) {
+    root_latch_.WUnlock();
+    throw;
+  }
+  root_latch_.WUnlock();
+  return true;
 }
 
 /*****************************************************************************
@@ -60,8 +572,277 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  * delete entry from leaf page. Remember to deal with redistribute or merge if
  * necessary.
  */
-INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {}
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  WritePageGuard safe_leaf_guard = FindSafeLeafWrite(key, Operation::REMOVE);
+  if (safe_leaf_guard.IsValid()) {
+    ValueType existing_value;
+    if (safe_leaf_guard.As<LeafPage>()->Lookup(key, &existing_value, comparator_)) {
+      safe_leaf_guard.AsMut<LeafPage>()->RemoveAndDeleteRecord(key, comparator_);
+    }
+    return;
+  }
+
+  WriteContext ctx;
+  if (!FindLeafWrite(key, Operation::REMOVE, &ctx)) {
+    ReleaseAll(&ctx);
+    return;
+  }
+  WritePageGuard &leaf_guard = ctx.write_set_.back();
+  ValueType existing_value;
+  if (!leaf_guard.As<LeafPage>()->Lookup(key, &existing_value, comparator_)) {
+    ReleaseAll(&ctx);
+    return;
+  }
+  auto *leaf = leaf_guard.AsMut<LeafPage>();
+  leaf->RemoveAndDeleteRecord(key, comparator_);
+  HandleUnderflow(leaf, &ctx, ctx.write_set_.size() - 1);
+  ReleaseAll(&ctx);
+}
+
+/*
+ * Fix up node after a removal left it below its min size: merge it with a
+ * sibling if both fit into one page, otherwise borrow one entry from the
+ * sibling. A merge removes an entry from the parent, which may underflow in
+ * turn.
+ * @param   depth         position of node in ctx->write_set_
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::HandleUnderflow(BPlusTreePage *node, WriteContext *ctx, size_t depth) {
+  if (node->IsRootPage()) {
+    AdjustRoot(node, ctx);
+    return;
+  }
+  if (node->IsLeafPage() ? !reinterpret_cast<LeafPage *>(node)->IsUnderfull()
+                         : !reinterpret_cast<InternalPage *>(node)->IsUnderfull()) {
+    return;
+  }
+
+  // The parent is latched as well: node was unsafe, so its ancestors were not released.
+  WritePageGuard &parent_guard = ctx->write_set_[depth - 1];
+  auto *parent = parent_guard.AsMut<InternalPage>();
+  if (parent->GetSize() < 2) {
+    // only a parent of compressed separators that could neither merge nor borrow is left with a single child
+    return;
+  }
+  int index = parent->ValueIndex(node->GetPageId());
+  int sibling_index = index == 0 ? 1 : index - 1;
+  WritePageGuard sibling_guard = FetchTreePage(parent->ValueAt(sibling_index)).UpgradeWrite();
+  auto *sibling = sibling_guard.AsMut<BPlusTreePage>();
+
+  // merge the right page of the two into the left one if they fit into one page
+  BPlusTreePage *left = sibling_index < index ? sibling : node;
+  BPlusTreePage *right = sibling_index < index ? node : sibling;
+  int right_index = std::max(index, sibling_index);
+  bool can_merge = node->IsLeafPage()
+                       ? reinterpret_cast<LeafPage *>(left)->CanMerge(reinterpret_cast<LeafPage *>(right))
+                       : reinterpret_cast<InternalPage *>(left)->CanMerge(reinterpret_cast<InternalPage *>(right),
+                                                                          parent->KeyAt(right_index));
+  if (can_merge) {
+    if (node->IsLeafPage()) {
+      reinterpret_cast<LeafPage *>(right)->MoveAllTo(reinterpret_cast<LeafPage *>(left));
+      LinkNextLeafBack(reinterpret_cast<LeafPage *>(left));
+    } else {
+      reinterpret_cast<InternalPage *>(right)->MoveAllTo(reinterpret_cast<InternalPage *>(left),
+                                                         parent->KeyAt(right_index), buffer_pool_manager_);
+    }
+    parent->Remove(right_index);
+    ctx->deleted_pages_.push_back(right->GetPageId());
+    sibling_guard.Drop();
+    HandleUnderflow(parent, ctx, depth - 1);
+    return;
+  }
+
+  // Redistribute: borrow the entry of the sibling that is closest to node. With compressed separators or slotted leaves
+  // the new separator may not fit into the parent, or the entry into node; node is then left underfull.
+  if (node->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    auto *sibling_leaf = reinterpret_cast<LeafPage *>(sibling);
+    int size = sibling_leaf->GetSize();
+    if (sibling_index < index) {
+      SeparatorType separator =
+          InternalPage::MakeSeparator(sibling_leaf->KeyAt(size - 2), sibling_leaf->KeyAt(size - 1), comparator_);
+      if (sibling_leaf->CanMoveLastToFrontOf(leaf) && parent->CanSetKeyAt(index, separator)) {
+        sibling_leaf->MoveLastToFrontOf(leaf);
+        parent->SetKeyAt(index, separator);
+      }
+    } else {
+      SeparatorType separator =
+          InternalPage::MakeSeparator(sibling_leaf->KeyAt(0), sibling_leaf->KeyAt(1), comparator_);
+      if (sibling_leaf->CanMoveFirstToEndOf(leaf) && parent->CanSetKeyAt(sibling_index, separator)) {
+        sibling_leaf->MoveFirstToEndOf(leaf);
+        parent->SetKeyAt(sibling_index, separator);
+      }
+    }
+  } else {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    auto *sibling_internal = reinterpret_cast<InternalPage *>(sibling);
+    if (sibling_index < index) {
+      SeparatorType separator = sibling_internal->KeyAt(sibling_internal->GetSize() - 1);
+      if (sibling_internal->CanMoveLastToFrontOf(internal, parent->KeyAt(index)) &&
+          parent->CanSetKeyAt(index, separator)) {
+        sibling_internal->MoveLastToFrontOf(internal, parent->KeyAt(index), buffer_pool_manager_);
+        parent->SetKeyAt(index, separator);
+      }
+    } else {
+      SeparatorType separator = sibling_internal->KeyAt(1);
+      if (sibling_internal->CanMoveFirstToEndOf(internal, parent->KeyAt(sibling_index)) &&
+          parent->CanSetKeyAt(sibling_index, separator)) {
+        sibling_internal->MoveFirstToEndOf(internal, parent->KeyAt(sibling_index), buffer_pool_manager_);
+        parent->SetKeyAt(sibling_index, separator);
+      }
+    }
+  }
+}
+
+/*
+ * Update root page if necessary
+ * NOTE: size of root page can be less than min size and this method is only
+ * called within HandleUnderflow()
+ * case 1: when you delete the last element in root page, but root page still
+ * has one last child
+ * case 2: when you delete the last element in whole b+ tree
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root, WriteContext *ctx) {
+  // a root that can shrink is unsafe for removal, so root_latch_ is still held
+  if (old_root->IsLeafPage()) {
+    if (old_root->GetSize() == 0) {
+      root_page_id_ = INVALID_PAGE_ID;
+      UpdateRootPageId(0);
+      ctx->deleted_pages_.push_back(old_root->GetPageId());
+    }
+    return;
+  }
+  if (old_root->GetSize() == 1) {
+    page_id_t child_page_id = reinterpret_cast<InternalPage *>(old_root)->ValueAt(0);
+    FetchTreePage(child_page_id).template AsMut<BPlusTreePage>()->SetParentPageId(INVALID_PAGE_ID);
+    root_page_id_ = child_page_id;
+    UpdateRootPageId(0);
+    ctx->deleted_pages_.push_back(old_root->GetPageId());
+  }
+}
+
+/*****************************************************************************
+ * LATCH CRABBING
+ *****************************************************************************/
+/*
+ * Optimistic write: an operation that is safe on the leaf leaves every other page alone, so only the leaf needs its
+ * write latch. Whether it is safe can only be told once the leaf is latched; if it is not, the caller falls back to
+ * FindLeafWrite().
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindSafeLeafWrite(const KeyType &key, Operation op) -> WritePageGuard {
+  while (true) {
+    OptimisticReadGuard guard = FindLeafOptimistic(key, Descent::KEY);
+    if (!guard.IsValid()) {
+      return {};
+    }
+    Page *leaf_page = guard.TryWLatch();
+    if (leaf_page == nullptr) {
+      continue;
+    }
+    WritePageGuard leaf_guard(buffer_pool_manager_, leaf_page);
+    if (!IsSafe(leaf_guard.As<BPlusTreePage>(), op)) {
+      return {};
+    }
+    return leaf_guard;
+  }
+}
+
+/*
+ * Descend to the leaf for key with write latches, releasing every ancestor as
+ * soon as a page on the path is safe for op.
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafWrite(const KeyType &key, Operation op, WriteContext *ctx) -> bool {
+  root_latch_.WLock();
+  ctx->root_latched_ = true;
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  const SeparatorType probe = InternalPage::MakeProbe(key, comparator_);
+  page_id_t page_id = root_page_id_;
+  while (true) {
+    WritePageGuard &guard = ctx->write_set_.emplace_back(FetchTreePage(page_id).UpgradeWrite());
+    const auto *node = guard.As<BPlusTreePage>();
+    if (IsSafe(node, op)) {
+      ReleaseAncestors(ctx);
+    }
+    if (node->IsLeafPage()) {
+      return true;
+    }
+    page_id = reinterpret_cast<const InternalPage *>(node)->Lookup(probe, comparator_);
+  }
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsSafe(const BPlusTreePage *node, Operation op) const -> bool {
+  if (op == Operation::INSERT) {
+    // a page splits when an entry does not fit, which the page tells
+    return node->IsLeafPage() ? reinterpret_cast<const LeafPage *>(node)->IsInsertSafe()
+                              : reinterpret_cast<const InternalPage *>(node)->IsInsertSafe();
+  }
+  if (node->IsRootPage()) {
+    return node->IsLeafPage() ? node->GetSize() > 1 : node->GetSize() > 2;
+  }
+  return node->IsLeafPage() ? reinterpret_cast<const LeafPage *>(node)->IsRemoveSafe()
+                            : reinterpret_cast<const InternalPage *>(node)->IsRemoveSafe();
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseAncestors(WriteContext *ctx, size_t keep) {
+  if (ctx->root_latched_) {
+    root_latch_.WUnlock();
+    ctx->root_latched_ = false;
+  }
+  while (ctx->write_set_.size() > keep) {
+    ctx->write_set_.pop_front();
+  }
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseAll(WriteContext *ctx) {
+  if (ctx->root_latched_) {
+    root_latch_.WUnlock();
+    ctx->root_latched_ = false;
+  }
+  // the guards unpin dirty exactly the pages that were modified through AsMut()
+  while (!ctx->write_set_.empty()) {
+    ctx->write_set_.pop_front();
+  }
+  for (page_id_t page_id : ctx->deleted_pages_) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  ctx->deleted_pages_.clear();
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchTreePageOptimistic(page_id_t page_id) -> OptimisticReadGuard {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame for a b+ tree page");
+  }
+  return {buffer_pool_manager_, page};
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchTreePage(page_id_t page_id) -> BasicPageGuard {
+  BasicPageGuard guard = buffer_pool_manager_->FetchPageBasic(page_id);
+  if (!guard.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame for a b+ tree page");
+  }
+  return guard;
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::NewTreePage(page_id_t *page_id) -> BasicPageGuard {
+  BasicPageGuard guard = buffer_pool_manager_->NewPageGuarded(page_id);
+  if (!guard.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame for a new b+ tree page");
+  }
+  return guard;
+}
 
 /*****************************************************************************
  * INDEX ITERATOR
@@ -71,30 +852,87 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {}
  * index iterator
  * @return : index iterator
  */
-INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
+  ReadPageGuard leaf_guard = FindLeafRead(KeyType{}, Descent::LEFTMOST);
+  if (!leaf_guard.IsValid()) {
+    return INDEXITERATOR_TYPE();
+  }
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, std::move(leaf_guard), 0, MakeLocateFunction());
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
  * first, then construct index iterator
  * @return : index iterator
  */
-INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  ReadPageGuard leaf_guard = FindLeafRead(key, Descent::KEY);
+  if (!leaf_guard.IsValid()) {
+    return INDEXITERATOR_TYPE();
+  }
+  int index = leaf_guard.As<LeafPage>()->KeyIndex(key, comparator_);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, std::move(leaf_guard), index, MakeLocateFunction());
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
  * of the key/value pair in the leaf node
  * @return : index iterator
  */
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
 
+/*
+ * Input parameter is void, find the rightmost leaf page first, then construct
+ * index iterator at its last entry
+ * @return : index iterator
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin() -> INDEXITERATOR_TYPE {
+  ReadPageGuard leaf_guard = FindLeafRead(KeyType{}, Descent::RIGHTMOST);
+  if (!leaf_guard.IsValid() || leaf_guard.As<LeafPage>()->GetSize() == 0) {
+    return INDEXITERATOR_TYPE();
+  }
+  int index = leaf_guard.As<LeafPage>()->GetSize() - 1;
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, std::move(leaf_guard), index, MakeLocateFunction());
+}
+
+/*
+ * Input parameter is high key, find the leaf page that contains the input key
+ * first, then construct index iterator at the last entry not greater than it
+ * @return : index iterator
+ */
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  auto [leaf_guard, index] = Locate(key);
+  if (!leaf_guard.IsValid()) {
+    return INDEXITERATOR_TYPE();
+  }
+  const auto *leaf = leaf_guard.template As<LeafPage>();
+  if (index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0) {
+    return INDEXITERATOR_TYPE(buffer_pool_manager_, std::move(leaf_guard), index, MakeLocateFunction());
+  }
+  if (index > 0) {
+    return INDEXITERATOR_TYPE(buffer_pool_manager_, std::move(leaf_guard), index - 1, MakeLocateFunction());
+  }
+  // every key of the leaf is greater, so the entry is the last one of the leaves before it
+  INDEXITERATOR_TYPE iterator(buffer_pool_manager_, std::move(leaf_guard), 0, MakeLocateFunction());
+  --iterator;
+  return iterator;
+}
+
 /**
  * @return Page id of the root of this tree
  */
-INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
+BPLUSTREE_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
+  root_latch_.RLock();
+  page_id_t root_page_id = root_page_id_;
+  root_latch_.RUnlock();
+  return root_page_id;
+}
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
@@ -107,24 +945,38 @@ auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
  * insert a record <index_name, root_page_id> into header page instead of
  * updating it.
  */
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
-  auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(HEADER_PAGE_ID);
+  auto *header_page = header_guard.AsPageMut<HeaderPage>();
   if (insert_record != 0) {
-    // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
+    // create a new record<index_name + root_page_id> in header_page, the record is still there if the tree was emptied
+    if (!header_page->InsertRecord(index_name_, root_page_id_)) {
+      header_page->UpdateRecord(index_name_, root_page_id_);
+    }
   } else {
     // update root_page_id in header_page
     header_page->UpdateRecord(index_name_, root_page_id_);
   }
-  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Reattach() {
+  BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(HEADER_PAGE_ID);
+  page_id_t root_page_id = INVALID_PAGE_ID;
+  if (!header_guard.AsPage<HeaderPage>()->GetRootId(index_name_, &root_page_id)) {
+    root_page_id = INVALID_PAGE_ID;
+  }
+  root_latch_.WLock();
+  root_page_id_ = root_page_id;
+  root_latch_.WUnlock();
 }
 
 /*
  * This method is used for test only
  * Read data from file and insert one by one
  */
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertFromFile(const std::string &file_name, Transaction *transaction) {
   int64_t key;
   std::ifstream input(file_name);
@@ -141,7 +993,7 @@ void BPLUSTREE_TYPE::InsertFromFile(const std::string &file_name, Transaction *t
  * This method is used for test only
  * Read data from file and remove one by one
  */
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::RemoveFromFile(const std::string &file_name, Transaction *transaction) {
   int64_t key;
   std::ifstream input(file_name);
@@ -156,7 +1008,7 @@ void BPLUSTREE_TYPE::RemoveFromFile(const std::string &file_name, Transaction *t
 /**
  * This method is used for debug only, You don't need to modify
  */
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Draw(BufferPoolManager *bpm, const std::string &outf) {
   if (IsEmpty()) {
     LOG_WARN("Draw an empty tree");
@@ -173,7 +1025,7 @@ void BPLUSTREE_TYPE::Draw(BufferPoolManager *bpm, const std::string &outf) {
 /**
  * This method is used for debug only, You don't need to modify
  */
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Print(BufferPoolManager *bpm) {
   if (IsEmpty()) {
     LOG_WARN("Print an empty tree");
@@ -191,7 +1043,7 @@ void BPLUSTREE_TYPE::Print(BufferPoolManager *bpm) {
  * @param bpm
  * @param out
  */
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const {
   std::string leaf_prefix("LEAF_");
   std::string internal_prefix("INT_");
@@ -282,7 +1134,7 @@ void BPLUSTREE_TYPE::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::o
  * @param page
  * @param bpm
  */
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const {
   if (page->IsLeafPage()) {
     auto *leaf = reinterpret_cast<LeafPage *>(page);
@@ -314,4 +1166,22 @@ template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTree<GenericKey<4>, RID, GenericComparator<4>,
+                         BPlusTreeCompressedInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>>;
+template class BPlusTree<GenericKey<8>, RID, GenericComparator<8>,
+                         BPlusTreeCompressedInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>>;
+template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>,
+                         BPlusTreeCompressedInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>>;
+template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>,
+                         BPlusTreeCompressedInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>>;
+template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>,
+                         BPlusTreeCompressedInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>>;
+
+template class BPlusTree<VarlenKey<256>, RID, VarlenComparator<256>,
+                         BPlusTreeInternalPage<VarlenKey<256>, page_id_t, VarlenComparator<256>>,
+                         BPlusTreeSlottedLeafPage<VarlenKey<256>, RID, VarlenComparator<256>>>;
+template class BPlusTree<VarlenKey<256>, RID, VarlenComparator<256>,
+                         BPlusTreeCompressedInternalPage<VarlenKey<256>, page_id_t, VarlenComparator<256>>,
+                         BPlusTreeSlottedLeafPage<VarlenKey<256>, RID, VarlenComparator<256>>>;
+
 }  // namespace bustub
@@ -11,17 +11,21 @@
 
 #include "storage/index/b_plus_tree_index.h"
 
+#include <algorithm>
+
+#include "common/exception.h"
+
 namespace bustub {
 /*
  * Constructor
  */
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
     : Index(std::move(metadata)),
       comparator_(GetMetadata()->GetKeySchema()),
       container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_) {}
 
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct insert index key
   KeyType index_key;
@@ -30,7 +34,7 @@ void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *t
   container_.Insert(index_key, rid, transaction);
 }
 
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
   KeyType index_key;
@@ -39,7 +43,7 @@ void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *t
   container_.Remove(index_key, transaction);
 }
 
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
   // construct scan index key
   KeyType index_key;
@@ -48,13 +52,76 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   container_.GetValue(index_key, result, transaction);
 }
 
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanRange(const Tuple *lo, const Tuple *hi, bool reverse, size_t limit,
+                                     std::vector<RID> *result, Transaction *transaction) {
+  VisitRange(lo, hi, reverse, limit,
+             [result](const KeyType &key, const ValueType &value) { result->push_back(value); });
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanRangeEntries(const Tuple *lo, const Tuple *hi, bool reverse, size_t limit,
+                                            std::vector<std::pair<Tuple, RID>> *result, Transaction *transaction) {
+  auto *entry_schema = GetEntrySchema();
+  std::vector<Value> values(entry_schema->GetColumnCount());
+  VisitRange(lo, hi, reverse, limit, [&](const KeyType &key, const ValueType &value) {
+    for (uint32_t i = 0; i < values.size(); i++) {
+      values[i] = key.ToValue(entry_schema, i);
+    }
+    result->emplace_back(Tuple(values, entry_schema), value);
+  });
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+template <typename Visitor>
+void BPLUSTREE_INDEX_TYPE::VisitRange(const Tuple *lo, const Tuple *hi, bool reverse, size_t limit, Visitor &&visit) {
+  // construct the bounds of the scan
+  KeyType lo_key;
+  KeyType hi_key;
+  if (lo != nullptr) {
+    lo_key.SetFromKey(*lo);
+  }
+  if (hi != nullptr) {
+    hi_key.SetFromKey(*hi);
+  }
+
+  if (limit == 0) {
+    return;
+  }
+  size_t count = 0;
+  auto visit_batch = [&](const auto &batch) {
+    for (const auto &entry : batch) {
+      visit(entry.first, entry.second);
+      if (++count == limit) {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (reverse) {
+    container_.ReverseScan(lo == nullptr ? nullptr : &lo_key, hi == nullptr ? nullptr : &hi_key, visit_batch);
+  } else {
+    container_.Scan(lo == nullptr ? nullptr : &lo_key, hi == nullptr ? nullptr : &hi_key, visit_batch);
+  }
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries, Transaction *transaction) {
+  // stable, so that of equal keys the first entry wins as it would with one InsertEntry() per entry
+  std::stable_sort(entries->begin(), entries->end(),
+                   [this](const auto &lhs, const auto &rhs) { return comparator_(lhs.first, rhs.first) < 0; });
+  if (!container_.BulkLoad(entries->cbegin(), entries->cend(), BULK_LOAD_FILL_FACTOR)) {
+    throw Exception(ExceptionType::EXECUTION, "cannot bulk load a non-empty index");
+  }
+}
+
+BPLUSTREE_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetBeginIterator() -> INDEXITERATOR_TYPE { return container_.Begin(); }
 
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE { return container_.Begin(key); }
 
-INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetEndIterator() -> INDEXITERATOR_TYPE { return container_.End(); }
 
 template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
@@ -63,4 +130,22 @@ template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>,
+                              BPlusTreeCompressedInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>>;
+template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>,
+                              BPlusTreeCompressedInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>>;
+template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>,
+                              BPlusTreeCompressedInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>>;
+template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>,
+                              BPlusTreeCompressedInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>>;
+template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>,
+                              BPlusTreeCompressedInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>>;
+
+template class BPlusTreeIndex<VarlenKey<256>, RID, VarlenComparator<256>,
+                              BPlusTreeInternalPage<VarlenKey<256>, page_id_t, VarlenComparator<256>>,
+                              BPlusTreeSlottedLeafPage<VarlenKey<256>, RID, VarlenComparator<256>>>;
+template class BPlusTreeIndex<VarlenKey<256>, RID, VarlenComparator<256>,
+                              BPlusTreeCompressedInternalPage<VarlenKey<256>, page_id_t, VarlenComparator<256>>,
+                              BPlusTreeSlottedLeafPage<VarlenKey<256>, RID, VarlenComparator<256>>>;
+
 }  // namespace bustub
@@ -5,26 +5,153 @@
 
 #include "storage/index/index_iterator.h"
 
+#include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/index/varlen_key.h"
+#include "storage/page/b_plus_tree_slotted_leaf_page.h"
+
 namespace bustub {
 
 /*
  * NOTE: you can change the destructor/constructor method here
  * set your own input parameters
  */
-INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
-INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
+INDEXITERATOR_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index, LocateFunction locate)
+    : bpm_(bpm), guard_(std::move(guard)), leaf_(guard_.As<LeafPage>()), index_(index), locate_(std::move(locate)) {
+  SkipExhaustedLeaves();
+}
+
+INDEXITERATOR_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::~IndexIterator() { Release(); }  // NOLINT
+
+INDEXITERATOR_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&that) noexcept
+    : bpm_(that.bpm_),
+      guard_(std::move(that.guard_)),
+      leaf_(that.leaf_),
+      index_(that.index_),
+      locate_(std::move(that.locate_)) {
+  that.leaf_ = nullptr;
+  that.index_ = 0;
+}
+
+INDEXITERATOR_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator=(IndexIterator &&that) noexcept -> INDEXITERATOR_TYPE & {
+  if (this != &that) {
+    Release();
+    bpm_ = that.bpm_;
+    guard_ = std::move(that.guard_);
+    leaf_ = that.leaf_;
+    index_ = that.index_;
+    locate_ = std::move(that.locate_);
+    that.leaf_ = nullptr;
+    that.index_ = 0;
+  }
+  return *this;
+}
+
+INDEXITERATOR_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::IsEnd() -> bool { return !guard_.IsValid(); }
 
-INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool { throw std::runtime_error("unimplemented"); }
+INDEXITERATOR_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator*() -> ReferenceType {
+  BUSTUB_ASSERT(!IsEnd(), "dereferencing the end iterator");
+  return leaf_->GetItem(index_);
+}
 
-INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { throw std::runtime_error("unimplemented"); }
+INDEXITERATOR_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
+  if (!IsEnd()) {
+    index_++;
+    SkipExhaustedLeaves();
+  }
+  return *this;
+}
 
-INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & { throw std::runtime_error("unimplemented"); }
+INDEXITERATOR_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator--() -> INDEXITERATOR_TYPE & {
+  if (IsEnd()) {
+    return *this;
+  }
+  if (index_ > 0) {
+    index_--;
+  } else {
+    StepBack(leaf_->KeyAt(0));
+  }
+  return *this;
+}
+
+INDEXITERATOR_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::StepBack(const KeyType &key) {
+  while (guard_.IsValid()) {
+    page_id_t page_id = guard_.PageId();
+    page_id_t prev_page_id = leaf_->GetPrevPageId();
+    if (prev_page_id == INVALID_PAGE_ID) {
+      Release();
+      return;
+    }
+    // Pin the previous leaf before letting go of this one, so it cannot be freed by a merge in between.
+    auto prev_guard = bpm_->FetchPageBasic(prev_page_id);
+    Release();
+    if (!prev_guard.IsValid()) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame for the previous b+ tree leaf");
+    }
+    guard_ = prev_guard.UpgradeRead();
+    leaf_ = guard_.As<LeafPage>();
+    if (leaf_->GetNextPageId() == page_id || !locate_) {
+      // the leaves are still linked as they were: continue at the end of the previous leaf, unless it is empty
+      index_ = leaf_->GetSize() - 1;
+      if (index_ >= 0) {
+        return;
+      }
+      continue;
+    }
+
+    // The previous leaf was split, or merged into, while no latch was held. Find the leaf the key belongs to now.
+    Release();
+    auto [guard, index] = locate_(key);
+    if (!guard.IsValid()) {
+      return;
+    }
+    guard_ = std::move(guard);
+    leaf_ = guard_.As<LeafPage>();
+    if (index > 0) {
+      index_ = index - 1;
+      return;
+    }
+  }
+}
+
+INDEXITERATOR_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeaves() {
+  while (guard_.IsValid() && index_ >= leaf_->GetSize()) {
+    page_id_t next_page_id = leaf_->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      Release();
+      return;
+    }
+    // Pin the next leaf before letting go of this one, so it cannot be freed by a merge in between.
+    auto next_guard = bpm_->FetchPageBasic(next_page_id);
+    Release();
+    if (!next_guard.IsValid()) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame for the next b+ tree leaf");
+    }
+    guard_ = next_guard.UpgradeRead();
+    leaf_ = guard_.As<LeafPage>();
+  }
+}
+
+INDEXITERATOR_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Release() {
+  guard_.Drop();
+  leaf_ = nullptr;
+  index_ = 0;
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
@@ -36,4 +163,7 @@ template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class IndexIterator<VarlenKey<256>, RID, VarlenComparator<256>,
+                             BPlusTreeSlottedLeafPage<VarlenKey<256>, RID, VarlenComparator<256>>>;
+
 }  // namespace bustub
@@ -0,0 +1,481 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_compressed_internal_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_compressed_internal_page.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/index/varlen_key.h"
+#include "storage/page/b_plus_tree_compressed_internal_page.h"
+
+namespace bustub {
+namespace {
+/** Point the parent id of a child page at its new parent. */
+void AdoptChild(page_id_t child_page_id, page_id_t parent_page_id, BufferPoolManager *buffer_pool_manager) {
+  auto guard = buffer_pool_manager->FetchPageBasic(child_page_id);
+  if (!guard.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to update a b+ tree child");
+  }
+  guard.AsMut<BPlusTreePage>()->SetParentPageId(parent_page_id);
+}
+}  // namespace
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+/*
+ * The left key orders before the right one, so their normalized forms differ at
+ * the first byte after their common prefix; that byte of the right key is the
+ * last one the separator needs.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::MakeSeparator(const KeyType &left, const KeyType &right,
+                                                              const KeyComparator &comparator) -> SeparatorType {
+  SeparatorType separator = comparator.Normalize(right);
+  separator.Truncate(comparator.Normalize(left).CommonPrefix(separator) + 1);
+  return separator;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetSize(0);
+  SetPageId(page_id);
+  SetParentPageId(parent_id);
+  SetMaxSize(max_size);
+  prefix_size_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> SeparatorType {
+  SeparatorType key;
+  size_t length;
+  const char *bytes = StoredBytes(index, GetSize(), &length);
+  if (index > 0) {
+    key.Assign(Heap(), prefix_size_);
+  }
+  key.Append(bytes, length);
+  return key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const SeparatorType &key) {
+  auto entries = Entries();
+  entries[index].first = key;
+  Assign(entries);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return Values()[index]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  Values()[index] = value;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
+  for (int i = 0; i < GetSize(); i++) {
+    if (Values()[i] == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::StoredBytes(int index, int size, size_t *length) const
+    -> const char * {
+  const size_t capacity = BUSTUB_PAGE_SIZE - COMPRESSED_INTERNAL_PAGE_HEADER_SIZE - HeapOffset(size);
+  const auto *ends = reinterpret_cast<const uint16_t *>(data_ + EndsOffset(size));
+  const size_t end = std::min<size_t>(ends[index], capacity);
+  const size_t begin = std::min<size_t>(index == 0 ? prefix_size_ : ends[index - 1], end);
+  *length = std::min(end - begin, SeparatorType::Capacity());
+  return data_ + HeapOffset(size) + begin;
+}
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+/*
+ * Every separator starts with the prefix, so a probe that orders before or
+ * after the prefix (and does not start with it) goes to the first or the last
+ * child. Otherwise only the rest of the probe is compared against the suffixes.
+ * Readers may run this on a torn page; sizes are clamped so that it stays on
+ * the page, and the caller validates the result.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::Lookup(const SeparatorType &probe,
+                                                       const KeyComparator &comparator) const -> ValueType {
+  const int size = std::clamp<int>(GetSize(), 1, COMPRESSED_INTERNAL_PAGE_SIZE);
+  const char *heap = data_ + HeapOffset(size);
+  const size_t capacity = BUSTUB_PAGE_SIZE - COMPRESSED_INTERNAL_PAGE_HEADER_SIZE - HeapOffset(size);
+  const size_t prefix_size = std::min({static_cast<size_t>(prefix_size_), SeparatorType::Capacity(), capacity});
+  int cmp = memcmp(probe.Data(), heap, std::min(probe.Size(), prefix_size));
+  if (cmp < 0 || (cmp == 0 && probe.Size() < prefix_size)) {
+    return Values()[0];
+  }
+  if (cmp > 0) {
+    return Values()[size - 1];
+  }
+
+  const char *rest = probe.Data() + prefix_size;
+  const size_t rest_size = probe.Size() - prefix_size;
+  // find the last index whose separator is <= probe
+  int left = 1;
+  int right = size - 1;
+  while (left <= right) {
+    int mid = left + (right - left) / 2;
+    size_t length;
+    const char *suffix = StoredBytes(mid, size, &length);
+    cmp = memcmp(suffix, rest, std::min(length, rest_size));
+    if (cmp < 0 || (cmp == 0 && length <= rest_size)) {
+      left = mid + 1;
+    } else {
+      right = mid - 1;
+    }
+  }
+  return Values()[left - 1];
+}
+
+/*****************************************************************************
+ * INSERTION AND REMOVAL
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value,
+                                                                const SeparatorType &new_key,
+                                                                const ValueType &new_value) {
+  Assign({{SeparatorType{}, old_value}, {new_key, new_value}});
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::InsertNodeAt(int index, const SeparatorType &new_key,
+                                                             const ValueType &new_value) -> int {
+  auto entries = Entries();
+  entries.emplace(entries.begin() + index, new_key, new_value);
+  Assign(entries);
+  return GetSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::Remove(int index) {
+  auto entries = Entries();
+  entries.erase(entries.begin() + index);
+  Assign(entries);
+}
+
+/*****************************************************************************
+ * SPACE MANAGEMENT
+ *****************************************************************************/
+/*
+ * A new separator can at worst be a whole key and, if it lands before or after
+ * all others, shrink the shared prefix to nothing, which adds the prefix back
+ * to every stored suffix.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::IsInsertSafe() const -> bool {
+  const size_t worst_size = UsedSize() + sizeof(ValueType) + sizeof(uint16_t) + SeparatorType::Capacity() +
+                            static_cast<size_t>(std::max(GetSize() - 1, 0)) * prefix_size_;
+  return GetSize() < GetMaxSize() && worst_size <= BUSTUB_PAGE_SIZE;
+}
+
+/*
+ * Removing a separator can grow the shared prefix and so shrink the page by
+ * more than the separator, so every separator is tried.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::IsRemoveSafe() const -> bool {
+  if (GetSize() - 1 >= GetMinSize()) {
+    return true;
+  }
+  RangeSizes sizes(Entries());
+  for (int i = 1; i < GetSize(); i++) {
+    if (sizes.PageSizeWithout(i) * 2 < BUSTUB_PAGE_SIZE) {
+      return false;
+    }
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::IsUnderfull() const -> bool {
+  return GetSize() < GetMinSize() && UsedSize() * 2 < BUSTUB_PAGE_SIZE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::CanInsertAt(int index, const SeparatorType &key) const -> bool {
+  auto entries = Entries();
+  entries.emplace(entries.begin() + index, key, ValueType{});
+  return Fits(entries);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::CanSetKeyAt(int index, const SeparatorType &key) const -> bool {
+  auto entries = Entries();
+  entries[index].first = key;
+  return Fits(entries);
+}
+
+/*
+ * Of the ways to split the entries, counting the new one, into two pages that
+ * both fit, pick the one whose bigger page is smallest.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::SplitSize(int index, const SeparatorType &key) const -> int {
+  auto entries = Entries();
+  entries.emplace(entries.begin() + index, key, ValueType{});
+  RangeSizes sizes(entries);
+  const int size = static_cast<int>(entries.size());
+  int best_size = (size + 1) / 2;
+  size_t best_bytes = std::numeric_limits<size_t>::max();
+  for (int left_size = 1; left_size < size; left_size++) {
+    if (left_size > GetMaxSize() || size - left_size > GetMaxSize()) {
+      continue;
+    }
+    const size_t bytes = std::max(sizes.PageSize(0, left_size), sizes.PageSize(left_size, size));
+    if (bytes <= BUSTUB_PAGE_SIZE && bytes < best_bytes) {
+      best_size = left_size;
+      best_bytes = bytes;
+    }
+  }
+  return best_size;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::CanMerge(const BPlusTreeCompressedInternalPage *right,
+                                                         const SeparatorType &middle_key) const -> bool {
+  auto entries = Entries();
+  auto right_entries = right->Entries();
+  right_entries[0].first = middle_key;
+  entries.insert(entries.end(), right_entries.begin(), right_entries.end());
+  return Fits(entries);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::CanMoveFirstToEndOf(const BPlusTreeCompressedInternalPage *recipient,
+                                                                    const SeparatorType &middle_key) const -> bool {
+  auto entries = Entries();
+  auto recipient_entries = recipient->Entries();
+  recipient_entries.emplace_back(middle_key, entries.front().second);
+  entries.erase(entries.begin());
+  return !IsUnderfull(entries) && recipient->Fits(recipient_entries);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::CanMoveLastToFrontOf(const BPlusTreeCompressedInternalPage *recipient,
+                                                                     const SeparatorType &middle_key) const -> bool {
+  auto entries = Entries();
+  auto recipient_entries = recipient->Entries();
+  recipient_entries[0].first = middle_key;
+  recipient_entries.insert(recipient_entries.begin(), entries.back());
+  entries.pop_back();
+  return !IsUnderfull(entries) && recipient->Fits(recipient_entries);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::IsFilledTo(double fill_factor) const -> bool {
+  return static_cast<double>(UsedSize()) >= fill_factor * BUSTUB_PAGE_SIZE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::EncodedSize(const std::vector<Entry> &entries) -> size_t {
+  size_t size = COMPRESSED_INTERNAL_PAGE_HEADER_SIZE + HeapOffset(entries.size());
+  if (entries.empty()) {
+    return size;
+  }
+  const size_t prefix_size = SharedPrefix(entries);
+  size += prefix_size + entries[0].first.Size();
+  for (size_t i = 1; i < entries.size(); i++) {
+    size += entries[i].first.Size() - prefix_size;
+  }
+  return size;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::SharedPrefix(const std::vector<Entry> &entries) -> size_t {
+  if (entries.size() < 2) {
+    return 0;
+  }
+  size_t prefix_size = entries[1].first.Size();
+  for (size_t i = 2; i < entries.size() && prefix_size > 0; i++) {
+    prefix_size = std::min(prefix_size, entries[1].first.CommonPrefix(entries[i].first));
+  }
+  return prefix_size;
+}
+
+/*
+ * The prefix a set of separators shares is the shortest prefix any of them
+ * shares with one member of the set.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::RangeSizes::RangeSizes(const std::vector<Entry> &entries)
+    : head_prefix_(entries.size()), tail_prefix_(entries.size() + 1), key_sizes_(entries.size() + 1) {
+  const size_t size = entries.size();
+  for (size_t i = 0; i < size; i++) {
+    key_sizes_[i + 1] = key_sizes_[i] + entries[i].first.Size();
+  }
+  for (size_t i = 1; i < size; i++) {
+    head_prefix_[i] = i == 1 ? entries[1].first.Size()
+                             : std::min(head_prefix_[i - 1], entries[1].first.CommonPrefix(entries[i].first));
+  }
+  for (size_t i = size - 1; i >= 1 && i < size; i--) {
+    tail_prefix_[i] = i == size - 1
+                          ? entries[i].first.Size()
+                          : std::min(tail_prefix_[i + 1], entries[size - 1].first.CommonPrefix(entries[i].first));
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::RangeSizes::PageSize(size_t first, size_t last) const -> size_t {
+  const size_t prefix_size = last - first < 2 ? 0 : first == 0 ? head_prefix_[last - 1] : tail_prefix_[first + 1];
+  return PageSize(last - first, key_sizes_[first + 1] - key_sizes_[first], key_sizes_[last] - key_sizes_[first + 1],
+                  prefix_size);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::RangeSizes::PageSizeWithout(size_t index) const -> size_t {
+  const size_t size = key_sizes_.size() - 1;
+  size_t prefix_size = std::numeric_limits<size_t>::max();
+  if (index > 1) {
+    prefix_size = head_prefix_[index - 1];
+  }
+  if (index + 1 < size) {
+    prefix_size = std::min(prefix_size, tail_prefix_[index + 1]);
+  }
+  const size_t separators_size = key_sizes_[size] - key_sizes_[1] - (key_sizes_[index + 1] - key_sizes_[index]);
+  return PageSize(size - 1, key_sizes_[1], separators_size, size > 2 ? prefix_size : 0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::RangeSizes::PageSize(size_t num_entries, size_t first_key_size,
+                                                                      size_t separators_size, size_t prefix_size)
+    -> size_t {
+  // the prefix is stored once instead of once per separator
+  const size_t saved = num_entries < 2 ? 0 : (num_entries - 2) * prefix_size;
+  return COMPRESSED_INTERNAL_PAGE_HEADER_SIZE + HeapOffset(num_entries) + first_key_size + separators_size - saved;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::IsUnderfull(const std::vector<Entry> &entries) const -> bool {
+  return static_cast<int>(entries.size()) < GetMinSize() && EncodedSize(entries) * 2 < BUSTUB_PAGE_SIZE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::Fits(const std::vector<Entry> &entries) const -> bool {
+  return static_cast<int>(entries.size()) <= GetMaxSize() && EncodedSize(entries) <= BUSTUB_PAGE_SIZE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::UsedSize() const -> size_t {
+  const int size = GetSize();
+  return COMPRESSED_INTERNAL_PAGE_HEADER_SIZE + HeapOffset(size) + (size == 0 ? 0 : Ends()[size - 1]);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::Entries() const -> std::vector<Entry> {
+  std::vector<Entry> entries(GetSize());
+  for (int i = 0; i < GetSize(); i++) {
+    entries[i] = {KeyAt(i), Values()[i]};
+  }
+  return entries;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::Assign(const std::vector<Entry> &entries) {
+  BUSTUB_ASSERT(EncodedSize(entries) <= BUSTUB_PAGE_SIZE, "compressed internal page overflow");
+  const size_t size = entries.size();
+  const size_t prefix_size = SharedPrefix(entries);
+  SetSize(static_cast<int>(size));
+  prefix_size_ = static_cast<uint16_t>(prefix_size);
+  auto *ends = reinterpret_cast<uint16_t *>(data_ + EndsOffset(size));
+  char *heap = data_ + HeapOffset(size);
+  size_t end = 0;
+  if (size > 1) {
+    memcpy(heap, entries[1].first.Data(), prefix_size);
+    end = prefix_size;
+  }
+  for (size_t i = 0; i < size; i++) {
+    Values()[i] = entries[i].second;
+    const size_t skip = i == 0 ? 0 : prefix_size;
+    memcpy(heap + end, entries[i].first.Data() + skip, entries[i].first.Size() - skip);
+    end += entries[i].first.Size() - skip;
+    ends[i] = static_cast<uint16_t>(end);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::Append(const std::vector<Entry> &entries,
+                                                       BufferPoolManager *buffer_pool_manager) {
+  auto all_entries = Entries();
+  all_entries.insert(all_entries.end(), entries.begin(), entries.end());
+  Assign(all_entries);
+  for (const auto &entry : entries) {
+    AdoptChild(entry.second, GetPageId(), buffer_pool_manager);
+  }
+}
+
+/*****************************************************************************
+ * SPLIT, MERGE AND REDISTRIBUTE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::MoveLatterHalfTo(BPlusTreeCompressedInternalPage *recipient,
+                                                                 int start_index,
+                                                                 BufferPoolManager *buffer_pool_manager) {
+  auto entries = Entries();
+  recipient->Append(std::vector<Entry>(entries.begin() + start_index, entries.end()), buffer_pool_manager);
+  entries.resize(start_index);
+  Assign(entries);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeCompressedInternalPage *recipient,
+                                                          const SeparatorType &middle_key,
+                                                          BufferPoolManager *buffer_pool_manager) {
+  auto entries = Entries();
+  entries[0].first = middle_key;
+  recipient->Append(entries, buffer_pool_manager);
+  Assign({});
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeCompressedInternalPage *recipient,
+                                                                 const SeparatorType &middle_key,
+                                                                 BufferPoolManager *buffer_pool_manager) {
+  auto entries = Entries();
+  recipient->Append({{middle_key, entries[0].second}}, buffer_pool_manager);
+  entries.erase(entries.begin());
+  Assign(entries);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_COMPRESSED_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeCompressedInternalPage *recipient,
+                                                                  const SeparatorType &middle_key,
+                                                                  BufferPoolManager *buffer_pool_manager) {
+  auto entries = Entries();
+  auto recipient_entries = recipient->Entries();
+  recipient_entries[0].first = middle_key;
+  recipient_entries.insert(recipient_entries.begin(), entries.back());
+  recipient->Assign(recipient_entries);
+  AdoptChild(entries.back().second, recipient->GetPageId(), buffer_pool_manager);
+  entries.pop_back();
+  Assign(entries);
+}
+
+template class BPlusTreeCompressedInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
+template class BPlusTreeCompressedInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+template class BPlusTreeCompressedInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
+template class BPlusTreeCompressedInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
+template class BPlusTreeCompressedInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+template class BPlusTreeCompressedInternalPage<VarlenKey<256>, page_id_t, VarlenComparator<256>>;
+}  // namespace bustub
@@ -9,13 +9,27 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
 #include "common/exception.h"
+#include "storage/index/key_search.h"
+#include "storage/index/varlen_key.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 
 namespace bustub {
+namespace {
+/** Point the parent id of a child page at its new parent. */
+void AdoptChild(page_id_t child_page_id, page_id_t parent_page_id, BufferPoolManager *buffer_pool_manager) {
+  auto guard = buffer_pool_manager->FetchPageBasic(child_page_id);
+  if (!guard.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to update a b+ tree child");
+  }
+  guard.AsMut<BPlusTreePage>()->SetParentPageId(parent_page_id);
+}
+}  // namespace
+
 /*****************************************************************************
  * HELPER METHODS AND UTILITIES
  *****************************************************************************/
@@ -25,27 +39,268 @@ namespace bustub {
  * max page size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {}
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetSize(0);
+  SetPageId(page_id);
+  SetParentPageId(parent_id);
+  SetMaxSize(max_size);
+}
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  KeyType key{};
-  return key;
-}
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {}
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
 
 /*
- * Helper method to get the value associated with input "index"(a.k.a array
+ * Helper method to get/set the value associated with input "index"(a.k.a array
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return 0; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { array_[index].second = value; }
+
+/*
+ * Helper method to find and return array index(or offset), so that its value
+ * equals to input "value"
+ * @return: the index, or -1 if no child pointer equals value
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
+  for (int i = 0; i < GetSize(); i++) {
+    if (array_[i].second == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+/*
+ * Find and return the child pointer(page_id) which points to the child page
+ * that contains input "key"
+ * Start the search from the second key(the first key should always be invalid)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType {
+  // the child before the first key that is > key, the first key being invalid
+  int index = KeySearch<KeyType, KeyComparator>::UpperBound(array_, 1, GetSize(), key, comparator);
+  return array_[index - 1].second;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * Populate new root page with old_value + new_key & new_value
+ * When the insertion cause overflow from leaf page all the way upto the root
+ * page, you should create a new root page and populate its elements.
+ * NOTE: This method is only called within InsertIntoParent()(b_plus_tree.cpp)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
+                                                     const ValueType &new_value) {
+  array_[0].second = old_value;
+  array_[1].first = new_key;
+  array_[1].second = new_value;
+  SetSize(2);
+}
+
+/*
+ * Insert new_key & new_value pair right after the pair with its value ==
+ * old_value
+ * @return:  new size after insertion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value, const KeyType &new_key,
+                                                     const ValueType &new_value) -> int {
+  return InsertNodeAt(ValueIndex(old_value) + 1, new_key, new_value);
+}
+
+/*
+ * Insert new_key & new_value pair at position index, shifting the later pairs
+ * @return:  new size after insertion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAt(int index, const KeyType &new_key, const ValueType &new_value)
+    -> int {
+  std::move_backward(array_ + index, array_ + GetSize(), array_ + GetSize() + 1);
+  array_[index].first = new_key;
+  array_[index].second = new_value;
+  IncreaseSize(1);
+  return GetSize();
+}
+
+/*****************************************************************************
+ * SPACE MANAGEMENT
+ *****************************************************************************/
+/*
+ * Every entry takes the same space, so whether a page has room only depends on
+ * its size: it holds up to max size entries and is underfull below min size.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsInsertSafe() const -> bool { return GetSize() < GetMaxSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsRemoveSafe() const -> bool { return GetSize() > GetMinSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsUnderfull() const -> bool { return GetSize() < GetMinSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanInsertAt(int index, const KeyType &key) const -> bool {
+  return GetSize() < GetMaxSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanSetKeyAt(int index, const KeyType &key) const -> bool { return true; }
+
+/*
+ * Number of entries a full page keeps when it splits to take key at index:
+ * counting the new entry, the left half keeps ceil(n / 2) entries.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::SplitSize(int index, const KeyType &key) const -> int {
+  return (GetSize() + 2) / 2;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanMerge(const BPlusTreeInternalPage *right, const KeyType &middle_key) const
+    -> bool {
+  return GetSize() + right->GetSize() <= GetMaxSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanMoveFirstToEndOf(const BPlusTreeInternalPage *recipient,
+                                                         const KeyType &middle_key) const -> bool {
+  return IsRemoveSafe() && recipient->GetSize() < recipient->GetMaxSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanMoveLastToFrontOf(const BPlusTreeInternalPage *recipient,
+                                                          const KeyType &middle_key) const -> bool {
+  return IsRemoveSafe() && recipient->GetSize() < recipient->GetMaxSize();
+}
+
+/*****************************************************************************
+ * SPLIT
+ *****************************************************************************/
+/*
+ * Move the entries from start_index on to the (empty) recipient page. The key
+ * of the first moved entry becomes the recipient's invalid first key; the
+ * caller pushes it up as the separator.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLatterHalfTo(BPlusTreeInternalPage *recipient, int start_index,
+                                                      BufferPoolManager *buffer_pool_manager) {
+  recipient->CopyNFrom(array_ + start_index, GetSize() - start_index, buffer_pool_manager);
+  SetSize(start_index);
+}
+
+/* Copy entries into me, starting from {items} and copy {size} entries.
+ * Since it is an internal page, for all entries (pages) moved, their parents page
+ * now changes to me.
+ * So I need to 'adopt' them by changing their parent page id, which needs to be
+ * persisted with BufferPoolManger
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager) {
+  std::copy(items, items + size, array_ + GetSize());
+  for (int i = 0; i < size; i++) {
+    AdoptChild(items[i].second, GetPageId(), buffer_pool_manager);
+  }
+  IncreaseSize(size);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Remove the key & value pair in internal page according to input index(a.k.a
+ * array offset)
+ * NOTE: store key&value pair continuously after deletion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
+  std::move(array_ + index + 1, array_ + GetSize(), array_ + index);
+  IncreaseSize(-1);
+}
+
+/*****************************************************************************
+ * MERGE
+ *****************************************************************************/
+/*
+ * Remove all of key & value pairs from this page to "recipient" page.
+ * The middle_key is the separation key you should get from the parent. You need
+ * to make sure the middle key is added to the recipient to maintain the invariant.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                                               BufferPoolManager *buffer_pool_manager) {
+  SetKeyAt(0, middle_key);
+  recipient->CopyNFrom(array_, GetSize(), buffer_pool_manager);
+  SetSize(0);
+}
+
+/*****************************************************************************
+ * REDISTRIBUTE
+ *****************************************************************************/
+/*
+ * Remove the first key & value pair from this page to tail of "recipient" page.
+ * The middle_key is the separation key you should get from the parent. You need
+ * to make sure the middle key is added to the recipient to maintain the invariant.
+ * Afterwards the new first key of this page (KeyAt(0)) is the new separator.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                                                      BufferPoolManager *buffer_pool_manager) {
+  SetKeyAt(0, middle_key);
+  recipient->CopyLastFrom(array_[0], buffer_pool_manager);
+  Remove(0);
+}
+
+/* Append an entry at the end.
+ * Since it is an internal page, the moved entry(page)'s parent needs to be updated.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager) {
+  array_[GetSize()] = pair;
+  AdoptChild(pair.second, GetPageId(), buffer_pool_manager);
+  IncreaseSize(1);
+}
+
+/*
+ * Remove the last key & value pair from this page to head of "recipient" page.
+ * The middle_key from the parent becomes the key of the recipient's old first
+ * child, so the recipient's invariant holds.
+ * Afterwards the recipient's first key (KeyAt(0)) is the new separator.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                                                       BufferPoolManager *buffer_pool_manager) {
+  recipient->SetKeyAt(0, middle_key);
+  recipient->CopyFirstFrom(array_[GetSize() - 1], buffer_pool_manager);
+  IncreaseSize(-1);
+}
+
+/* Append an entry at the beginning.
+ * Since it is an internal page, the moved entry(page)'s parent needs to be updated.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager) {
+  std::move_backward(array_, array_ + GetSize(), array_ + GetSize() + 1);
+  array_[0] = pair;
+  AdoptChild(pair.second, GetPageId(), buffer_pool_manager);
+  IncreaseSize(1);
+}
 
 // valuetype for internalNode should be page id_t
 template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
@@ -53,4 +308,5 @@ template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator
 template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
 template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+template class BPlusTreeInternalPage<VarlenKey<256>, page_id_t, VarlenComparator<256>>;
 }  // namespace bustub
@@ -9,10 +9,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <sstream>
 
 #include "common/exception.h"
 #include "common/rid.h"
+#include "storage/index/key_search.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -24,29 +26,212 @@ namespace bustub {
 /**
  * Init method after creating a new leaf page
  * Including set page type, set current size to zero, set page id/parent id, set
- * next page id and set max size
+ * next/prev page id and set max size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {}
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetSize(0);
+  SetPageId(page_id);
+  SetParentPageId(parent_id);
+  SetNextPageId(INVALID_PAGE_ID);
+  SetPrevPageId(INVALID_PAGE_ID);
+  SetMaxSize(max_size);
+}
 
 /**
  * Helper methods to set/get next page id
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return INVALID_PAGE_ID; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+/**
+ * Helper methods to set/get prev page id
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrevPageId() const -> page_id_t { return prev_page_id_; }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {}
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) { prev_page_id_ = prev_page_id; }
 
 /*
  * Helper method to find and return the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  KeyType key{};
-  return key;
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+
+/*
+ * Helper method to find and return the key & value pair associated with input
+ * "index"(a.k.a array offset)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) const -> const MappingType & { return array_[index]; }
+
+/**
+ * Helper method to find the first index i so that array_[i].first >= key
+ * NOTE: This method is only used when generating index iterator
+ * @return: GetSize() if every key is smaller than key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  return KeySearch<KeyType, KeyComparator>::LowerBound(array_, 0, GetSize(), key, comparator);
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * Insert key & value pair into leaf page ordered by key
+ * @return  page size after insertion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator)
+    -> int {
+  int index = KeyIndex(key, comparator);
+  std::move_backward(array_ + index, array_ + GetSize(), array_ + GetSize() + 1);
+  array_[index].first = key;
+  array_[index].second = value;
+  IncreaseSize(1);
+  return GetSize();
+}
+
+/*****************************************************************************
+ * SPACE MANAGEMENT
+ *****************************************************************************/
+/*
+ * A leaf splits once an insert would take it to its max size.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsInsertSafe() const -> bool { return GetSize() + 1 < GetMaxSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsRemoveSafe() const -> bool { return GetSize() > GetMinSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsUnderfull() const -> bool { return GetSize() < GetMinSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::CanInsert(const KeyType &key) const -> bool { return GetSize() + 1 < GetMaxSize(); }
+
+/*
+ * @return the number of entries, counting the new one, the left page keeps on a split
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::SplitSize(int index, const KeyType &key) const -> int { return (GetSize() + 1) / 2; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::CanMerge(const BPlusTreeLeafPage *right) const -> bool {
+  return GetSize() + right->GetSize() < GetMaxSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::CanMoveFirstToEndOf(const BPlusTreeLeafPage *recipient) const -> bool {
+  return IsRemoveSafe() && recipient->IsInsertSafe();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::CanMoveLastToFrontOf(const BPlusTreeLeafPage *recipient) const -> bool {
+  return IsRemoveSafe() && recipient->IsInsertSafe();
+}
+
+/*****************************************************************************
+ * SPLIT
+ *****************************************************************************/
+/*
+ * Remove the key & value pairs from start_index on from this page to "recipient" page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLatterHalfTo(BPlusTreeLeafPage *recipient, int start_index) {
+  std::copy(array_ + start_index, array_ + GetSize(), recipient->array_ + recipient->GetSize());
+  recipient->IncreaseSize(GetSize() - start_index);
+  SetSize(start_index);
+}
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+/*
+ * For the given key, check to see whether it exists in the leaf page. If it
+ * does, then store its corresponding value in input "value" and return true.
+ * If the key does not exist, then return false
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const
+    -> bool {
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(array_[index].first, key) != 0) {
+    return false;
+  }
+  *value = array_[index].second;
+  return true;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * First look through leaf page to see whether delete key exist or not. If
+ * exist, perform deletion, otherwise return immediately.
+ * NOTE: store key&value pair continuously after deletion
+ * @return   page size after deletion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) -> int {
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(array_[index].first, key) != 0) {
+    return GetSize();
+  }
+  std::move(array_ + index + 1, array_ + GetSize(), array_ + index);
+  IncreaseSize(-1);
+  return GetSize();
+}
+
+/*****************************************************************************
+ * MERGE
+ *****************************************************************************/
+/*
+ * Remove all of key & value pairs from this page to "recipient" page. Don't forget
+ * to update the next_page id in the sibling page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
+  std::copy(array_, array_ + GetSize(), recipient->array_ + recipient->GetSize());
+  recipient->IncreaseSize(GetSize());
+  recipient->SetNextPageId(GetNextPageId());
+  SetSize(0);
+}
+
+/*****************************************************************************
+ * REDISTRIBUTE
+ *****************************************************************************/
+/*
+ * Remove the first key & value pair from this page to "recipient" page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
+  recipient->array_[recipient->GetSize()] = array_[0];
+  recipient->IncreaseSize(1);
+  std::move(array_ + 1, array_ + GetSize(), array_);
+  IncreaseSize(-1);
+}
+
+/*
+ * Remove the last key & value pair from this page to "recipient" page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
+  std::move_backward(recipient->array_, recipient->array_ + recipient->GetSize(),
+                     recipient->array_ + recipient->GetSize() + 1);
+  recipient->array_[0] = array_[GetSize() - 1];
+  recipient->IncreaseSize(1);
+  IncreaseSize(-1);
 }
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
@@ -0,0 +1,310 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_slotted_leaf_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_slotted_leaf_page.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/rid.h"
+#include "storage/index/varlen_key.h"
+#include "storage/page/b_plus_tree_slotted_leaf_page.h"
+
+namespace bustub {
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetSize(0);
+  SetPageId(page_id);
+  SetParentPageId(parent_id);
+  SetNextPageId(INVALID_PAGE_ID);
+  SetPrevPageId(INVALID_PAGE_ID);
+  SetMaxSize(max_size);
+  keys_begin_ = BUSTUB_PAGE_SIZE;
+  free_key_bytes_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::GetPrevPageId() const -> page_id_t { return prev_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) { prev_page_id_ = prev_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
+  KeyType key;
+  key.Assign(KeyData(index), slots_[index].size_);
+  return key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return slots_[index].value_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::GetItem(int index) const -> MappingType {
+  return {KeyAt(index), ValueAt(index)};
+}
+
+/**
+ * Helper method to find the first index i so that KeyAt(i) >= key
+ * @return: GetSize() if every key is smaller than key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  int left = 0;
+  int right = GetSize();
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (comparator(KeyAt(mid), key) < 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::UsedSize() const -> size_t {
+  return SLOTTED_LEAF_PAGE_HEADER_SIZE + GetSize() * sizeof(Slot) + (BUSTUB_PAGE_SIZE - keys_begin_) -
+         free_key_bytes_;
+}
+
+/*
+ * The keys are copied out in slot order and written back from the end of the
+ * page, which also keeps them in key order for later scans of the page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::Compact() {
+  char keys[BUSTUB_PAGE_SIZE];
+  size_t end = BUSTUB_PAGE_SIZE;
+  for (int i = GetSize() - 1; i >= 0; i--) {
+    end -= slots_[i].size_;
+    memcpy(keys + end, KeyData(i), slots_[i].size_);
+    slots_[i].offset_ = static_cast<uint16_t>(end);
+  }
+  memcpy(reinterpret_cast<char *>(this) + end, keys + end, BUSTUB_PAGE_SIZE - end);
+  keys_begin_ = static_cast<uint16_t>(end);
+  free_key_bytes_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::InsertAt(int index, const char *key_data, size_t key_size,
+                                                  const ValueType &value) {
+  BUSTUB_ASSERT(sizeof(Slot) + key_size <= FreeSize(), "slotted leaf page overflow");
+  const size_t slots_end = SLOTTED_LEAF_PAGE_HEADER_SIZE + (GetSize() + 1) * sizeof(Slot);
+  if (slots_end + key_size > keys_begin_) {
+    Compact();
+  }
+  keys_begin_ -= static_cast<uint16_t>(key_size);
+  memcpy(reinterpret_cast<char *>(this) + keys_begin_, key_data, key_size);
+  std::move_backward(slots_ + index, slots_ + GetSize(), slots_ + GetSize() + 1);
+  slots_[index] = {keys_begin_, static_cast<uint16_t>(key_size), value};
+  IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::RemoveAt(int index) {
+  if (slots_[index].offset_ == keys_begin_) {
+    keys_begin_ += slots_[index].size_;
+  } else {
+    free_key_bytes_ += slots_[index].size_;
+  }
+  std::move(slots_ + index + 1, slots_ + GetSize(), slots_ + index);
+  IncreaseSize(-1);
+  if (GetSize() == 0) {
+    keys_begin_ = BUSTUB_PAGE_SIZE;
+    free_key_bytes_ = 0;
+  }
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * Insert key & value pair into leaf page ordered by key; it has to fit
+ * @return  page size after insertion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value,
+                                                const KeyComparator &comparator) -> int {
+  InsertAt(KeyIndex(key, comparator), key.Data(), key.Size(), value);
+  return GetSize();
+}
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value,
+                                                const KeyComparator &comparator) const -> bool {
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(KeyAt(index), key) != 0) {
+    return false;
+  }
+  *value = slots_[index].value_;
+  return true;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * @return   page size after deletion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator)
+    -> int {
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(KeyAt(index), key) != 0) {
+    return GetSize();
+  }
+  RemoveAt(index);
+  return GetSize();
+}
+
+/*****************************************************************************
+ * SPACE MANAGEMENT
+ *****************************************************************************/
+/*
+ * A new key can be up to the size of KeyType.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::IsInsertSafe() const -> bool {
+  return GetSize() + 1 < GetMaxSize() && sizeof(Slot) + sizeof(KeyType) <= FreeSize();
+}
+
+/*
+ * Removing the biggest entry must not leave the page underfull.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::IsRemoveSafe() const -> bool {
+  if (GetSize() > GetMinSize()) {
+    return true;
+  }
+  size_t biggest = 0;
+  for (int i = 0; i < GetSize(); i++) {
+    biggest = std::max(biggest, EntrySize(i));
+  }
+  return (UsedSize() - biggest) * 2 >= BUSTUB_PAGE_SIZE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::IsUnderfull() const -> bool {
+  return GetSize() < GetMinSize() && UsedSize() * 2 < BUSTUB_PAGE_SIZE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::CanInsert(const KeyType &key) const -> bool {
+  return GetSize() + 1 < GetMaxSize() && sizeof(Slot) + key.Size() <= FreeSize();
+}
+
+/*
+ * Of the ways to split the entries, counting the new one, into two pages that
+ * both fit, pick the one whose bigger page is smallest.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::SplitSize(int index, const KeyType &key) const -> int {
+  const int size = GetSize() + 1;
+  // entry_sizes[i] is the size of the first i entries
+  std::vector<size_t> entry_sizes(size + 1);
+  for (int i = 0, j = 0; i < size; i++) {
+    entry_sizes[i + 1] = entry_sizes[i] + (i == index ? sizeof(Slot) + key.Size() : EntrySize(j++));
+  }
+  int best_size = size / 2;
+  size_t best_bytes = std::numeric_limits<size_t>::max();
+  for (int left_size = 1; left_size < size; left_size++) {
+    if (left_size >= GetMaxSize() || size - left_size >= GetMaxSize()) {
+      continue;
+    }
+    const size_t bytes = SLOTTED_LEAF_PAGE_HEADER_SIZE +
+                         std::max(entry_sizes[left_size], entry_sizes[size] - entry_sizes[left_size]);
+    if (bytes <= BUSTUB_PAGE_SIZE && bytes < best_bytes) {
+      best_size = left_size;
+      best_bytes = bytes;
+    }
+  }
+  return best_size;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::CanMerge(const BPlusTreeSlottedLeafPage *right) const -> bool {
+  return GetSize() + right->GetSize() < GetMaxSize() &&
+         right->UsedSize() - SLOTTED_LEAF_PAGE_HEADER_SIZE <= FreeSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::CanMoveFirstToEndOf(const BPlusTreeSlottedLeafPage *recipient) const
+    -> bool {
+  const size_t entry_size = EntrySize(0);
+  const bool underfull = GetSize() - 1 < GetMinSize() && (UsedSize() - entry_size) * 2 < BUSTUB_PAGE_SIZE;
+  return !underfull && recipient->GetSize() + 1 < recipient->GetMaxSize() && entry_size <= recipient->FreeSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::CanMoveLastToFrontOf(const BPlusTreeSlottedLeafPage *recipient) const
+    -> bool {
+  const size_t entry_size = EntrySize(GetSize() - 1);
+  const bool underfull = GetSize() - 1 < GetMinSize() && (UsedSize() - entry_size) * 2 < BUSTUB_PAGE_SIZE;
+  return !underfull && recipient->GetSize() + 1 < recipient->GetMaxSize() && entry_size <= recipient->FreeSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::IsFilledTo(double fill_factor) const -> bool {
+  return static_cast<double>(UsedSize()) >= fill_factor * BUSTUB_PAGE_SIZE;
+}
+
+/*****************************************************************************
+ * SPLIT, MERGE AND REDISTRIBUTE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::MoveLatterHalfTo(BPlusTreeSlottedLeafPage *recipient, int start_index) {
+  for (int i = start_index; i < GetSize(); i++) {
+    recipient->InsertAt(recipient->GetSize(), KeyData(i), slots_[i].size_, slots_[i].value_);
+  }
+  while (GetSize() > start_index) {
+    RemoveAt(GetSize() - 1);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeSlottedLeafPage *recipient) {
+  MoveLatterHalfTo(recipient, 0);
+  recipient->SetNextPageId(GetNextPageId());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeSlottedLeafPage *recipient) {
+  recipient->InsertAt(recipient->GetSize(), KeyData(0), slots_[0].size_, slots_[0].value_);
+  RemoveAt(0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeSlottedLeafPage *recipient) {
+  const int last = GetSize() - 1;
+  recipient->InsertAt(0, KeyData(last), slots_[last].size_, slots_[last].value_);
+  RemoveAt(last);
+}
+
+template class BPlusTreeSlottedLeafPage<VarlenKey<256>, RID, VarlenComparator<256>>;
+}  // namespace bustub
@@ -12,35 +12,83 @@
 
 #include "storage/page/hash_table_block_page.h"
 #include "storage/index/generic_key.h"
+#include "storage/page/hash_table_probe.h"
 
 namespace bustub {
 
+static_assert(sizeof(std::atomic_char) == 1, "the bitmaps are scanned as plain bytes");
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::KeyAt(slot_offset_t bucket_ind) const -> KeyType {
-  return {};
+  return array_[bucket_ind].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::ValueAt(slot_offset_t bucket_ind) const -> ValueType {
-  return {};
+  return array_[bucket_ind].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  const auto bit = static_cast<char>(1 << (bucket_ind % 8));
+  // claiming the occupied bit reserves the slot; whoever set it first owns it
+  if ((occupied_[bucket_ind / 8].fetch_or(bit) & bit) != 0) {
+    return false;
+  }
+  array_[bucket_ind] = MappingType(key, value);
+  readable_[bucket_ind / 8].fetch_or(bit);
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {}
+void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {
+  // the slot stays occupied as a tombstone so that probe sequences running through it are not cut short
+  readable_[bucket_ind / 8].fetch_and(static_cast<char>(~(1 << (bucket_ind % 8))));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::IsOccupied(slot_offset_t bucket_ind) const -> bool {
-  return false;
+  return (occupied_[bucket_ind / 8].load() & (1 << (bucket_ind % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::IsReadable(slot_offset_t bucket_ind) const -> bool {
-  return false;
+  return (readable_[bucket_ind / 8].load() & (1 << (bucket_ind % 8))) != 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BLOCK_TYPE::NextUnoccupied(slot_offset_t from, slot_offset_t to) const -> slot_offset_t {
+  return HashTableProbe::NextClearBit(Occupied(), from, to);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BLOCK_TYPE::NextReadable(slot_offset_t from, slot_offset_t to) const -> slot_offset_t {
+  return HashTableProbe::NextSetBit(Readable(), from, to);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BLOCK_TYPE::GetValues(slot_offset_t from, slot_offset_t to, const KeyType &key, KeyComparator cmp,
+                                      std::vector<ValueType> *result) const -> bool {
+  bool found = false;
+  HashTableProbe::ForEachMatch(Readable(), array_, from, to, key, cmp, [&](size_t bucket_ind) {
+    result->push_back(array_[bucket_ind].second);
+    found = true;
+    return true;
+  });
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BLOCK_TYPE::FindPair(slot_offset_t from, slot_offset_t to, const KeyType &key, const ValueType &value,
+                                     KeyComparator cmp) const -> slot_offset_t {
+  slot_offset_t pair_ind = to;
+  HashTableProbe::ForEachMatch(Readable(), array_, from, to, key, cmp, [&](size_t bucket_ind) {
+    if (array_[bucket_ind].second == value) {
+      pair_ind = bucket_ind;
+    }
+    return pair_ind == to;
+  });
+  return pair_ind;
 }
 
 // DO NOT REMOVE ANYTHING BELOW THIS LINE
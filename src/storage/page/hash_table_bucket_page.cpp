@@ -15,67 +15,112 @@
 #include "common/util/hash_util.h"
 #include "storage/index/generic_key.h"
 #include "storage/index/hash_comparator.h"
+#include "storage/page/hash_table_probe.h"
 #include "storage/table/tmp_tuple.h"
 
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool {
-  return false;
+auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) const -> bool {
+  bool found = false;
+  HashTableProbe::ForEachMatch(Readable(), array_, 0, NumOccupied(), key, cmp, [&](size_t bucket_idx) {
+    result->push_back(array_[bucket_idx].second);
+    found = true;
+    return true;
+  });
+  return found;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+  const size_t num_occupied = NumOccupied();
+  bool duplicate = false;
+  HashTableProbe::ForEachMatch(Readable(), array_, 0, num_occupied, key, cmp, [&](size_t bucket_idx) {
+    duplicate = array_[bucket_idx].second == value;
+    return !duplicate;
+  });
+  if (duplicate) {
+    return false;
+  }
+  // a tombstone if there is one, the first never occupied slot otherwise
+  const auto free_slot = static_cast<uint32_t>(HashTableProbe::NextClearBit(Readable(), 0, BUCKET_ARRAY_SIZE));
+  if (free_slot == BUCKET_ARRAY_SIZE) {
+    return false;
+  }
+  array_[free_slot] = MappingType(key, value);
+  SetOccupied(free_slot);
+  SetReadable(free_slot);
   return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool {
-  return false;
+  bool removed = false;
+  HashTableProbe::ForEachMatch(Readable(), array_, 0, NumOccupied(), key, cmp, [&](size_t bucket_idx) {
+    if (array_[bucket_idx].second == value) {
+      RemoveAt(bucket_idx);
+      removed = true;
+    }
+    return !removed;
+  });
+  return removed;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::KeyAt(uint32_t bucket_idx) const -> KeyType {
-  return {};
+  return array_[bucket_idx].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::ValueAt(uint32_t bucket_idx) const -> ValueType {
-  return {};
+  return array_[bucket_idx].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {
+  // leave the slot occupied as a tombstone so that scans keep going past it
+  readable_[bucket_idx / 8] &= static_cast<char>(~(1 << (bucket_idx % 8)));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsOccupied(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (occupied_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {
+  occupied_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsReadable(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (readable_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::IsFull() const -> bool {
+  return NumReadable() == BUCKET_ARRAY_SIZE;
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::IsFull() -> bool {
-  return false;
+auto HASH_TABLE_BUCKET_TYPE::NumReadable() const -> uint32_t {
+  return HashTableProbe::CountSetBits(Readable(), sizeof(readable_));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::NumReadable() -> uint32_t {
-  return 0;
+auto HASH_TABLE_BUCKET_TYPE::IsEmpty() const -> bool {
+  return !HashTableProbe::AnySet(Readable(), sizeof(readable_));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::IsEmpty() -> bool {
-  return false;
+auto HASH_TABLE_BUCKET_TYPE::NumOccupied() const -> uint32_t {
+  // slots are handed out in order and never become unoccupied again, so the occupied slots are a prefix
+  return HashTableProbe::NextClearBit(Occupied(), 0, BUCKET_ARRAY_SIZE);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
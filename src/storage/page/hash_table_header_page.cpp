@@ -12,23 +12,35 @@
 
 #include "storage/page/hash_table_header_page.h"
 
+#include <cstddef>
+
 namespace bustub {
-auto HashTableHeaderPage::GetBlockPageId(size_t index) -> page_id_t { return 0; }
+auto HashTableHeaderPage::GetBlockPageId(size_t index) const -> page_id_t {
+  assert(index < next_ind_);
+  return block_page_ids_[index];
+}
+
+auto HashTableHeaderPage::GetPageId() const -> page_id_t { return page_id_; }
 
-auto HashTableHeaderPage::GetPageId() const -> page_id_t { return 0; }
+void HashTableHeaderPage::SetPageId(bustub::page_id_t page_id) { page_id_ = page_id; }
 
-void HashTableHeaderPage::SetPageId(bustub::page_id_t page_id) {}
+auto HashTableHeaderPage::GetLSN() const -> lsn_t { return lsn_; }
 
-auto HashTableHeaderPage::GetLSN() const -> lsn_t { return 0; }
+void HashTableHeaderPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
 
-void HashTableHeaderPage::SetLSN(lsn_t lsn) {}
+void HashTableHeaderPage::AddBlockPageId(page_id_t page_id) {
+  assert(next_ind_ < MaxBlocks());
+  block_page_ids_[next_ind_++] = page_id;
+}
 
-void HashTableHeaderPage::AddBlockPageId(page_id_t page_id) {}
+auto HashTableHeaderPage::NumBlocks() const -> size_t { return next_ind_; }
 
-auto HashTableHeaderPage::NumBlocks() -> size_t { return 0; }
+auto HashTableHeaderPage::MaxBlocks() -> size_t {
+  return (BUSTUB_PAGE_SIZE - offsetof(HashTableHeaderPage, block_page_ids_)) / sizeof(page_id_t);
+}
 
-void HashTableHeaderPage::SetSize(size_t size) {}
+void HashTableHeaderPage::SetSize(size_t size) { size_ = size; }
 
-auto HashTableHeaderPage::GetSize() const -> size_t { return 0; }
+auto HashTableHeaderPage::GetSize() const -> size_t { return size_; }
 
 }  // namespace bustub
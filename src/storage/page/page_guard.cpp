@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard.cpp
+//
+// Identification: src/storage/page/page_guard.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/page_guard.h"
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept
+    : bpm_(that.bpm_), page_(that.page_), is_dirty_(that.is_dirty_), file_(that.file_), line_(that.line_) {
+  that.bpm_ = nullptr;
+  that.page_ = nullptr;
+  that.is_dirty_ = false;
+}
+
+auto BasicPageGuard::operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard & {
+  if (this != &that) {
+    Drop();
+    bpm_ = that.bpm_;
+    page_ = that.page_;
+    is_dirty_ = that.is_dirty_;
+    file_ = that.file_;
+    line_ = that.line_;
+    that.bpm_ = nullptr;
+    that.page_ = nullptr;
+    that.is_dirty_ = false;
+  }
+  return *this;
+}
+
+void BasicPageGuard::Drop() {
+  if (page_ != nullptr) {
+    bpm_->UntrackGuardPin(file_, line_);
+    bpm_->UnpinPage(page_->GetPageId(), is_dirty_);
+  }
+  bpm_ = nullptr;
+  page_ = nullptr;
+  is_dirty_ = false;
+}
+
+auto BasicPageGuard::UpgradeRead() -> ReadPageGuard {
+  if (page_ != nullptr) {
+    page_->RLatch();
+  }
+  return ReadPageGuard(std::move(*this));
+}
+
+auto BasicPageGuard::UpgradeWrite() -> WritePageGuard {
+  if (page_ != nullptr) {
+    page_->WLatch();
+  }
+  return WritePageGuard(std::move(*this));
+}
+
+auto ReadPageGuard::operator=(ReadPageGuard &&that) noexcept -> ReadPageGuard & {
+  if (this != &that) {
+    Drop();
+    guard_ = std::move(that.guard_);
+  }
+  return *this;
+}
+
+void ReadPageGuard::Drop() {
+  if (guard_.page_ != nullptr) {
+    guard_.page_->RUnlatch();
+  }
+  guard_.Drop();
+}
+
+auto WritePageGuard::operator=(WritePageGuard &&that) noexcept -> WritePageGuard & {
+  if (this != &that) {
+    Drop();
+    guard_ = std::move(that.guard_);
+  }
+  return *this;
+}
+
+void WritePageGuard::Drop() {
+  if (guard_.page_ != nullptr) {
+    guard_.page_->WUnlatch();
+  }
+  guard_.Drop();
+}
+
+OptimisticReadGuard::OptimisticReadGuard(OptimisticReadGuard &&that) noexcept
+    : bpm_(that.bpm_), page_(that.page_), version_(that.version_) {
+  that.bpm_ = nullptr;
+  that.page_ = nullptr;
+}
+
+auto OptimisticReadGuard::operator=(OptimisticReadGuard &&that) noexcept -> OptimisticReadGuard & {
+  if (this != &that) {
+    Drop();
+    bpm_ = that.bpm_;
+    page_ = that.page_;
+    version_ = that.version_;
+    that.bpm_ = nullptr;
+    that.page_ = nullptr;
+  }
+  return *this;
+}
+
+void OptimisticReadGuard::Drop() {
+  if (page_ != nullptr) {
+    bpm_->UnpinPage(page_->GetPageId(), false);
+  }
+  bpm_ = nullptr;
+  page_ = nullptr;
+}
+
+auto OptimisticReadGuard::Release() -> Page * {
+  Page *page = page_;
+  bpm_ = nullptr;
+  page_ = nullptr;
+  return page;
+}
+
+auto OptimisticReadGuard::TryRLatch() -> Page * {
+  page_->RLatch();
+  if (!Validate()) {
+    page_->RUnlatch();
+    return nullptr;
+  }
+  return Release();
+}
+
+auto OptimisticReadGuard::TryWLatch() -> Page * {
+  page_->WLatch();
+  // taking the write latch bumped the version once
+  if (!page_->ValidateVersion(version_ + 1)) {
+    page_->WUnlatch();
+    return nullptr;
+  }
+  return Release();
+}
+
+}  // namespace bustub
@@ -23,17 +23,20 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id),
+      chain_{first_page_id},
+      chain_positions_{{first_page_id, 0}} {}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
                      Transaction *txn)
     : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {
   // Initialize the first table page.
-  auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
-  BUSTUB_ASSERT(first_page != nullptr,
+  auto first_page_guard = buffer_pool_manager_->NewPageGuarded(&first_page_id_);
+  BUSTUB_ASSERT(first_page_guard.IsValid(),
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
-  first_page->Init(first_page_id_, BUSTUB_PAGE_SIZE, INVALID_LSN, log_manager_, txn);
-  buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  first_page_guard.AsPageMut<TablePage>()->Init(first_page_id_, BUSTUB_PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  chain_.push_back(first_page_id_);
+  chain_positions_.emplace(first_page_id_, 0);
 }
 
 auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
@@ -42,50 +45,48 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
     return false;
   }
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  if (cur_page == nullptr) {
+  auto cur_guard = buffer_pool_manager_->FetchPageWrite(first_page_id_);
+  if (!cur_guard.IsValid()) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
 
-  cur_page->WLatch();
-
   // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
-  // INVARIANT: cur_page is WLatched if you leave the loop normally.
-  while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
+  // INVARIANT: cur_guard holds a page if you leave the loop normally.
+  while (!cur_guard.AsPage<TablePage>()->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
+    auto *cur_page = cur_guard.AsPage<TablePage>();
     auto next_page_id = cur_page->GetNextPageId();
     // If the next page is a valid page,
     if (next_page_id != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
-      next_page->WLatch();
-      // Unlatch and unpin the current page.
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
+      LinkPage(cur_guard.PageId(), next_page_id);
+      // Latch the next page before the current one is unlatched.
+      auto next_guard = buffer_pool_manager_->FetchPageWrite(next_page_id);
+      if (!next_guard.IsValid()) {
+        txn->SetState(TransactionState::ABORTED);
+        return false;
+      }
+      cur_guard = std::move(next_guard);
     } else {
       // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
+      auto new_guard = buffer_pool_manager_->NewPageGuarded(&next_page_id);
       // If we could not create a new page,
-      if (new_page == nullptr) {
+      if (!new_guard.IsValid()) {
         // Then life sucks and we abort the transaction.
-        cur_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
         txn->SetState(TransactionState::ABORTED);
         return false;
       }
       // Otherwise we were able to create a new page. We initialize it now.
-      new_page->WLatch();
-      cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, BUSTUB_PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-      cur_page = new_page;
+      auto new_write_guard = new_guard.UpgradeWrite();
+      cur_guard.AsPageMut<TablePage>()->SetNextPageId(next_page_id);
+      LinkPage(cur_guard.PageId(), next_page_id);
+      new_write_guard.AsPageMut<TablePage>()->Init(next_page_id, BUSTUB_PAGE_SIZE, cur_page->GetTablePageId(),
+                                                   log_manager_, txn);
+      cur_guard = std::move(new_write_guard);
     }
   }
-  // This line has caused most of us to double-take and "whoa double unlatch".
-  // We are not, in fact, double unlatching. See the invariant above.
-  cur_page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+  // The tuple went into the page cur_guard holds.
+  cur_guard.GetDataMut();
+  cur_guard.Drop();
   // Update the transaction's write set.
   txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
   return true;
@@ -94,17 +95,15 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
 auto TableHeap::MarkDelete(const RID &rid, Transaction *txn) -> bool {
   // TODO(Amadou): remove empty page
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
-  if (page == nullptr) {
+  if (!guard.IsValid()) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
   // Otherwise, mark the tuple as deleted.
-  page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  guard.AsPageMut<TablePage>()->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  guard.Drop();
   // Update the transaction's write set.
   txn->GetWriteSet()->emplace_back(rid, WType::DELETE, Tuple{}, this);
   return true;
@@ -112,18 +111,19 @@ auto TableHeap::MarkDelete(const RID &rid, Transaction *txn) -> bool {
 
 auto TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) -> bool {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
-  if (page == nullptr) {
+  if (!guard.IsValid()) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
   // Update the tuple; but first save the old value for rollbacks.
   Tuple old_tuple;
-  page->WLatch();
-  bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
+  bool is_updated = guard.AsPage<TablePage>()->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  if (is_updated) {
+    guard.GetDataMut();
+  }
+  guard.Drop();
   // Update the transaction's write set.
   if (is_updated && txn->GetState() != TransactionState::ABORTED) {
     txn->GetWriteSet()->emplace_back(rid, WType::UPDATE, old_tuple, this);
@@ -133,69 +133,89 @@ auto TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn
 
 void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
+  BUSTUB_ASSERT(guard.IsValid(), "Couldn't find a page containing that RID.");
   // Delete the tuple from the page.
-  page->WLatch();
-  page->ApplyDelete(rid, txn, log_manager_);
+  guard.AsPageMut<TablePage>()->ApplyDelete(rid, txn, log_manager_);
   /** Commented out to make compatible with p4; This is called only on commit or delete, which consequently unlocks the
    * tuple; so should be fine */
   // lock_manager_->Unlock(txn, rid);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
 }
 
 void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
+  BUSTUB_ASSERT(guard.IsValid(), "Couldn't find a page containing that RID.");
   // Rollback the delete.
-  page->WLatch();
-  page->RollbackDelete(rid, txn, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  guard.AsPageMut<TablePage>()->RollbackDelete(rid, txn, log_manager_);
 }
 
 auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock) -> bool {
-  // Find the page which contains the tuple.
-  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  // If the page could not be found, then abort the transaction.
-  if (page == nullptr) {
-    txn->SetState(TransactionState::ABORTED);
-    return false;
-  }
   // Read the tuple from the page.
   if (acquire_read_lock) {
-    page->RLatch();
+    auto guard = buffer_pool_manager_->FetchPageRead(rid.GetPageId());
+    // If the page could not be found, then abort the transaction.
+    if (!guard.IsValid()) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    return guard.AsPage<TablePage>()->GetTuple(rid, tuple, txn, lock_manager_);
   }
-  bool res = page->GetTuple(rid, tuple, txn, lock_manager_);
-  if (acquire_read_lock) {
-    page->RUnlatch();
+  auto guard = buffer_pool_manager_->FetchPageBasic(rid.GetPageId());
+  if (!guard.IsValid()) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
   }
-  buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
-  return res;
+  return guard.AsPage<TablePage>()->GetTuple(rid, tuple, txn, lock_manager_);
 }
 
-auto TableHeap::Begin(Transaction *txn) -> TableIterator {
+auto TableHeap::Begin(Transaction *txn, AccessType access_type) -> TableIterator {
   // Start an iterator from the first page.
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
   RID rid;
   auto page_id = first_page_id_;
   while (page_id != INVALID_PAGE_ID) {
-    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
-    page->RLatch();
+    auto guard = buffer_pool_manager_->FetchPageRead(page_id, access_type);
+    BUSTUB_ENSURE(guard.IsValid(), "BPM full");  // all pages are pinned
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
-    auto found_tuple = page->GetFirstTupleRid(&rid);
-    page->RUnlatch();
-    buffer_pool_manager_->UnpinPage(page_id, false);
-    if (found_tuple) {
+    if (guard.AsPage<TablePage>()->GetFirstTupleRid(&rid)) {
       break;
     }
-    page_id = page->GetNextPageId();
+    auto next_page_id = guard.AsPage<TablePage>()->GetNextPageId();
+    if (next_page_id != INVALID_PAGE_ID) {
+      LinkPage(page_id, next_page_id);
+    }
+    page_id = next_page_id;
   }
-  return {this, rid, txn};
+  return {this, rid, txn, access_type};
 }
 
 auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
 
+void TableHeap::LinkPage(page_id_t page_id, page_id_t next_page_id) {
+  std::scoped_lock<std::mutex> lock(chain_latch_);
+  if (chain_.back() != page_id) {
+    return;
+  }
+  chain_positions_.emplace(next_page_id, chain_.size());
+  chain_.push_back(next_page_id);
+}
+
+auto TableHeap::FindChainPosition(page_id_t page_id, size_t *position) -> bool {
+  std::scoped_lock<std::mutex> lock(chain_latch_);
+  auto it = chain_positions_.find(page_id);
+  if (it == chain_positions_.end()) {
+    return false;
+  }
+  *position = it->second;
+  return true;
+}
+
+void TableHeap::GetChainPages(size_t begin, size_t end, std::vector<page_id_t> *page_ids) {
+  std::scoped_lock<std::mutex> lock(chain_latch_);
+  for (size_t position = begin; position < end && position < chain_.size(); position++) {
+    page_ids->push_back(chain_[position]);
+  }
+}
+
 }  // namespace bustub
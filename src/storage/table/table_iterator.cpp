@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <vector>
 
 #include "common/exception.h"
 #include "concurrency/transaction.h"
@@ -18,10 +19,15 @@
 
 namespace bustub {
 
-TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
-    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
+TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, AccessType access_type)
+    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn), access_type_(access_type) {
   if (rid.GetPageId() != INVALID_PAGE_ID) {
-    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_)) {
+    auto guard = table_heap_->buffer_pool_manager_->FetchPageRead(rid.GetPageId(), access_type_);
+    BUSTUB_ENSURE(guard.IsValid(), "BPM full");  // all pages are pinned
+    ReadAhead(guard.AsPage<TablePage>());
+    bool found = guard.AsPage<TablePage>()->GetTuple(tuple_->rid_, tuple_, txn_, table_heap_->lock_manager_);
+    guard.Drop();
+    if (!found) {
       throw bustub::Exception("read non-existing tuple");
     }
   }
@@ -39,20 +45,21 @@ auto TableIterator::operator->() -> Tuple * {
 
 auto TableIterator::operator++() -> TableIterator & {
   BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
-  BUSTUB_ENSURE(cur_page != nullptr, "BPM full");  // all pages are pinned
+  auto cur_guard = buffer_pool_manager->FetchPageRead(tuple_->rid_.GetPageId(), access_type_);
+  BUSTUB_ENSURE(cur_guard.IsValid(), "BPM full");  // all pages are pinned
 
-  cur_page->RLatch();
   RID next_tuple_rid;
-  if (!cur_page->GetNextTupleRid(tuple_->rid_,
-                                 &next_tuple_rid)) {  // end of this page
-    while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
-      cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
-      cur_page->RLatch();
-      if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
+  if (!cur_guard.AsPage<TablePage>()->GetNextTupleRid(tuple_->rid_,
+                                                      &next_tuple_rid)) {  // end of this page
+    while (cur_guard.AsPage<TablePage>()->GetNextPageId() != INVALID_PAGE_ID) {
+      page_id_t next_page_id = cur_guard.AsPage<TablePage>()->GetNextPageId();
+      // Pin the next page before the current one is released, then latch it.
+      auto next_guard = buffer_pool_manager->FetchPageBasic(next_page_id, access_type_);
+      BUSTUB_ENSURE(next_guard.IsValid(), "BPM full");
+      cur_guard.Drop();
+      cur_guard = next_guard.UpgradeRead();
+      ReadAhead(cur_guard.AsPage<TablePage>());
+      if (cur_guard.AsPage<TablePage>()->GetFirstTupleRid(&next_tuple_rid)) {
         break;
       }
     }
@@ -62,18 +69,45 @@ auto TableIterator::operator++() -> TableIterator & {
   if (*this != table_heap_->End()) {
     // DO NOT ACQUIRE READ LOCK twice in a single thread otherwise it may deadlock.
     // See https://users.rust-lang.org/t/how-bad-is-the-potential-deadlock-mentioned-in-rwlocks-document/67234
-    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_, false)) {
-      cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
+    // Read straight from the page we hold; going through TableHeap::GetTuple() would fetch it again without the hint.
+    if (!cur_guard.AsPage<TablePage>()->GetTuple(tuple_->rid_, tuple_, txn_, table_heap_->lock_manager_)) {
       throw bustub::Exception("read non-existing tuple");
     }
   }
-  // release until copy the tuple
-  cur_page->RUnlatch();
-  buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
+  // the guard releases the page once the tuple is copied
   return *this;
 }
 
+void TableIterator::ReadAhead(TablePage *page) {
+  const page_id_t next_page_id = page->GetNextPageId();
+  if (next_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  table_heap_->LinkPage(page->GetTablePageId(), next_page_id);
+  size_t position;
+  if (!table_heap_->FindChainPosition(next_page_id, &position) ||
+      (position >= read_ahead_begin_ && position + TABLE_READ_AHEAD_PAGES / 2 < read_ahead_end_)) {
+    return;
+  }
+  // Only hand out the part of the new window that has not been asked for yet. The window ends early where the known
+  // chain does, so the pages the scan learns about later are handed out when it gets there.
+  const bool overlaps = position >= read_ahead_begin_ && position < read_ahead_end_;
+  const size_t first_position = overlaps ? read_ahead_end_ : position;
+  std::vector<page_id_t> page_ids;
+  table_heap_->GetChainPages(first_position, position + TABLE_READ_AHEAD_PAGES, &page_ids);
+  read_ahead_begin_ = position;
+  read_ahead_end_ = first_position + page_ids.size();
+  // Pages that follow each other on disk go out as one range.
+  for (size_t i = 0; i < page_ids.size();) {
+    size_t count = 1;
+    while (i + count < page_ids.size() && page_ids[i + count] == page_ids[i] + static_cast<page_id_t>(count)) {
+      count++;
+    }
+    table_heap_->buffer_pool_manager_->PrefetchPages(page_ids[i], count, access_type_);
+    i += count;
+  }
+}
+
 auto TableIterator::operator++(int) -> TableIterator {
   TableIterator clone(*this);
   ++(*this);
@@ -12,18 +12,40 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <iostream>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
+/** Counts the reads of the pages below a threshold, the "hot" pages of a test. */
+class HotReadCountingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  explicit HotReadCountingDiskManager(page_id_t num_hot_pages) : num_hot_pages_(num_hot_pages) {}
+
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    if (page_id < num_hot_pages_) {
+      num_hot_reads_++;
+    }
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  const page_id_t num_hot_pages_;
+  std::atomic<size_t> num_hot_reads_{0};
+};
+
 // NOLINTNEXTLINE
 // Check whether pages containing terminal characters can be recovered
-TEST(BufferPoolManagerInstanceTest, DISABLED_BinaryDataTest) {
+TEST(BufferPoolManagerInstanceTest, BinaryDataTest) {
   const std::string db_name = "test.db";
   const size_t buffer_pool_size = 10;
   const size_t k = 5;
@@ -89,7 +111,7 @@ TEST(BufferPoolManagerInstanceTest, DISABLED_BinaryDataTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(BufferPoolManagerInstanceTest, DISABLED_SampleTest) {
+TEST(BufferPoolManagerInstanceTest, SampleTest) {
   const std::string db_name = "test.db";
   const size_t buffer_pool_size = 10;
   const size_t k = 5;
@@ -145,4 +167,365 @@ TEST(BufferPoolManagerInstanceTest, DISABLED_SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, BackgroundWriterTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const size_t k = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  // Scenario: fill the pool with dirty, unpinned pages.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: the background writer cleans every frame in its window without anybody asking for it.
+  bpm->StartBackgroundWriter(1.0, 1000);
+  for (int i = 0; i < 500 && bpm->GetNumBackgroundWritebacks() < buffer_pool_size; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  bpm->StopBackgroundWriter();
+  EXPECT_EQ(buffer_pool_size, bpm->GetNumBackgroundWritebacks());
+
+  // Scenario: evicting the cleaned pages does not write anything on the caller's thread, and no data is lost.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(0, bpm->GetNumSyncWritebacks());
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), page->GetData());
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PrefetchTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 20;
+  const size_t k = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  // Scenario: write out twice as many pages as fit in the pool, so that the first half is only on disk.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < 2 * buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: prefetched pages land in the pool without being pinned.
+  bpm->PrefetchPages(0, 4);
+  for (int i = 0; i < 500 && bpm->GetNumPrefetchedPages() < 4; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(4, bpm->GetNumPrefetchedPages());
+  for (page_id_t page_id = 0; page_id < 4; ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(1, page->GetPinCount());
+    EXPECT_EQ("page " + std::to_string(page_id), page->GetData());
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: resident and unallocated pages are skipped, and at most a quarter of the pool is read at once.
+  bpm->PrefetchPages(0, 100);
+  for (int i = 0; i < 500 && bpm->GetNumPrefetchedPages() < 9; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(9, bpm->GetNumPrefetchedPages());
+
+  // Scenario: a fetch that races with the read-ahead of its page waits for it and sees the data from disk.
+  for (page_id_t page_id = 10; page_id < 20; ++page_id) {
+    bpm->PrefetchPages(page_id, 1);
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), page->GetData());
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  delete bpm;
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, ScanRingTest) {
+  const size_t buffer_pool_size = 40;
+  const page_id_t num_hot_pages = 10;
+  const page_id_t num_pages = 200;
+
+  auto *disk_manager = new HotReadCountingDiskManager(num_hot_pages);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+
+  page_id_t page_id_temp;
+  for (page_id_t i = 0; i < num_pages; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    snprintf(bpm->FetchPage(page_id_temp)->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  // Two accesses in a row give the hot pages a finite backward k-distance right away.
+  auto touch_hot_pages = [&]() {
+    for (page_id_t page_id = 0; page_id < num_hot_pages; ++page_id) {
+      for (int i = 0; i < 2; i++) {
+        auto *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ("page " + std::to_string(page_id), page->GetData());
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    }
+  };
+  touch_hot_pages();
+  const size_t num_hot_reads = disk_manager->num_hot_reads_;
+
+  // Like TableIterator, the scans fetch every page once per tuple, which makes the pages look hot to LRU-K.
+  auto scan = [&](AccessType access_type) {
+    for (page_id_t page_id = num_hot_pages; page_id < num_pages; ++page_id) {
+      for (int tuple = 0; tuple < 4; tuple++) {
+        auto *page = bpm->FetchPage(page_id, access_type);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ("page " + std::to_string(page_id), page->GetData());
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    }
+  };
+
+  // Scenario: a full scan under the scan hint only cycles through the ring, and the hot pages stay resident.
+  scan(AccessType::Scan);
+  touch_hot_pages();
+  EXPECT_EQ(num_hot_reads, disk_manager->num_hot_reads_);
+
+  // Scenario: the same scan without the hint pushes the hot pages out.
+  scan(AccessType::Normal);
+  touch_hot_pages();
+  EXPECT_LT(num_hot_reads, disk_manager->num_hot_reads_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// Hit rate of point lookups on a small set of hot pages (think the inner pages of an index) while another thread runs
+// full scans over a table ten times the size of the pool, with and without the scan hint. Like TableIterator, the scans
+// fetch every page once per tuple.
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, DISABLED_ScanResistanceBenchmark) {
+  const size_t buffer_pool_size = 256;
+  const page_id_t num_hot_pages = 160;
+  const page_id_t num_pages = 2560;
+  const int num_scans = 10;
+
+  for (auto access_type : {AccessType::Normal, AccessType::Scan}) {
+    auto *disk_manager = new HotReadCountingDiskManager(num_hot_pages);
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+    page_id_t page_id_temp;
+    for (page_id_t i = 0; i < num_pages; ++i) {
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+      EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+    }
+
+    std::atomic<bool> scanning{true};
+    std::thread scanner([&]() {
+      for (int i = 0; i < num_scans; i++) {
+        for (page_id_t page_id = num_hot_pages; page_id < num_pages; ++page_id) {
+          for (int tuple = 0; tuple < 16; tuple++) {
+            bpm->FetchPage(page_id, access_type);
+            bpm->UnpinPage(page_id, false);
+          }
+        }
+      }
+      scanning = false;
+    });
+    std::mt19937 gen(15445);
+    std::uniform_int_distribution<page_id_t> dist(0, num_hot_pages - 1);
+    size_t num_lookups = 0;
+    const size_t reads_before = disk_manager->num_hot_reads_;
+    while (scanning) {
+      page_id_t page_id = dist(gen);
+      bpm->FetchPage(page_id);
+      bpm->UnpinPage(page_id, false);
+      num_lookups++;
+      std::this_thread::yield();
+    }
+    scanner.join();
+    const size_t num_misses = disk_manager->num_hot_reads_ - reads_before;
+    std::cout << (access_type == AccessType::Scan ? "scan hint" : "no hint") << ": " << num_lookups << " lookups, "
+              << "hit rate " << 1.0 - static_cast<double>(num_misses) / static_cast<double>(num_lookups) << std::endl;
+
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, ClockReplacerTest) {
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, LRUK_REPLACER_K, nullptr,
+                                            ReplacerType::CLOCK);
+
+  // Scenario: fill the pool; with everything pinned there is no room for another page.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: after unpinning, the clock hands out the frames again and the evicted pages come back intact.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), page->GetData());
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PageGuardTest) {
+  const size_t buffer_pool_size = 5;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: a guard unpins its page when it goes out of scope, and a new page is written back.
+  page_id_t page_id;
+  {
+    auto guard = bpm->NewPageGuarded(&page_id);
+    ASSERT_TRUE(guard.IsValid());
+    snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "guarded");
+  }
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id_temp;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  {
+    auto guard = bpm->FetchPageRead(page_id);
+    ASSERT_TRUE(guard.IsValid());
+    EXPECT_STREQ("guarded", guard.GetData());
+    EXPECT_EQ(1, guard.AsPage<Page>()->GetPinCount());
+  }
+
+  // Scenario: moving a guard hands the pin over instead of copying it.
+  {
+    auto guard = bpm->FetchPageWrite(page_id);
+    WritePageGuard other = std::move(guard);
+    EXPECT_FALSE(guard.IsValid());  // NOLINT
+    EXPECT_EQ(1, other.AsPage<Page>()->GetPinCount());
+    other.Drop();
+    EXPECT_FALSE(other.IsValid());
+  }
+
+  // Scenario: the write latch is free again once the guard is dropped, and open guards are reported by call site.
+  auto guard = bpm->FetchPageWrite(page_id);
+  guard.Drop();
+  auto read_guard = bpm->FetchPageRead(page_id);
+#ifndef NDEBUG
+  auto sites = bpm->GetGuardPinSites();
+  ASSERT_EQ(1, sites.size());
+  EXPECT_NE(std::string::npos, sites.begin()->first.find("buffer_pool_manager_instance_test.cpp"));
+  EXPECT_EQ(1, sites.begin()->second);
+#endif
+  read_guard.Drop();
+  EXPECT_TRUE(bpm->GetGuardPinSites().empty());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, MetricsTest) {
+  const size_t buffer_pool_size = 3;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: fill the pool with dirty pages, then make room for one more; the victim is written back and evicted.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size + 1; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(1, stats.Get(BufferPoolCounter::EVICTION));
+  EXPECT_EQ(1, stats.Get(BufferPoolCounter::SYNC_WRITEBACK));
+  EXPECT_EQ(1, bpm->GetNumSyncWritebacks());
+
+  // Scenario: fetching a resident page is a hit, fetching the evicted one is a miss that reads from disk.
+  ASSERT_NE(nullptr, bpm->FetchPage(page_id_temp));
+  EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  stats = bpm->GetStats();
+  EXPECT_EQ(1, stats.Get(BufferPoolCounter::HIT));
+  EXPECT_EQ(1, stats.Get(BufferPoolCounter::MISS));
+  EXPECT_DOUBLE_EQ(0.5, stats.HitRatio());
+  EXPECT_LT(0, stats.Get(BufferPoolCounter::PAGE_TABLE_LOOKUP));
+  EXPECT_GE(stats.AvgProbeLength(), 0.0);
+
+  uint64_t reads = 0;
+  uint64_t writes = 0;
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+    reads += stats.read_latency_[i];
+    writes += stats.write_latency_[i];
+  }
+  EXPECT_EQ(1, reads);
+  EXPECT_EQ(2, writes);
+  EXPECT_LT(0, BufferPoolStats::LatencyQuantile(stats.read_latency_, 0.5));
+  EXPECT_EQ(0, BufferPoolStats::LatencyQuantile(LatencyHistogram{}, 0.5));
+
+  // Scenario: counts from several threads all add up.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([bpm] {
+      for (int i = 0; i < 100; i++) {
+        auto *page = bpm->FetchPage(0);
+        ASSERT_NE(nullptr, page);
+        bpm->UnpinPage(0, false);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(401, bpm->GetStats().Get(BufferPoolCounter::HIT));
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
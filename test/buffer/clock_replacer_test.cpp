@@ -10,16 +10,23 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
 #include <thread>  // NOLINT
 #include <vector>
 
 #include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
 #include "gtest/gtest.h"
 
 namespace bustub {
 
-TEST(ClockReplacerTest, DISABLED_SampleTest) {
+TEST(ClockReplacerTest, SampleTest) {
   ClockReplacer clock_replacer(7);
 
   // Scenario: unpin six elements, i.e. add them to the replacer.
@@ -59,4 +66,117 @@ TEST(ClockReplacerTest, DISABLED_SampleTest) {
   EXPECT_EQ(4, value);
 }
 
+TEST(ClockReplacerTest, EmptyTest) {
+  ClockReplacer clock_replacer(0);
+  frame_id_t value;
+  EXPECT_FALSE(clock_replacer.Victim(&value));
+  EXPECT_EQ(0, clock_replacer.Size());
+  EXPECT_TRUE(clock_replacer.GetEvictionOrder(4).empty());
+}
+
+TEST(ClockReplacerTest, ConcurrencyTest) {
+  const size_t num_frames = 1000;
+  const int num_threads = 4;
+  ClockReplacer clock_replacer(num_frames);
+  for (size_t i = 0; i < num_frames; i++) {
+    clock_replacer.Unpin(static_cast<frame_id_t>(i));
+  }
+
+  // Every frame comes out exactly once, no matter how many threads race for it.
+  std::vector<std::atomic<int>> victimized(num_frames);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&]() {
+      frame_id_t frame_id;
+      while (clock_replacer.Victim(&frame_id)) {
+        victimized[frame_id]++;
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  for (auto &count : victimized) {
+    EXPECT_EQ(1, count);
+  }
+  EXPECT_EQ(0, clock_replacer.Size());
+
+  // Pinned frames are never handed out, while other threads keep touching them.
+  for (size_t i = 0; i < num_frames; i++) {
+    clock_replacer.RecordAccess(static_cast<frame_id_t>(i));
+    clock_replacer.SetEvictable(static_cast<frame_id_t>(i), i % 2 == 0);
+  }
+  threads.clear();
+  std::atomic<bool> done{false};
+  std::atomic<size_t> num_victims{0};
+  threads.emplace_back([&]() {
+    while (!done) {
+      for (size_t i = 1; i < num_frames; i += 2) {
+        clock_replacer.RecordAccess(static_cast<frame_id_t>(i));
+      }
+    }
+  });
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&]() {
+      frame_id_t frame_id;
+      while (clock_replacer.Victim(&frame_id)) {
+        EXPECT_EQ(0, frame_id % 2);
+        num_victims++;
+      }
+    });
+  }
+  for (size_t i = 1; i < threads.size(); i++) {
+    threads[i].join();
+  }
+  done = true;
+  threads[0].join();
+  EXPECT_EQ(num_frames / 2, num_victims);
+}
+
+// Several threads run the buffer pool's hit path (pin, record the access, unpin) on random frames, with an eviction
+// every 64 operations, against the clock and the LRU-K replacer.
+TEST(ClockReplacerTest, DISABLED_ContentionBenchmark) {
+  const size_t num_frames = 4096;
+  const size_t ops_per_thread = 200000;
+  auto run = [&](Replacer *replacer, size_t num_threads) {
+    for (size_t i = 0; i < num_frames; i++) {
+      replacer->RecordAccess(static_cast<frame_id_t>(i));
+      replacer->SetEvictable(static_cast<frame_id_t>(i), true);
+    }
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([replacer, tid, num_frames, ops_per_thread]() {
+        std::mt19937 gen(tid);
+        std::uniform_int_distribution<frame_id_t> dist(0, num_frames - 1);
+        for (size_t i = 0; i < ops_per_thread; i++) {
+          frame_id_t frame_id;
+          if (i % 64 == 63 && replacer->Evict(&frame_id)) {
+            replacer->RecordAccess(frame_id);
+            replacer->SetEvictable(frame_id, true);
+            continue;
+          }
+          frame_id = dist(gen);
+          replacer->SetEvictable(frame_id, false);
+          replacer->RecordAccess(frame_id);
+          replacer->SetEvictable(frame_id, true);
+        }
+      });
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+    auto dur = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return static_cast<double>(num_threads * ops_per_thread) * 1000000.0 / std::max<int64_t>(1, dur.count());
+  };
+  for (size_t num_threads : {1, 2, 4, 8, 16}) {
+    auto clock = std::make_unique<ClockReplacer>(num_frames);
+    auto lru_k = std::make_unique<LRUKReplacer>(num_frames, LRUK_REPLACER_K);
+    double clock_ops = run(clock.get(), num_threads);
+    double lru_k_ops = run(lru_k.get(), num_threads);
+    std::cout << num_threads << " threads: clock " << clock_ops << " ops/s, lru-k " << lru_k_ops << " ops/s"
+              << std::endl;
+  }
+}
+
 }  // namespace bustub
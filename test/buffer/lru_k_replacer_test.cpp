@@ -5,18 +5,82 @@
 #include "buffer/lru_k_replacer.h"
 
 #include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <iostream>
+#include <list>
 #include <memory>
 #include <random>
 #include <set>
 #include <thread>  // NOLINT
+#include <unordered_map>
 #include <vector>
 
 #include "gtest/gtest.h"
 
 namespace bustub {
 
-TEST(LRUKReplacerTest, DISABLED_SampleTest) {
+/** The straightforward LRU-K: full scan on every eviction. Reference for the randomized test and the benchmark. */
+class NaiveLRUKReplacer {
+ public:
+  NaiveLRUKReplacer(size_t num_frames, size_t k) : k_(k) {}
+
+  auto Evict(frame_id_t *frame_id) -> bool {
+    bool found = false;
+    std::pair<bool, size_t> victim_key;
+    for (const auto &[fid, entry] : entries_) {
+      std::pair<bool, size_t> key{entry.history_.size() >= k_, entry.history_.front()};
+      if (entry.evictable_ && (!found || key < victim_key)) {
+        found = true;
+        victim_key = key;
+        *frame_id = fid;
+      }
+    }
+    if (found) {
+      entries_.erase(*frame_id);
+      curr_size_--;
+    }
+    return found;
+  }
+
+  void RecordAccess(frame_id_t frame_id) {
+    auto &history = entries_[frame_id].history_;
+    history.push_back(current_timestamp_++);
+    if (history.size() > k_) {
+      history.pop_front();
+    }
+  }
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) {
+    auto it = entries_.find(frame_id);
+    if (it != entries_.end() && it->second.evictable_ != set_evictable) {
+      it->second.evictable_ = set_evictable;
+      curr_size_ += set_evictable ? 1 : -1;
+    }
+  }
+
+  void Remove(frame_id_t frame_id) {
+    auto it = entries_.find(frame_id);
+    if (it != entries_.end()) {
+      entries_.erase(it);
+      curr_size_--;
+    }
+  }
+
+  auto Size() -> size_t { return curr_size_; }
+
+ private:
+  struct FrameEntry {
+    std::list<size_t> history_;
+    bool evictable_{false};
+  };
+  size_t current_timestamp_{0};
+  size_t curr_size_{0};
+  size_t k_;
+  std::unordered_map<frame_id_t, FrameEntry> entries_;
+};
+
+TEST(LRUKReplacerTest, SampleTest) {
   LRUKReplacer lru_replacer(7, 2);
 
   // Scenario: add six elements to the replacer. We have [1,2,3,4,5]. Frame 6 is non-evictable.
@@ -97,4 +161,100 @@ TEST(LRUKReplacerTest, DISABLED_SampleTest) {
   lru_replacer.Remove(1);
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, RandomizedTest) {
+  const size_t num_frames = 64;
+  for (size_t k : {1, 2, 5}) {
+    LRUKReplacer lru_replacer(num_frames, k);
+    NaiveLRUKReplacer reference(num_frames, k);
+    std::mt19937 gen(15445 + k);
+    std::uniform_int_distribution<frame_id_t> frame_dist(0, num_frames - 1);
+    std::uniform_int_distribution<int> op_dist(0, 9);
+    std::set<frame_id_t> tracked;
+    std::set<frame_id_t> evictable;
+    for (int i = 0; i < 20000; i++) {
+      auto frame_id = frame_dist(gen);
+      auto op = op_dist(gen);
+      if (op < 5) {
+        lru_replacer.RecordAccess(frame_id);
+        reference.RecordAccess(frame_id);
+        tracked.insert(frame_id);
+      } else if (op < 8) {
+        bool set_evictable = op != 7;
+        lru_replacer.SetEvictable(frame_id, set_evictable);
+        reference.SetEvictable(frame_id, set_evictable);
+        if (set_evictable && tracked.count(frame_id) > 0) {
+          evictable.insert(frame_id);
+        } else {
+          evictable.erase(frame_id);
+        }
+      } else if (op == 8) {
+        frame_id_t expected;
+        frame_id_t actual;
+        bool found = reference.Evict(&expected);
+        ASSERT_EQ(found, lru_replacer.Evict(&actual));
+        if (found) {
+          ASSERT_EQ(expected, actual);
+          evictable.erase(actual);
+          tracked.erase(actual);
+        }
+      } else if (evictable.count(frame_id) > 0) {
+        lru_replacer.Remove(frame_id);
+        reference.Remove(frame_id);
+        evictable.erase(frame_id);
+        tracked.erase(frame_id);
+      }
+      ASSERT_EQ(reference.Size(), lru_replacer.Size());
+    }
+
+    // The eviction order matches what Evict() then does.
+    auto order = lru_replacer.GetEvictionOrder(num_frames);
+    ASSERT_EQ(lru_replacer.Size(), order.size());
+    for (auto expected : order) {
+      frame_id_t actual;
+      ASSERT_TRUE(lru_replacer.Evict(&actual));
+      ASSERT_EQ(expected, actual);
+    }
+  }
+}
+
+// Throughput of a buffer-pool-like workload (fetch a random frame, unpin it, evict every fourth operation) against the
+// full-scan reference implementation, at 1K, 100K and 1M frames.
+TEST(LRUKReplacerTest, DISABLED_ThroughputBenchmark) {
+  const size_t k = LRUK_REPLACER_K;
+  auto run = [k](auto *replacer, size_t num_frames, size_t num_ops) {
+    for (size_t i = 0; i < num_frames; i++) {
+      replacer->RecordAccess(static_cast<frame_id_t>(i));
+      replacer->SetEvictable(static_cast<frame_id_t>(i), true);
+    }
+    std::mt19937 gen(15445);
+    std::uniform_int_distribution<frame_id_t> dist(0, num_frames - 1);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_ops; i++) {
+      if (i % 4 == 3) {
+        frame_id_t frame_id;
+        if (replacer->Evict(&frame_id)) {
+          replacer->RecordAccess(frame_id);
+          replacer->SetEvictable(frame_id, true);
+        }
+        continue;
+      }
+      auto frame_id = dist(gen);
+      replacer->SetEvictable(frame_id, false);
+      replacer->RecordAccess(frame_id);
+      replacer->SetEvictable(frame_id, true);
+    }
+    auto dur = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return static_cast<double>(num_ops) * 1000000.0 / static_cast<double>(std::max<int64_t>(1, dur.count()));
+  };
+  for (size_t num_frames : {1000, 100000, 1000000}) {
+    auto replacer = std::make_unique<LRUKReplacer>(num_frames, k);
+    auto reference = std::make_unique<NaiveLRUKReplacer>(num_frames, k);
+    double heap_ops = run(replacer.get(), num_frames, 1000000);
+    // the full scan gets far fewer operations, it would not finish otherwise
+    double naive_ops = run(reference.get(), num_frames, std::max<size_t>(100, 100000000 / num_frames));
+    std::cout << num_frames << " frames: " << heap_ops << " ops/s, full scan " << naive_ops << " ops/s" << std::endl;
+  }
+}
+
 }  // namespace bustub
@@ -61,7 +61,7 @@ class MockBufferPoolManager : public BufferPoolManagerInstance {
   /** Grading function. Do not modify/call! */
   Page *FetchPage(page_id_t page_id, bufferpool_callback_fn callback = &MockBufferPoolManager::counter_callback) {
     GradingCallback(callback, CallbackType::BEFORE, FuncType::FetchPage, page_id);
-    auto *result = FetchPgImp(page_id);
+    auto *result = FetchPgImp(page_id, AccessType::Normal);
     GradingCallback(callback, CallbackType::AFTER, FuncType::FetchPage, page_id);
     return result;
   }
@@ -124,11 +124,12 @@ class MockBufferPoolManager : public BufferPoolManagerInstance {
   /**
    * Fetch the requested page from the buffer pool.
    * @param page_id id of page to be fetched
+   * @param access_type how the page is going to be used
    * @return the requested page
    */
-  Page *FetchPgImp(page_id_t page_id) {
+  Page *FetchPgImp(page_id_t page_id, AccessType access_type) {
     counter.AddCount(FuncType::FetchPage);
-    return BufferPoolManager::FetchPgImp(page_id);
+    return BufferPoolManager::FetchPgImp(page_id, access_type);
   }
 
   /**
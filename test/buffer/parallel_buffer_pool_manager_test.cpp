@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <cstdio>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 2;
+  const size_t k = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager, k);
+  EXPECT_EQ(buffer_pool_size * num_instances, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page.
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+
+  // Scenario: Once we have a page, we should be able to read and write content.
+  snprintf(page0->GetData(), BUSTUB_PAGE_SIZE, "Hello");
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Scenario: We should be able to create new pages until we fill up every instance. Page ids stay unique.
+  std::set<page_id_t> page_ids{page_id_temp};
+  for (size_t i = 1; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(page_ids.insert(page_id_temp).second);
+  }
+
+  // Scenario: Once all the instances are full, we should not be able to create any new pages.
+  for (size_t i = 0; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: After unpinning page 0 and pinning another new page, page 0 is written out and can be read back.
+  EXPECT_TRUE(bpm->UnpinPage(0, true));
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(0, page_id_temp % num_instances);
+  EXPECT_EQ(nullptr, bpm->FetchPage(0));
+  EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrencyTest) {
+  const size_t num_threads = 4;
+  const size_t num_instances = 4;
+  const size_t buffer_pool_size = 16;
+  const size_t pages_per_thread = 100;
+  const std::string db_name = "test.db";
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  std::vector<std::vector<page_id_t>> thread_pages(num_threads);
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      for (size_t i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id;
+        auto *page = bpm->NewPage(&page_id);
+        ASSERT_NE(nullptr, page);
+        snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id);
+        thread_pages[tid].push_back(page_id);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+      }
+      for (auto page_id : thread_pages[tid]) {
+        auto *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(std::to_string(page_id), page->GetData());
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::set<page_id_t> all_pages;
+  for (const auto &pages : thread_pages) {
+    all_pages.insert(pages.begin(), pages.end());
+  }
+  EXPECT_EQ(num_threads * pages_per_thread, all_pages.size());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
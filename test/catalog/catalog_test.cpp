@@ -10,13 +10,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <sstream>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "catalog/catalog.h"
 #include "catalog/table_generator.h"
+#include "common/bustub_instance.h"
 #include "execution/executor_context.h"
 #include "gtest/gtest.h"
 #include "type/value_factory.h"
@@ -688,4 +691,389 @@ TEST(CatalogTest, DISABLED_IndexInteraction3) {
   remove("catalog_test.log");
 }
 
+// Should be able to create and interact with a hash index
+TEST(CatalogTest, HashIndexInteraction) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  auto txn = std::make_unique<Transaction>(0);
+
+  const std::string table_name{"foobar"};
+  const std::string index_name{"index1"};
+
+  // Construct a new table and add it to the catalog
+  std::vector<Column> columns{{"A", TypeId::INTEGER}, {"B", TypeId::INTEGER}};
+  Schema table_schema{columns};
+  auto *table_info = catalog->CreateTable(nullptr, table_name, table_schema);
+  EXPECT_NE(Catalog::NULL_TABLE_INFO, table_info);
+
+  // Construct a hash index for the table
+  std::vector<Column> key_columns{{"A", TypeId::INTEGER}};
+  std::vector<uint32_t> key_attrs{0};
+  Schema key_schema{key_columns};
+
+  auto *index_info = catalog->CreateIndex<GenericKey<4>, RID, GenericComparator<4>>(
+      txn.get(), index_name, table_name, table_schema, key_schema, key_attrs, 4, HashFunction<GenericKey<4>>{},
+      IndexType::HashTableIndex);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, index_info);
+  EXPECT_EQ(IndexType::HashTableIndex, index_info->index_type_);
+  auto *index = index_info->index_.get();
+  using HashIndexType = ExtendibleHashTableIndex<GenericKey<4>, RID, GenericComparator<4>>;
+  EXPECT_NE(nullptr, dynamic_cast<HashIndexType *>(index));
+
+  // Insert an entry
+  Tuple tuple{std::vector<Value>{ValueFactory::GetIntegerValue(100), ValueFactory::GetIntegerValue(101)},
+              &table_schema};
+  RID rid{1, 2};
+  const Tuple index_key = tuple.KeyFromTuple(table_info->schema_, *index->GetKeySchema(), index->GetKeyAttrs());
+  index->InsertEntry(index_key, rid, txn.get());
+
+  // Scan should provide 1 result
+  std::vector<RID> results{};
+  index->ScanKey(index_key, &results, txn.get());
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(rid, results[0]);
+
+  // Delete the entry
+  index->DeleteEntry(index_key, rid, txn.get());
+
+  // Scan should now provide 0 results
+  results.clear();
+  index->ScanKey(index_key, &results, txn.get());
+  ASSERT_TRUE(results.empty());
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(CatalogTest, CreateIndexOnPopulatedTable) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  auto txn = std::make_unique<Transaction>(0);
+
+  // the b+ tree keeps its root page id in the header page
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+
+  std::vector<Column> columns{{"A", TypeId::INTEGER}, {"B", TypeId::INTEGER}};
+  Schema table_schema{columns};
+  auto *table_info = catalog->CreateTable(txn.get(), "foobar", table_schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+
+  // fill the table in descending key order before the index exists
+  const int num_tuples = 5000;
+  std::vector<RID> rids(num_tuples);
+  for (int key = num_tuples - 1; key >= 0; key--) {
+    Tuple tuple{std::vector<Value>{ValueFactory::GetIntegerValue(key), ValueFactory::GetIntegerValue(-key)},
+                &table_schema};
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rids[key], txn.get()));
+  }
+
+  std::vector<Column> key_columns{{"A", TypeId::INTEGER}};
+  std::vector<uint32_t> key_attrs{0};
+  Schema key_schema{key_columns};
+  auto *index_info = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      txn.get(), "index1", "foobar", table_schema, key_schema, key_attrs, 8, HashFunction<GenericKey<8>>{});
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, index_info);
+
+  // every tuple is found through the index, and the index iterates in key order
+  auto *index = index_info->index_.get();
+  std::vector<RID> results;
+  for (int key = 0; key < num_tuples; key++) {
+    Tuple tuple{std::vector<Value>{ValueFactory::GetIntegerValue(key), ValueFactory::GetIntegerValue(-key)},
+                &table_schema};
+    results.clear();
+    index->ScanKey(tuple.KeyFromTuple(table_schema, key_schema, key_attrs), &results, txn.get());
+    ASSERT_EQ(1, results.size());
+    EXPECT_EQ(rids[key], results[0]);
+  }
+  auto *tree_index = dynamic_cast<BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> *>(index);
+  ASSERT_NE(nullptr, tree_index);
+  int key = 0;
+  for (auto it = tree_index->GetBeginIterator(); it != tree_index->GetEndIterator(); ++it) {
+    EXPECT_EQ(rids[key++], (*it).second);
+  }
+  EXPECT_EQ(num_tuples, key);
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(CatalogTest, CreateCoveringIndex) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  auto txn = std::make_unique<Transaction>(0);
+
+  // the b+ tree keeps its root page id in the header page
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+
+  std::vector<Column> columns{{"A", TypeId::INTEGER}, {"B", TypeId::INTEGER}, {"C", TypeId::VARCHAR, 16}};
+  Schema table_schema{columns};
+  auto *table_info = catalog->CreateTable(txn.get(), "foobar", table_schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+
+  const int num_tuples = 1000;
+  auto make_tuple = [&](int key) {
+    return Tuple{std::vector<Value>{ValueFactory::GetIntegerValue(key), ValueFactory::GetIntegerValue(-key),
+                                    ValueFactory::GetVarcharValue(std::to_string(key))},
+                 &table_schema};
+  };
+  std::vector<RID> rids(num_tuples);
+  for (int key = num_tuples - 1; key >= 0; key--) {
+    ASSERT_TRUE(table_info->table_->InsertTuple(make_tuple(key), &rids[key], txn.get()));
+  }
+
+  // only variable length keys hold included columns
+  std::vector<Column> key_columns{{"A", TypeId::INTEGER}};
+  std::vector<uint32_t> key_attrs{0};
+  std::vector<uint32_t> include_attrs{2, 1};
+  Schema key_schema{key_columns};
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO,
+            (catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                txn.get(), "index1", "foobar", table_schema, key_schema, key_attrs, 8, HashFunction<GenericKey<8>>{},
+                IndexType::BPlusTreeIndex, include_attrs)));
+  auto *index_info = catalog->CreateIndex<VarlenKeyType, RID, VarlenComparatorType>(
+      txn.get(), "index1", "foobar", table_schema, key_schema, key_attrs, VARLEN_KEY_SIZE, VarlenHashFunctionType{},
+      IndexType::BPlusTreeIndex, include_attrs);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, index_info);
+
+  // the entries hold the key followed by the included columns, in the order they were given
+  auto *index = index_info->index_.get();
+  auto *entry_schema = index->GetEntrySchema();
+  ASSERT_EQ((std::vector<uint32_t>{0, 2, 1}), index->GetEntryAttrs());
+  ASSERT_EQ(3, entry_schema->GetColumnCount());
+
+  // keys are compared on the key column alone, so a key tuple finds the entry of its key
+  std::vector<RID> results;
+  Tuple lo{std::vector<Value>{ValueFactory::GetIntegerValue(10)}, &key_schema};
+  Tuple hi{std::vector<Value>{ValueFactory::GetIntegerValue(19)}, &key_schema};
+  index->ScanKey(lo, &results, txn.get());
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(rids[10], results[0]);
+
+  std::vector<std::pair<Tuple, RID>> entries;
+  index->ScanRangeEntries(&lo, &hi, true, 5, &entries, txn.get());
+  ASSERT_EQ(5, entries.size());
+  for (int i = 0; i < 5; i++) {
+    int key = 19 - i;
+    const auto &[entry, rid] = entries[i];
+    EXPECT_EQ(rids[key], rid);
+    EXPECT_EQ(key, entry.GetValue(entry_schema, 0).GetAs<int32_t>());
+    EXPECT_EQ(std::to_string(key), entry.GetValue(entry_schema, 1).ToString());
+    EXPECT_EQ(-key, entry.GetValue(entry_schema, 2).GetAs<int32_t>());
+  }
+
+  // an entry is removed by its key, and inserting one of the same key with other included values fails
+  index->DeleteEntry(make_tuple(10).KeyFromTuple(table_schema, *entry_schema, index->GetEntryAttrs()), rids[10],
+                     txn.get());
+  results.clear();
+  index->ScanKey(lo, &results, txn.get());
+  EXPECT_TRUE(results.empty());
+  index->InsertEntry(make_tuple(10).KeyFromTuple(table_schema, *entry_schema, index->GetEntryAttrs()), rids[10],
+                     txn.get());
+  index->InsertEntry(
+      Tuple{std::vector<Value>{ValueFactory::GetIntegerValue(11), ValueFactory::GetVarcharValue("x"),
+                               ValueFactory::GetIntegerValue(0)},
+            entry_schema},
+      RID{}, txn.get());
+  entries.clear();
+  index->ScanRangeEntries(nullptr, nullptr, false, num_tuples + 1, &entries, txn.get());
+  ASSERT_EQ(num_tuples, entries.size());
+  EXPECT_EQ(rids[11], entries[11].second);
+  EXPECT_EQ("11", entries[11].first.GetValue(entry_schema, 1).ToString());
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+TEST(CatalogTest, ReopenPersistentCatalog) {
+  remove("catalog_test.db");
+  std::vector<Column> columns{{"A", TypeId::INTEGER}, {"B", TypeId::INTEGER}, {"C", TypeId::VARCHAR, 16}};
+  Schema table_schema{columns};
+  std::vector<Column> key_columns{{"A", TypeId::INTEGER}};
+  Schema key_schema{key_columns};
+  std::vector<Column> hash_key_columns{{"B", TypeId::INTEGER}};
+  Schema hash_key_schema{hash_key_columns};
+  const int num_tuples = 1000;
+  auto make_tuple = [&](int key) {
+    return Tuple{std::vector<Value>{ValueFactory::GetIntegerValue(key), ValueFactory::GetIntegerValue(-key),
+                                    ValueFactory::GetVarcharValue(std::to_string(key))},
+                 &table_schema};
+  };
+  std::vector<RID> rids(num_tuples);
+  table_oid_t table_oid;
+
+  {
+    auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+    auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+    auto txn = std::make_unique<Transaction>(0);
+
+    // the header page comes first, then the first catalog page
+    page_id_t page_id;
+    bpm->NewPageGuarded(&page_id).AsPageMut<HeaderPage>()->Init();
+    ASSERT_EQ(HEADER_PAGE_ID, page_id);
+    bpm->NewPageGuarded(&page_id).Drop();
+    ASSERT_EQ(CATALOG_PAGE_ID, page_id);
+    catalog->EnablePersistence(CATALOG_PAGE_ID);
+    ASSERT_TRUE(catalog->IsPersistent());
+
+    auto *table_info = catalog->CreateTable(txn.get(), "foobar", table_schema);
+    ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+    table_oid = table_info->oid_;
+    for (int key = 0; key < num_tuples; key++) {
+      ASSERT_TRUE(table_info->table_->InsertTuple(make_tuple(key), &rids[key], txn.get()));
+    }
+    ASSERT_NE(Catalog::NULL_INDEX_INFO,
+              (catalog->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+                  txn.get(), "index1", "foobar", table_schema, key_schema, {0}, INTEGER_SIZE,
+                  IntegerHashFunctionType{})));
+    ASSERT_NE(Catalog::NULL_INDEX_INFO,
+              (catalog->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+                  txn.get(), "index2", "foobar", table_schema, hash_key_schema, {1}, INTEGER_SIZE,
+                  IntegerHashFunctionType{}, IndexType::HashTableIndex)));
+    // index names are unique in the database, not only in a table
+    ASSERT_EQ(Catalog::NULL_INDEX_INFO,
+              (catalog->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+                  txn.get(), "index1", "foobar", table_schema, hash_key_schema, {1}, INTEGER_SIZE,
+                  IntegerHashFunctionType{})));
+    bpm->FlushAllPages();
+  }
+
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  auto txn = std::make_unique<Transaction>(0);
+  const page_id_t num_pages = disk_manager->GetNumPages();
+  ASSERT_GT(num_pages, CATALOG_PAGE_ID);
+  bpm->ReservePageIds(num_pages);
+  auto indexes = catalog->Open(CATALOG_PAGE_ID);
+  ASSERT_EQ(2, indexes.size());
+  for (const auto &index : indexes) {
+    ASSERT_NE(Catalog::NULL_INDEX_INFO,
+              (catalog->AttachIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+                  index, IntegerHashFunctionType{})));
+  }
+
+  // the table is read from the pages it had, and new pages are allocated past them
+  auto *table_info = catalog->GetTable("foobar");
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  ASSERT_EQ(table_oid, table_info->oid_);
+  ASSERT_EQ(3, table_info->schema_.GetColumnCount());
+  ASSERT_EQ(16, table_info->schema_.GetColumn(2).GetLength());
+  int num_read = 0;
+  for (auto iter = table_info->table_->Begin(txn.get()); iter != table_info->table_->End(); ++iter) {
+    EXPECT_EQ(rids[num_read], iter->GetRid());
+    EXPECT_EQ(std::to_string(num_read), iter->GetValue(&table_info->schema_, 2).ToString());
+    num_read++;
+  }
+  ASSERT_EQ(num_tuples, num_read);
+  page_id_t page_id;
+  bpm->NewPageGuarded(&page_id).Drop();
+  EXPECT_GE(page_id, num_pages);
+
+  auto *tree_index = catalog->GetIndex("index1", "foobar");
+  auto *hash_index = catalog->GetIndex("index2", "foobar");
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, tree_index);
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, hash_index);
+  EXPECT_EQ(IndexType::HashTableIndex, hash_index->index_type_);
+  for (int key = 0; key < num_tuples; key += 7) {
+    std::vector<RID> results;
+    tree_index->index_->ScanKey(Tuple{std::vector<Value>{ValueFactory::GetIntegerValue(key)}, &key_schema}, &results,
+                                txn.get());
+    ASSERT_EQ(1, results.size());
+    EXPECT_EQ(rids[key], results[0]);
+    results.clear();
+    hash_index->index_->ScanKey(Tuple{std::vector<Value>{ValueFactory::GetIntegerValue(-key)}, &hash_key_schema},
+                                &results, txn.get());
+    ASSERT_EQ(1, results.size());
+    EXPECT_EQ(rids[key], results[0]);
+  }
+
+  // oids go on from where they were
+  auto *other_info = catalog->CreateTable(txn.get(), "other", table_schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, other_info);
+  EXPECT_GT(other_info->oid_, table_oid);
+  auto *index_info = catalog->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+      txn.get(), "index3", "other", table_schema, key_schema, {0}, INTEGER_SIZE, IntegerHashFunctionType{});
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, index_info);
+  EXPECT_GT(index_info->index_oid_, hash_index->index_oid_);
+
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
+TEST(CatalogTest, ReopenDatabase) {
+  // once through the fstream based disk manager, once through the one doing positional I/O
+  for (bool posix_io : {false, true}) {
+    remove("catalog_test.db");
+    const int num_tuples = 1000;
+    std::vector<RID> rids(num_tuples);
+
+    {
+      BustubInstance bustub("catalog_test.db", 1, posix_io);
+      NoopWriter writer;
+      ASSERT_TRUE(bustub.ExecuteSql("create table foobar (a int, b int, c varchar(16));", writer));
+      auto *table_info = bustub.catalog_->GetTable("foobar");
+      ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+      auto txn = std::make_unique<Transaction>(0);
+      for (int key = 0; key < num_tuples; key++) {
+        Tuple tuple{std::vector<Value>{ValueFactory::GetIntegerValue(key), ValueFactory::GetIntegerValue(-key),
+                                       ValueFactory::GetVarcharValue(std::to_string(key))},
+                    &table_info->schema_};
+        ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rids[key], txn.get()));
+      }
+      // a covering index and one on a varchar column both take variable length keys, in slotted leaves
+      ASSERT_TRUE(bustub.ExecuteSql("create index cover on foobar(a) with (include = 'b');", writer));
+      ASSERT_TRUE(bustub.ExecuteSql("create index name on foobar(c);", writer));
+    }
+
+    // a database file with pages in it is opened rather than created
+    BustubInstance bustub("catalog_test.db", 1, posix_io);
+    auto *cover = bustub.catalog_->GetIndex("cover", "foobar");
+    auto *name = bustub.catalog_->GetIndex("name", "foobar");
+    ASSERT_NE(Catalog::NULL_INDEX_INFO, cover);
+    ASSERT_NE(Catalog::NULL_INDEX_INFO, name);
+    EXPECT_EQ((std::vector<uint32_t>{0, 1}), cover->index_->GetEntryAttrs());
+
+    auto txn = std::make_unique<Transaction>(0);
+    for (int key = 0; key < num_tuples; key += 7) {
+      std::vector<RID> results;
+      cover->index_->ScanKey(Tuple{std::vector<Value>{ValueFactory::GetIntegerValue(key)}, &cover->key_schema_},
+                             &results, txn.get());
+      ASSERT_EQ(1, results.size());
+      EXPECT_EQ(rids[key], results[0]);
+      results.clear();
+      name->index_->ScanKey(Tuple{std::vector<Value>{ValueFactory::GetVarcharValue(std::to_string(key))},
+                                  &name->key_schema_},
+                            &results, txn.get());
+      ASSERT_EQ(1, results.size());
+      EXPECT_EQ(rids[key], results[0]);
+    }
+
+    // the reopened indexes answer queries, and new entries go into them
+    std::stringstream result;
+    SimpleStreamWriter writer(result, true, " ");
+    ASSERT_TRUE(bustub.ExecuteSql("select a, b from foobar where a >= 997;", writer));
+    EXPECT_EQ("997 -997 \n998 -998 \n999 -999 \n", result.str());
+    std::vector<std::pair<Tuple, RID>> entries;
+    cover->index_->InsertEntry(Tuple{std::vector<Value>{ValueFactory::GetIntegerValue(num_tuples),
+                                                        ValueFactory::GetIntegerValue(0)},
+                                     cover->index_->GetEntrySchema()},
+                               RID{}, txn.get());
+    cover->index_->ScanRangeEntries(nullptr, nullptr, false, num_tuples + 1, &entries, txn.get());
+    EXPECT_EQ(num_tuples + 1, entries.size());
+
+    remove("catalog_test.db");
+    remove("catalog_test.log");
+  }
+}
+
 }  // namespace bustub
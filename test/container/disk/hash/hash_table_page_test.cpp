@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <memory>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -17,13 +19,16 @@
 #include "common/logger.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/index/generic_key.h"
 #include "storage/page/hash_table_bucket_page.h"
 #include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_probe.h"
+#include "test_util.h"  // NOLINT
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
+TEST(HashTablePageTest, DirectoryPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
 
@@ -57,7 +62,7 @@ TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
+TEST(HashTablePageTest, BucketPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
 
@@ -114,4 +119,60 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, ProbeTest) {
+  // bit scans across word and 128-bit chunk boundaries
+  std::vector<uint8_t> bitmap(64, 0);
+  EXPECT_EQ(512, HashTableProbe::NextSetBit(bitmap.data(), 0, 512));
+  EXPECT_EQ(0, HashTableProbe::NextClearBit(bitmap.data(), 0, 512));
+  EXPECT_FALSE(HashTableProbe::AnySet(bitmap.data(), bitmap.size()));
+  for (size_t slot : {3, 63, 64, 200, 511}) {
+    bitmap[slot / 8] |= 1 << (slot % 8);
+  }
+  EXPECT_EQ(5, HashTableProbe::CountSetBits(bitmap.data(), bitmap.size()));
+  EXPECT_EQ(3, HashTableProbe::NextSetBit(bitmap.data(), 0, 512));
+  EXPECT_EQ(63, HashTableProbe::NextSetBit(bitmap.data(), 4, 512));
+  EXPECT_EQ(64, HashTableProbe::NextSetBit(bitmap.data(), 64, 512));
+  EXPECT_EQ(200, HashTableProbe::NextSetBit(bitmap.data(), 65, 512));
+  EXPECT_EQ(150, HashTableProbe::NextSetBit(bitmap.data(), 65, 150));
+  EXPECT_EQ(511, HashTableProbe::NextSetBit(bitmap.data(), 201, 512));
+  std::fill(bitmap.begin(), bitmap.end(), 0xFF);
+  bitmap[300 / 8] &= ~(1 << (300 % 8));
+  EXPECT_EQ(300, HashTableProbe::NextClearBit(bitmap.data(), 0, 512));
+  EXPECT_EQ(512, HashTableProbe::NextClearBit(bitmap.data(), 301, 512));
+  EXPECT_EQ(299, HashTableProbe::NextClearBit(bitmap.data(), 0, 299));
+
+  // batched key compares
+  const int keys[] = {7, 1, 7, 7, 2, 7};
+  EXPECT_EQ(0b1101, HashTableProbe::MatchKeys4(reinterpret_cast<const char *>(keys), sizeof(int), 7));
+  EXPECT_EQ(0b1000, HashTableProbe::MatchKeys4(reinterpret_cast<const char *>(keys + 1), sizeof(int), 2));
+
+  // integer generic keys are compared bitwise
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  EXPECT_TRUE(comparator.HasBitwiseEquality());
+  auto page = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+  auto &bucket_page = *reinterpret_cast<HashTableBucketPage<GenericKey<8>, RID, GenericComparator<8>> *>(page.get());
+  GenericKey<8> index_key;
+  for (uint32_t i = 0; i < 100; i++) {
+    index_key.SetFromInteger(i % 10);
+    EXPECT_TRUE(bucket_page.Insert(index_key, RID(0, i), comparator));
+  }
+  for (uint32_t i = 0; i < 100; i += 3) {
+    index_key.SetFromInteger(i % 10);
+    EXPECT_TRUE(bucket_page.Remove(index_key, RID(0, i), comparator));
+  }
+  for (uint32_t key = 0; key < 10; key++) {
+    index_key.SetFromInteger(key);
+    std::vector<RID> result;
+    EXPECT_TRUE(bucket_page.GetValue(index_key, comparator, &result));
+    for (auto rid : result) {
+      EXPECT_EQ(key, rid.GetSlotNum() % 10);
+      EXPECT_NE(0, rid.GetSlotNum() % 3);
+    }
+    // of the ten values of a key, the multiples of 3 were removed
+    EXPECT_EQ(key % 3 == 0 ? 6 : 7, result.size());
+  }
+}
+
 }  // namespace bustub
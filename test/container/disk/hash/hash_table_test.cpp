@@ -24,7 +24,7 @@ namespace bustub {
 // NOLINTNEXTLINE
 
 // NOLINTNEXTLINE
-TEST(HashTableTest, DISABLED_SampleTest) {
+TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
   DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
@@ -117,4 +117,118 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, SplitMergeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // enough pairs to fill a few dozen buckets
+  const int num_keys = 10000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_GT(ht.GetGlobalDepth(), 0);
+
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(1, res.size()) << "Failed to keep " << i;
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // emptying the table merges every bucket back into one
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentInsertGetTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  const int num_threads = 4;
+  const int keys_per_thread = 3000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&ht, t] {
+      for (int i = t * keys_per_thread; i < (t + 1) * keys_per_thread; i++) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+        // a key must stay visible while other threads split the buckets around it
+        std::vector<int> res;
+        ht.GetValue(nullptr, i - (i - t * keys_per_thread) / 2, &res);
+        EXPECT_EQ(1, res.size());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ht.VerifyIntegrity();
+
+  threads.clear();
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&ht, t] {
+      for (int i = t * keys_per_thread; i < (t + 1) * keys_per_thread; i++) {
+        if (i % 2 == 0) {
+          EXPECT_TRUE(ht.Remove(nullptr, i, i));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ht.VerifyIntegrity();
+
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(i % 2 == 0 ? 0 : 1, res.size()) << "Wrong result for " << i;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ExhaustedPoolTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(4, disk_manager);
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // pin every frame so that the directory page cannot be brought back in
+  std::vector<page_id_t> pinned;
+  page_id_t page_id;
+  while (bpm->NewPage(&page_id) != nullptr) {
+    pinned.push_back(page_id);
+  }
+  EXPECT_THROW(ht.GetGlobalDepth(), Exception);
+  EXPECT_THROW(ht.VerifyIntegrity(), Exception);
+
+  // the table latch was released, so a writer gets in once a frame frees up
+  for (page_id_t id : pinned) {
+    bpm->UnpinPage(id, false);
+  }
+  EXPECT_TRUE(ht.Insert(nullptr, 1, 1));
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
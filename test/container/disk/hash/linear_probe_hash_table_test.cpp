@@ -0,0 +1,249 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_hash_table_test.cpp
+//
+// Identification: test/container/disk/hash/linear_probe_hash_table_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/disk/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_TRUE(ht.Insert(nullptr, i, 2 * i + 1));
+    // duplicate pairs are not allowed
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+  }
+  for (int i = 0; i < 5; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    std::sort(res.begin(), res.end());
+    EXPECT_EQ((std::vector<int>{i, 2 * i + 1}), res);
+  }
+
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ((std::vector<int>{2 * i + 1}), res);
+  }
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, IncrementalResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  // fill the table up to the point where the next insert starts a resize
+  const auto threshold = static_cast<int>(1000 * decltype(ht)::MAX_LOAD_FACTOR);
+  for (int i = 0; i < threshold; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_EQ(1000, ht.GetSize());
+  EXPECT_TRUE(ht.Insert(nullptr, threshold, threshold));
+  EXPECT_EQ(2000, ht.GetSize());
+
+  // while the entries move over, every one of them stays visible exactly once, and can be removed or re-inserted
+  for (int i = 0; i < threshold; i += 100) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ((std::vector<int>{i}), res);
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+
+  // enough operations to move the whole old table over, growing the table once more on the way
+  const int num_keys = 5000;
+  for (int i = threshold + 1; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  ht.FinishResize();
+  EXPECT_GE(ht.GetSize(), 8000);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ((std::vector<int>{i}), res) << "Wrong result for " << i;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, ConcurrentResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(100, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+
+  // a resize for a size the table has grown past already does nothing
+  EXPECT_TRUE(ht.Resize(ht.GetSize()));
+  ht.FinishResize();
+  EXPECT_EQ(20, ht.GetSize());
+  EXPECT_TRUE(ht.Resize(10));
+  ht.FinishResize();
+  EXPECT_EQ(20, ht.GetSize());
+
+  // starting from a tiny table, inserts keep finding it full or in the middle of a resize; none of them fails
+  const int num_threads = 4;
+  const int keys_per_thread = 2000;
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&ht, tid] {
+      for (int i = 0; i < keys_per_thread; i++) {
+        EXPECT_TRUE(ht.Insert(nullptr, i * num_threads + tid, i));
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  ht.FinishResize();
+  for (int key = 0; key < num_threads * keys_per_thread; key++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, key, &res);
+    EXPECT_EQ((std::vector<int>{key / num_threads}), res) << "Wrong result for " << key;
+  }
+
+  // the count of occupied slots survived the resizes: a table that is not too full does not grow
+  const size_t size = ht.GetSize();
+  EXPECT_GE(static_cast<double>(size) * decltype(ht)::MAX_LOAD_FACTOR, num_threads * keys_per_thread);
+  EXPECT_LT(static_cast<double>(size) / 2 * decltype(ht)::MAX_LOAD_FACTOR, num_threads * keys_per_thread);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, ChurnTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 100, HashFunction<int>());
+
+  // every remove leaves a tombstone, but with a constant number of live entries the table does not keep growing
+  const int num_live = 50;
+  const int num_rounds = 20000;
+  for (int i = 0; i < num_live; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  for (int i = num_live; i < num_live + num_rounds; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_TRUE(ht.Remove(nullptr, i - num_live, i - num_live));
+    EXPECT_LE(ht.GetSize(), 200);
+  }
+  ht.FinishResize();
+  for (int i = num_rounds; i < num_live + num_rounds; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ((std::vector<int>{i}), res) << "Wrong result for " << i;
+  }
+
+  // once the entries are gone, the next rebuild shrinks the table back to its initial size
+  for (int i = num_rounds; i < num_live + num_rounds; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < 200; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, -1, i));
+    EXPECT_TRUE(ht.Remove(nullptr, -1, i));
+  }
+  ht.FinishResize();
+  EXPECT_EQ(100, ht.GetSize());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, DISABLED_ResizeLatencyBenchmark) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(4096, disk_manager);
+  const int num_keys = 100000;
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 2 * num_keys, HashFunction<int>());
+  for (int i = 0; i < num_keys; i++) {
+    ht.Insert(nullptr, i, i);
+  }
+
+  // samples the latency of GetValue() on a second thread while the main thread does something else
+  auto sample_get_latency = [&ht](const std::function<void()> &work) {
+    std::atomic<bool> done{false};
+    std::vector<int64_t> latencies;
+    std::thread reader([&] {
+      std::mt19937 gen(0);
+      std::uniform_int_distribution<int> dist(0, num_keys - 1);
+      while (!done) {
+        std::vector<int> res;
+        auto start = std::chrono::steady_clock::now();
+        ht.GetValue(nullptr, dist(gen), &res);
+        latencies.push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+      }
+    });
+    work();
+    done = true;
+    reader.join();
+    std::sort(latencies.begin(), latencies.end());
+    auto quantile = [&latencies](double q) { return latencies[static_cast<size_t>(q * (latencies.size() - 1))]; };
+    std::cout << latencies.size() << " lookups, p50 " << quantile(0.5) << "us, p99 " << quantile(0.99) << "us, p99.9 "
+              << quantile(0.999) << "us, max " << latencies.back() << "us" << std::endl;
+  };
+
+  std::cout << "no resize: ";
+  sample_get_latency([&ht] {
+    for (int i = 0; i < num_keys; i++) {
+      ht.Remove(nullptr, -1, -1);
+    }
+  });
+  std::cout << "resize, moved over by writers: ";
+  sample_get_latency([&ht] {
+    ht.Resize(ht.GetSize());
+    for (int i = num_keys; i < num_keys + num_keys / 2; i++) {
+      ht.Insert(nullptr, i, i);
+    }
+    ht.FinishResize();
+  });
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
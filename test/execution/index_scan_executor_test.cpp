@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_scan_executor_test.cpp
+//
+// Identification: test/execution/index_scan_executor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "execution/executor_context.h"
+#include "execution/executors/index_scan_executor.h"
+#include "execution/plans/index_scan_plan.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(IndexScanExecutorTest, LimitSkipsMissingTuples) {
+  auto disk_manager = std::make_unique<DiskManager>("executor_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  auto txn = std::make_unique<Transaction>(0);
+  ExecutorContext exec_ctx(txn.get(), catalog.get(), bpm.get(), nullptr, nullptr);
+
+  // the b+ tree keeps its root page id in the header page
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+
+  std::vector<Column> columns{{"A", TypeId::INTEGER}, {"B", TypeId::INTEGER}};
+  auto table_schema = std::make_shared<const Schema>(columns);
+  auto *table_info = catalog->CreateTable(txn.get(), "foobar", *table_schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  const int num_tuples = 10;
+  std::vector<RID> rids(num_tuples);
+  for (int key = 0; key < num_tuples; key++) {
+    Tuple tuple{std::vector<Value>{ValueFactory::GetIntegerValue(key), ValueFactory::GetIntegerValue(-key)},
+                table_schema.get()};
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rids[key], txn.get()));
+  }
+  std::vector<Column> key_columns{{"A", TypeId::INTEGER}};
+  Schema key_schema{key_columns};
+  auto *index_info = catalog->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+      txn.get(), "index1", "foobar", *table_schema, key_schema, {0}, INTEGER_SIZE, IntegerHashFunctionType{});
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, index_info);
+
+  // the tuples go, but their index entries stay
+  for (int key : {1, 2, 8}) {
+    ASSERT_TRUE(table_info->table_->MarkDelete(rids[key], txn.get()));
+    table_info->table_->ApplyDelete(rids[key], txn.get());
+  }
+
+  auto scan = [&](bool reverse, size_t limit) {
+    IndexScanPlanNode plan(table_schema, index_info->index_oid_, nullptr, nullptr, nullptr, reverse, limit);
+    IndexScanExecutor executor(&exec_ctx, &plan);
+    executor.Init();
+    std::vector<int> keys;
+    Tuple tuple;
+    RID rid;
+    while (executor.Next(&tuple, &rid)) {
+      keys.push_back(tuple.GetValue(table_schema.get(), 0).GetAs<int32_t>());
+      EXPECT_EQ(rids[keys.back()], rid);
+    }
+    return keys;
+  };
+
+  // entries without a tuple do not count towards the limit
+  EXPECT_EQ((std::vector<int>{0, 3, 4}), scan(false, 3));
+  EXPECT_EQ((std::vector<int>{9, 7, 6}), scan(true, 3));
+  EXPECT_EQ((std::vector<int>{0}), scan(false, 1));
+  EXPECT_EQ((std::vector<int>{0, 3, 4, 5, 6, 7, 9}), scan(false, num_tuples));
+
+  // a run of entries without a tuple takes several more rounds, each going on past the last entry of the one before
+  for (int key : {4, 5, 6}) {
+    ASSERT_TRUE(table_info->table_->MarkDelete(rids[key], txn.get()));
+    table_info->table_->ApplyDelete(rids[key], txn.get());
+  }
+  EXPECT_EQ((std::vector<int>{0, 3, 7}), scan(false, 3));
+  EXPECT_EQ((std::vector<int>{9, 7, 3}), scan(true, 3));
+  EXPECT_EQ((std::vector<int>{0, 3, 7, 9}), scan(false, 5));
+
+  remove("executor_test.db");
+  remove("executor_test.log");
+}
+
+}  // namespace bustub
@@ -2,11 +2,15 @@
  * b_plus_tree_contention_test.cpp
  */
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
 #include <future>  // NOLINT
 #include <iostream>
+#include <numeric>
+#include <random>
 #include <thread>  // NOLINT
 
 #include "buffer/buffer_pool_manager_instance.h"
@@ -154,4 +158,106 @@ TEST(BPlusTreeTest, DISABLED_BPlusTreeContentionBenchmark2) {  // NOLINT
             << std::endl;
 }
 
+// Point lookups only. Readers descend through the internal pages without latching them, so throughput should keep
+// growing with the thread count instead of flattening out on the root page's latch.
+TEST(BPlusTreeTest, DISABLED_GetValueScalingBenchmark) {  // NOLINT
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerMemory(256 << 10);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(1024, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 100000;
+  GenericKey<8> index_key;
+  RID rid;
+  for (int64_t key = 0; key < num_keys; key++) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid);
+  }
+
+  const int lookups_per_thread = 100000;
+  for (size_t num_threads : {1, 2, 4, 8, 16, 32}) {
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([&tree, tid, num_keys, lookups_per_thread]() {
+        std::mt19937 gen(tid);
+        std::uniform_int_distribution<int64_t> dist(0, num_keys - 1);
+        GenericKey<8> key;
+        std::vector<RID> rids;
+        for (int i = 0; i < lookups_per_thread; i++) {
+          rids.clear();
+          key.SetFromInteger(dist(gen));
+          tree.GetValue(key, &rids);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    auto lookups_per_sec = num_threads * lookups_per_thread * 1000 / std::max<int64_t>(1, dur.count());
+    std::cout << num_threads << " threads: " << lookups_per_sec << " lookups/s" << std::endl;
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+// Concurrent inserts only. Most inserts fit into their leaf, which writers latch without latching anything above it,
+// so throughput should keep growing with the thread count for random keys. Sequential keys all land in the rightmost
+// leaf and show how far contention on a single leaf goes.
+TEST(BPlusTreeTest, DISABLED_InsertThroughputBenchmark) {  // NOLINT
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const int64_t num_keys = 200000;
+
+  for (bool sequential : {true, false}) {
+    std::vector<int64_t> keys(num_keys);
+    std::iota(keys.begin(), keys.end(), 0);
+    if (!sequential) {
+      std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+    }
+    for (size_t num_threads : {1, 2, 4, 8, 16}) {
+      auto *disk_manager = new DiskManagerMemory(256 << 10);
+      BufferPoolManager *bpm = new BufferPoolManagerInstance(4096, disk_manager);
+      BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+      page_id_t page_id;
+      auto *header_page = bpm->NewPage(&page_id);
+      (void)header_page;
+
+      // threads take keys from a shared cursor, so sequential keys are inserted in (roughly) ascending order
+      std::atomic<int64_t> next{0};
+      std::vector<std::thread> threads;
+      auto start = std::chrono::steady_clock::now();
+      for (size_t tid = 0; tid < num_threads; tid++) {
+        threads.emplace_back([&tree, &keys, &next, num_keys]() {
+          GenericKey<8> index_key;
+          RID rid;
+          for (int64_t i = next.fetch_add(1); i < num_keys; i = next.fetch_add(1)) {
+            rid.Set(0, keys[i]);
+            index_key.SetFromInteger(keys[i]);
+            tree.Insert(index_key, rid);
+          }
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+      std::cout << (sequential ? "sequential" : "random") << " keys, " << num_threads
+                << " threads: " << num_keys * 1000 / std::max<int64_t>(1, dur.count()) << " inserts/s" << std::endl;
+
+      bpm->UnpinPage(HEADER_PAGE_ID, true);
+      delete bpm;
+      delete disk_manager;
+    }
+  }
+}
+
 }  // namespace bustub
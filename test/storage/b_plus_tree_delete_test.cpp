@@ -12,6 +12,8 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
+#include <set>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
@@ -20,7 +22,7 @@
 
 namespace bustub {
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
+TEST(BPlusTreeTests, DeleteTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -92,7 +94,7 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
+TEST(BPlusTreeTests, DeleteTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -163,4 +165,68 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, RandomizedInsertDeleteTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  // small pages so that splits, merges and redistributions reach several levels
+  for (auto [leaf_max_size, internal_max_size] : {std::pair{2, 3}, std::pair{3, 4}, std::pair{5, 5}}) {
+    auto *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, leaf_max_size,
+                                                             internal_max_size);
+    GenericKey<8> index_key;
+    RID rid;
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+
+    std::mt19937 gen(leaf_max_size);
+    std::uniform_int_distribution<int64_t> dist(0, 499);
+    std::set<int64_t> expected;
+    for (int round = 0; round < 4000; round++) {
+      int64_t key = dist(gen);
+      index_key.SetFromInteger(key);
+      // grow for the first half, then shrink back down
+      if (gen() % 4 < (round < 2000 ? 3U : 1U)) {
+        rid.Set(0, key);
+        EXPECT_EQ(expected.insert(key).second, tree.Insert(index_key, rid));
+      } else {
+        tree.Remove(index_key);
+        expected.erase(key);
+      }
+
+      if (round % 250 == 0) {
+        std::vector<RID> rids;
+        for (int64_t probe = 0; probe < 500; probe++) {
+          rids.clear();
+          index_key.SetFromInteger(probe);
+          EXPECT_EQ(expected.count(probe) == 1, tree.GetValue(index_key, &rids)) << probe;
+        }
+        auto expected_it = expected.begin();
+        for (auto it = tree.Begin(); it != tree.End(); ++it, ++expected_it) {
+          ASSERT_NE(expected_it, expected.end());
+          EXPECT_EQ(*expected_it, (*it).first.ToString());
+          EXPECT_EQ(*expected_it, (*it).second.GetSlotNum());
+        }
+        EXPECT_EQ(expected_it, expected.end());
+      }
+    }
+
+    for (auto key : std::vector<int64_t>(expected.begin(), expected.end())) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+    }
+    EXPECT_TRUE(tree.IsEmpty());
+    EXPECT_EQ(tree.Begin(), tree.End());
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete bpm;
+    delete disk_manager;
+    remove("test.db");
+    remove("test.log");
+  }
+}
 }  // namespace bustub
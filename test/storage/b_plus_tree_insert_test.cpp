@@ -11,16 +11,27 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/key_search.h"
+#include "storage/index/varlen_key.h"
+#include "storage/table/tuple.h"
 #include "test_util.h"  // NOLINT
 
 namespace bustub {
 
-TEST(BPlusTreeTests, DISABLED_InsertTest1) {
+TEST(BPlusTreeTests, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -64,7 +75,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest2) {
+TEST(BPlusTreeTests, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -127,7 +138,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest2) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest3) {
+TEST(BPlusTreeTests, InsertTest3) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -195,4 +206,656 @@ TEST(BPlusTreeTests, DISABLED_InsertTest3) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // even keys only, with a duplicate of every tenth key that must lose to the first one
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < 2000; key += 2) {
+    index_key.SetFromInteger(key);
+    entries.emplace_back(index_key, RID(0, key));
+    if (key % 10 == 0) {
+      entries.emplace_back(index_key, RID(1, key));
+    }
+  }
+
+  for (double fill_factor : {1.0, 0.5}) {
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 5, 4);
+    std::vector<std::pair<GenericKey<8>, RID>> unsorted(entries.rbegin(), entries.rend());
+    EXPECT_FALSE(tree.BulkLoad(unsorted.cbegin(), unsorted.cend(), fill_factor));
+    EXPECT_TRUE(tree.IsEmpty());
+    EXPECT_TRUE(tree.BulkLoad(entries.cbegin(), entries.cend(), fill_factor));
+    EXPECT_FALSE(tree.BulkLoad(entries.cbegin(), entries.cend(), fill_factor));
+
+    int64_t expected = 0;
+    for (auto it = tree.Begin(); it != tree.End(); ++it) {
+      EXPECT_EQ(expected, (*it).second.GetSlotNum());
+      EXPECT_EQ(0, (*it).second.GetPageId());
+      expected += 2;
+    }
+    EXPECT_EQ(2000, expected);
+    for (auto it = tree.RBegin(); it != tree.End(); --it) {
+      expected -= 2;
+      EXPECT_EQ(expected, (*it).second.GetSlotNum());
+    }
+    EXPECT_EQ(0, expected);
+
+    // the loaded tree takes inserts and removes like any other
+    for (int64_t key = 1; key < 2000; key += 2) {
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree.Insert(index_key, RID(0, key)));
+    }
+    for (int64_t key = 0; key < 2000; key += 4) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+    }
+    std::vector<RID> rids;
+    for (int64_t key = 0; key < 2000; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      EXPECT_EQ(key % 4 != 0, tree.GetValue(index_key, &rids));
+    }
+    for (int64_t key = 0; key < 2000; key++) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+    }
+    EXPECT_TRUE(tree.IsEmpty());
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, ScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManagerMemory(256 << 10);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // even keys only, on leaves of at most three entries
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 5);
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < 1000; key += 2) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key)));
+  }
+
+  // scan between lo and hi, nullptr for -1, and check that it yields the even keys in between in order
+  auto check_scan = [&](int64_t lo, int64_t hi, int64_t first, int64_t last) {
+    GenericKey<8> lo_key;
+    GenericKey<8> hi_key;
+    lo_key.SetFromInteger(lo);
+    hi_key.SetFromInteger(hi);
+    int64_t expected = first;
+    tree.Scan(lo < 0 ? nullptr : &lo_key, hi < 0 ? nullptr : &hi_key, [&](const auto &batch) {
+      EXPECT_FALSE(batch.empty());
+      EXPECT_LE(batch.size(), 3U);
+      for (const auto &[key, rid] : batch) {
+        EXPECT_EQ(expected, key.ToString());
+        EXPECT_EQ(expected, rid.GetSlotNum());
+        expected += 2;
+      }
+      return true;
+    });
+    EXPECT_EQ(last + 2, expected);
+  };
+  check_scan(-1, -1, 0, 998);
+  check_scan(101, 301, 102, 300);
+  check_scan(100, 300, 100, 300);
+  check_scan(-1, 7, 0, 6);
+  check_scan(991, -1, 992, 998);
+  check_scan(200, 200, 200, 200);
+  check_scan(201, 201, 202, 200);
+  check_scan(300, 100, 300, 298);
+  check_scan(999, -1, 1000, 998);
+
+  // the scan ends as soon as the callback returns false
+  int batches = 0;
+  tree.Scan(nullptr, nullptr, [&batches](const auto &batch) { return ++batches < 2; });
+  EXPECT_EQ(2, batches);
+
+  // the reverse scan yields the same keys, largest first
+  auto check_reverse_scan = [&](int64_t lo, int64_t hi, int64_t first, int64_t last) {
+    GenericKey<8> lo_key;
+    GenericKey<8> hi_key;
+    lo_key.SetFromInteger(lo);
+    hi_key.SetFromInteger(hi);
+    int64_t expected = first;
+    tree.ReverseScan(lo < 0 ? nullptr : &lo_key, hi < 0 ? nullptr : &hi_key, [&](const auto &batch) {
+      EXPECT_FALSE(batch.empty());
+      EXPECT_LE(batch.size(), 3U);
+      for (const auto &[key, rid] : batch) {
+        EXPECT_EQ(expected, key.ToString());
+        EXPECT_EQ(expected, rid.GetSlotNum());
+        expected -= 2;
+      }
+      return true;
+    });
+    EXPECT_EQ(last - 2, expected);
+  };
+  check_reverse_scan(-1, -1, 998, 0);
+  check_reverse_scan(101, 301, 300, 102);
+  check_reverse_scan(100, 300, 300, 100);
+  check_reverse_scan(-1, 7, 6, 0);
+  check_reverse_scan(991, -1, 998, 992);
+  check_reverse_scan(200, 200, 200, 200);
+  check_reverse_scan(201, 201, 200, 202);
+  check_reverse_scan(-1, 0, 0, 0);
+  batches = 0;
+  tree.ReverseScan(nullptr, nullptr, [&batches](const auto &batch) { return ++batches < 2; });
+  EXPECT_EQ(2, batches);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BPlusTreeTests, ReverseIteratorTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManagerMemory(256 << 10);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // even keys only, inserted in random order so that leaves split everywhere
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 5);
+  std::vector<int64_t> keys(500);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(23));
+  GenericKey<8> index_key;
+  for (int64_t key : keys) {
+    index_key.SetFromInteger(2 * key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, 2 * key)));
+  }
+
+  // walk back from the last key not greater than from, expecting the keys in [0, first] that are kept
+  auto check_reverse = [&](int64_t from, int64_t first, const std::function<bool(int64_t)> &kept) {
+    index_key.SetFromInteger(from);
+    int64_t expected = first;
+    for (auto it = from < 0 ? tree.RBegin() : tree.RBegin(index_key); it != tree.End(); --it) {
+      while (!kept(expected)) {
+        expected -= 2;
+      }
+      EXPECT_EQ(expected, (*it).second.GetSlotNum());
+      expected -= 2;
+    }
+    while (expected >= 0 && !kept(expected)) {
+      expected -= 2;
+    }
+    EXPECT_LT(expected, 0);
+  };
+  auto all = [](int64_t key) { return true; };
+  check_reverse(-1, 998, all);
+  check_reverse(2000, 998, all);
+  check_reverse(501, 500, all);
+  check_reverse(500, 500, all);
+  check_reverse(0, 0, all);
+  {
+    index_key.SetFromInteger(0);
+    auto it = tree.RBegin(index_key);
+    EXPECT_TRUE(it != tree.End());
+    --it;
+    EXPECT_TRUE(it == tree.End());
+
+    // stepping forward and back again returns to the same entry, across leaves too
+    it = tree.Begin();
+    for (int64_t key = 0; key < 20; key += 2) {
+      ++it;
+      EXPECT_EQ(key + 2, (*it).second.GetSlotNum());
+      --it;
+      EXPECT_EQ(key, (*it).second.GetSlotNum());
+      ++it;
+    }
+  }
+
+  // removes merge and redistribute leaves, which keeps them linked both ways
+  for (int64_t key = 0; key < 1000; key += 6) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key);
+  }
+  auto not_removed = [](int64_t key) { return key % 6 != 0; };
+  check_reverse(-1, 998, not_removed);
+  check_reverse(600, 598, not_removed);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+// Building a tree out of a million sorted keys, one Insert() per key against BulkLoad().
+TEST(BPlusTreeTests, DISABLED_BulkLoadBenchmark) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const int64_t num_keys = 1000000;
+  std::vector<std::pair<GenericKey<8>, RID>> entries(num_keys);
+  for (int64_t key = 0; key < num_keys; key++) {
+    entries[key].first.SetFromInteger(key);
+    entries[key].second = RID(0, key);
+  }
+
+  for (bool bulk_load : {false, true}) {
+    auto *disk_manager = new DiskManagerMemory(64 << 10);
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(4096, disk_manager);
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+
+    auto start = std::chrono::steady_clock::now();
+    if (bulk_load) {
+      tree.BulkLoad(entries.cbegin(), entries.cend());
+    } else {
+      for (const auto &[key, rid] : entries) {
+        tree.Insert(key, rid);
+      }
+    }
+    auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << (bulk_load ? "BulkLoad: " : "Insert: ") << dur.count() << " ms" << std::endl;
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+TEST(BPlusTreeTests, DISABLED_PointLookupBenchmark) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const int64_t num_keys = 1000000;
+  std::vector<std::pair<GenericKey<8>, RID>> entries(num_keys);
+  for (int64_t key = 0; key < num_keys; key++) {
+    entries[key].first.SetFromInteger(key);
+    entries[key].second = RID(0, key);
+  }
+
+  auto *disk_manager = new DiskManagerMemory(64 << 10);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(4096, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+  tree.BulkLoad(entries.cbegin(), entries.cend());
+
+  std::vector<size_t> order(num_keys);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937(21));
+  std::vector<RID> rids;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i : order) {
+    rids.clear();
+    tree.GetValue(entries[i].first, &rids);
+  }
+  auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  std::cout << "GetValue: " << dur.count() << " ms" << std::endl;
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+template <size_t KeySize>
+void CheckIntegerKeySearch(const std::string &key_schema_sql, int64_t min, int64_t max) {
+  auto key_schema = ParseCreateStatement(key_schema_sql);
+  GenericComparator<KeySize> comparator(key_schema.get());
+  ASSERT_NE(0, comparator.IntegerKeyWidth());
+  using Search = KeySearch<GenericKey<KeySize>, GenericComparator<KeySize>>;
+  using Fallback = ComparatorKeySearch<GenericKey<KeySize>, GenericComparator<KeySize>>;
+  auto make_key = [&](int64_t value) {
+    GenericKey<KeySize> key;
+    key.SetFromKey(Tuple({Value(key_schema->GetColumn(0).GetType(), value)}, key_schema.get()));
+    return key;
+  };
+
+  // every other value of a range around zero, with duplicates, and each size of page up to 40 entries
+  std::vector<std::pair<GenericKey<KeySize>, RID>> entries;
+  for (int64_t value = min; value < max; value += 2) {
+    entries.emplace_back(make_key(value), RID());
+    if (value % 10 == 0) {
+      entries.emplace_back(make_key(value), RID());
+    }
+  }
+  for (int size = 0; size <= 40; size++) {
+    for (int64_t value = min - 1; value <= min + size * 2 + 1; value++) {
+      auto key = make_key(value);
+      EXPECT_EQ(Fallback::LowerBound(entries.data(), 0, size, key, comparator),
+                Search::LowerBound(entries.data(), 0, size, key, comparator));
+      EXPECT_EQ(Fallback::UpperBound(entries.data(), 0, size, key, comparator),
+                Search::UpperBound(entries.data(), 0, size, key, comparator));
+      EXPECT_EQ(Fallback::UpperBound(entries.data(), 1, size, key, comparator),
+                Search::UpperBound(entries.data(), 1, size, key, comparator));
+    }
+  }
+  const int size = entries.size();
+  for (int64_t value = min - 1; value <= max; value++) {
+    auto key = make_key(value);
+    Value expected = key.ToValue(key_schema.get(), 0);
+    Value other = entries[size / 2].first.ToValue(key_schema.get(), 0);
+    int expected_cmp = expected.CompareLessThan(other) == CmpBool::CmpTrue      ? -1
+                       : expected.CompareGreaterThan(other) == CmpBool::CmpTrue ? 1
+                                                                                 : 0;
+    EXPECT_EQ(expected_cmp, comparator(key, entries[size / 2].first));
+    EXPECT_EQ(Fallback::LowerBound(entries.data(), 0, size, key, comparator),
+              Search::LowerBound(entries.data(), 0, size, key, comparator));
+    EXPECT_EQ(Fallback::UpperBound(entries.data(), 0, size, key, comparator),
+              Search::UpperBound(entries.data(), 0, size, key, comparator));
+  }
+}
+
+TEST(BPlusTreeTests, IntegerKeySearchTest) {
+  CheckIntegerKeySearch<4>("a integer", -200, 200);
+  CheckIntegerKeySearch<8>("a integer", -200, 200);
+  CheckIntegerKeySearch<8>("a bigint", -200, 200);
+  CheckIntegerKeySearch<8>("a bigint", (int64_t{1} << 40) - 100, (int64_t{1} << 40) + 100);
+
+  // other key schemas go through the comparator
+  auto key_schema = ParseCreateStatement("a bigint,b integer");
+  EXPECT_EQ(0, GenericComparator<16>(key_schema.get()).IntegerKeyWidth());
+  key_schema = ParseCreateStatement("a bigint");
+  EXPECT_EQ(0, GenericComparator<4>(key_schema.get()).IntegerKeyWidth());
+}
+
+/** @return the size of the first page below the root, which bulk loading filled up */
+template <typename RootPage>
+auto FirstChildSize(BufferPoolManager *bpm, page_id_t root_page_id) -> int {
+  page_id_t child_page_id;
+  {
+    auto guard = bpm->FetchPageRead(root_page_id);
+    child_page_id = guard.As<RootPage>()->ValueAt(0);
+  }
+  auto guard = bpm->FetchPageRead(child_page_id);
+  return guard.As<BPlusTreePage>()->GetSize();
+}
+
+TEST(BPlusTreeTests, CompressedInternalPageTest) {
+  auto key_schema = ParseCreateStatement("a bigint,b integer");
+  GenericComparator<16> comparator(key_schema.get());
+  using CompressedTree = BPlusTree<GenericKey<16>, RID, GenericComparator<16>,
+                                   BPlusTreeCompressedInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>>;
+  auto make_key = [&key_schema](int64_t a, int32_t b) {
+    GenericKey<16> key;
+    key.SetFromKey(Tuple({Value(TypeId::BIGINT, a), Value(TypeId::INTEGER, b)}, key_schema.get()));
+    return key;
+  };
+
+  // a few values of a, the high column, with negative ones among both columns
+  std::vector<GenericKey<16>> keys;
+  for (int64_t a = -2; a < 3; a++) {
+    for (int32_t b = -1000; b < 1000; b += 3) {
+      keys.push_back(make_key(a * 1000000, b));
+    }
+  }
+  std::mt19937 gen(19);
+  for (int i = 0; i < 1000; i++) {
+    const auto &lhs = keys[gen() % keys.size()];
+    const auto &rhs = keys[gen() % keys.size()];
+    int cmp = comparator(lhs, rhs);
+    int normalized_cmp = comparator.Normalize(lhs).Compare(comparator.Normalize(rhs));
+    EXPECT_EQ(cmp < 0, normalized_cmp < 0);
+    EXPECT_EQ(cmp == 0, normalized_cmp == 0);
+  }
+
+  auto *disk_manager = new DiskManagerMemory(64 << 10);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(256, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // small pages, so that every split, merge and redistribution is exercised
+  {
+    CompressedTree tree("foo_pk", bpm, comparator, 4, 5);
+    std::vector<size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), gen);
+    for (size_t i : order) {
+      EXPECT_TRUE(tree.Insert(keys[i], RID(0, i)));
+    }
+    EXPECT_FALSE(tree.Insert(keys[order[0]], RID(1, 0)));
+    size_t expected = 0;
+    for (auto it = tree.Begin(); it != tree.End(); ++it, expected++) {
+      EXPECT_EQ(expected, (*it).second.GetSlotNum());
+    }
+    EXPECT_EQ(keys.size(), expected);
+
+    std::shuffle(order.begin(), order.end(), gen);
+    for (size_t i = 0; i < order.size() / 2; i++) {
+      tree.Remove(keys[order[i]]);
+    }
+    std::vector<RID> rids;
+    for (size_t i = 0; i < order.size(); i++) {
+      rids.clear();
+      EXPECT_EQ(i >= order.size() / 2, tree.GetValue(keys[order[i]], &rids));
+    }
+    for (size_t i = order.size() / 2; i < order.size(); i++) {
+      tree.Remove(keys[order[i]]);
+    }
+    EXPECT_TRUE(tree.IsEmpty());
+  }
+
+  // with whole pages, separators of keys that share their leading column take up a fraction of the space of keys
+  std::vector<GenericKey<16>> dense_keys;
+  std::vector<std::pair<GenericKey<16>, RID>> entries;
+  for (int64_t a = 0; a < 4; a++) {
+    for (int32_t b = 0; b < 4000; b++) {
+      dense_keys.push_back(make_key(a, b));
+      entries.emplace_back(dense_keys.back(), RID(0, entries.size()));
+    }
+  }
+  BPlusTree<GenericKey<16>, RID, GenericComparator<16>> plain_tree("plain_pk", bpm, comparator, 3);
+  CompressedTree compressed_tree("compressed_pk", bpm, comparator, 3);
+  ASSERT_TRUE(plain_tree.BulkLoad(entries.cbegin(), entries.cend()));
+  ASSERT_TRUE(compressed_tree.BulkLoad(entries.cbegin(), entries.cend()));
+  using PlainPage = BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
+  using CompressedPage = BPlusTreeCompressedInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
+  EXPECT_GT(FirstChildSize<CompressedPage>(bpm, compressed_tree.GetRootPageId()),
+            2 * FirstChildSize<PlainPage>(bpm, plain_tree.GetRootPageId()));
+  std::vector<RID> rids;
+  for (size_t i = 0; i < dense_keys.size(); i++) {
+    rids.clear();
+    EXPECT_TRUE(compressed_tree.GetValue(dense_keys[i], &rids));
+    EXPECT_EQ(i, rids[0].GetSlotNum());
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+/** Insert keys into tree in random order, check the scan and lookups, then remove them all. */
+template <typename Tree, typename KeyType, typename KeyComparator>
+void CheckInsertScanRemove(Tree *tree, const std::vector<KeyType> &keys, const KeyComparator &comparator,
+                           std::mt19937 *gen) {
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), *gen);
+  for (size_t i : order) {
+    EXPECT_TRUE(tree->Insert(keys[i], RID(0, i)));
+  }
+  EXPECT_FALSE(tree->Insert(keys[order[0]], RID(1, 0)));
+
+  // keys are sorted, so the scan yields them in order
+  size_t expected = 0;
+  for (auto it = tree->Begin(); it != tree->End(); ++it, expected++) {
+    EXPECT_EQ(expected, (*it).second.GetSlotNum());
+    EXPECT_EQ(0, comparator((*it).first, keys[expected]));
+  }
+  EXPECT_EQ(keys.size(), expected);
+
+  // so does a range scan
+  size_t lo = keys.size() / 3;
+  size_t hi = 2 * keys.size() / 3;
+  expected = lo;
+  tree->Scan(&keys[lo], &keys[hi], [&](const auto &batch) {
+    for (const auto &entry : batch) {
+      EXPECT_EQ(expected, entry.second.GetSlotNum());
+      expected++;
+    }
+    return true;
+  });
+  EXPECT_EQ(hi + 1, expected);
+
+  std::shuffle(order.begin(), order.end(), *gen);
+  for (size_t i = 0; i < order.size() / 2; i++) {
+    tree->Remove(keys[order[i]]);
+  }
+  std::vector<RID> rids;
+  for (size_t i = 0; i < order.size(); i++) {
+    rids.clear();
+    EXPECT_EQ(i >= order.size() / 2, tree->GetValue(keys[order[i]], &rids));
+  }
+
+  // the merges kept the leaves linked both ways
+  std::vector<size_t> left(order.begin() + order.size() / 2, order.end());
+  std::sort(left.rbegin(), left.rend());
+  auto next = left.begin();
+  for (auto it = tree->RBegin(); it != tree->End(); --it, ++next) {
+    ASSERT_NE(left.end(), next);
+    EXPECT_EQ(*next, (*it).second.GetSlotNum());
+  }
+  EXPECT_EQ(left.end(), next);
+
+  for (size_t i = order.size() / 2; i < order.size(); i++) {
+    tree->Remove(keys[order[i]]);
+  }
+  EXPECT_TRUE(tree->IsEmpty());
+}
+
+TEST(BPlusTreeTests, VarlenKeyTest) {
+  auto key_schema = ParseCreateStatement("a varchar(200),b integer");
+  VarlenComparator<256> comparator(key_schema.get());
+  using SlottedLeafPage = BPlusTreeSlottedLeafPage<VarlenKey<256>, RID, VarlenComparator<256>>;
+  using SlottedTree =
+      BPlusTree<VarlenKey<256>, RID, VarlenComparator<256>,
+                BPlusTreeInternalPage<VarlenKey<256>, page_id_t, VarlenComparator<256>>, SlottedLeafPage>;
+  using CompressedSlottedTree =
+      BPlusTree<VarlenKey<256>, RID, VarlenComparator<256>,
+                BPlusTreeCompressedInternalPage<VarlenKey<256>, page_id_t, VarlenComparator<256>>, SlottedLeafPage>;
+  auto make_key = [&key_schema](const std::string &a, int32_t b) {
+    VarlenKey<256> key;
+    key.SetFromKey(Tuple({Value(TypeId::VARCHAR, a), Value(TypeId::INTEGER, b)}, key_schema.get()));
+    return key;
+  };
+
+  // strings of very different lengths, among them prefixes of each other and ones with zero bytes
+  std::mt19937 gen(20);
+  std::vector<std::pair<std::string, int32_t>> columns;
+  for (int i = 0; i < 2000; i++) {
+    std::string a = "k" + std::to_string(i % 500) + std::string(gen() % 150, 'x');
+    if (i % 7 == 0) {
+      a[a.size() / 2] = '\0';
+    }
+    columns.emplace_back(a, static_cast<int32_t>(gen() % 2000) - 1000);
+  }
+  columns.emplace_back("", 0);
+  columns.emplace_back("k1", -1);
+  auto less = [](const auto &lhs, const auto &rhs) {
+    int cmp = TypeUtil::CompareStrings(lhs.first.data(), lhs.first.size(), rhs.first.data(), rhs.first.size());
+    return cmp < 0 || (cmp == 0 && lhs.second < rhs.second);
+  };
+  std::sort(columns.begin(), columns.end(), less);
+  columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+  std::vector<VarlenKey<256>> keys;
+  for (const auto &[a, b] : columns) {
+    keys.push_back(make_key(a, b));
+  }
+  for (size_t i = 0; i + 1 < keys.size(); i++) {
+    ASSERT_LT(comparator(keys[i], keys[i + 1]), 0);
+    ASSERT_LT(comparator.Normalize(keys[i]).Compare(comparator.Normalize(keys[i + 1])), 0);
+  }
+  EXPECT_THROW(make_key(std::string(300, 'x'), 0), Exception);
+
+  auto *disk_manager = new DiskManagerMemory(64 << 10);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(256, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // leaves fill up by bytes long before they reach their max size
+  {
+    SlottedTree tree("foo_pk", bpm, comparator);
+    CheckInsertScanRemove(&tree, keys, comparator, &gen);
+  }
+  {
+    CompressedSlottedTree tree("foo_pk", bpm, comparator);
+    CheckInsertScanRemove(&tree, keys, comparator, &gen);
+  }
+  // small pages, so that every split, merge and redistribution is exercised
+  {
+    SlottedTree tree("foo_pk", bpm, comparator, 4, 5);
+    CheckInsertScanRemove(&tree, keys, comparator, &gen);
+  }
+  {
+    CompressedSlottedTree tree("foo_pk", bpm, comparator, 4, 5);
+    CheckInsertScanRemove(&tree, keys, comparator, &gen);
+  }
+
+  // bulk loaded leaves are filled by bytes as well
+  std::vector<std::pair<VarlenKey<256>, RID>> entries;
+  for (size_t i = 0; i < keys.size(); i++) {
+    entries.emplace_back(keys[i], RID(0, i));
+  }
+  CompressedSlottedTree tree("bulk_pk", bpm, comparator);
+  ASSERT_TRUE(tree.BulkLoad(entries.cbegin(), entries.cend(), 0.9));
+  std::vector<RID> rids;
+  for (size_t i = 0; i < keys.size(); i++) {
+    rids.clear();
+    EXPECT_TRUE(tree.GetValue(keys[i], &rids));
+    EXPECT_EQ(i, rids[0].GetSlotNum());
+  }
+  size_t expected = 0;
+  for (auto it = tree.Begin(make_key("k2", 0)); it != tree.End(); ++it) {
+    expected++;
+  }
+  EXPECT_EQ(keys.end() - std::lower_bound(keys.begin(), keys.end(), make_key("k2", 0),
+                                          [&comparator](const auto &lhs, const auto &rhs) {
+                                            return comparator(lhs, rhs) < 0;
+                                          }),
+            static_cast<std::ptrdiff_t>(expected));
+
+  // keys of one length close every leaf at the same number of bytes; the last leaf takes entries over from the one
+  // before it rather than keeping the few that are left
+  std::vector<std::pair<VarlenKey<256>, RID>> tail_entries;
+  for (int i = 0; i < 945; i++) {
+    tail_entries.emplace_back(make_key("k" + std::to_string(100000 + i), 0), RID(0, i));
+  }
+  CompressedSlottedTree tail_tree("tail_pk", bpm, comparator);
+  ASSERT_TRUE(tail_tree.BulkLoad(tail_entries.cbegin(), tail_entries.cend(), 0.9));
+  std::vector<size_t> leaf_sizes;
+  int next = static_cast<int>(tail_entries.size());
+  tail_tree.ReverseScan(nullptr, nullptr, [&](const auto &batch) {
+    leaf_sizes.push_back(batch.size());
+    for (const auto &entry : batch) {
+      EXPECT_EQ(--next, entry.second.GetSlotNum());
+    }
+    return true;
+  });
+  EXPECT_EQ(0, next);
+  ASSERT_GE(leaf_sizes.size(), 3U);
+  EXPECT_GE(3 * leaf_sizes[0], *std::max_element(leaf_sizes.begin(), leaf_sizes.end()));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
 }  // namespace bustub
@@ -10,11 +10,19 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_posix.h"
 
 namespace bustub {
 
@@ -75,4 +83,204 @@ TEST_F(DiskManagerTest, ReadWriteLogTest) {
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixReadWritePageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManagerPosix(db_file);
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(0, buf);  // an empty read yields a zeroed page
+  EXPECT_EQ(buf[0], 0);
+  EXPECT_EQ(buf[BUSTUB_PAGE_SIZE - 1], 0);
+
+  dm.WritePage(0, data);
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  std::memset(buf, 0, sizeof(buf));
+  dm.WritePage(5, data);
+  dm.ReadPage(5, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  EXPECT_EQ(dm.GetNumWrites(), 2);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixBatchReadWriteTest) {
+  const size_t num_pages = 64;
+  std::string db_file("test.db");
+  auto dm = DiskManagerPosix(db_file, 3);
+
+  // Shuffled ids with gaps, so that the batch is split into several runs of consecutive pages.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_pages; i++) {
+    page_ids.push_back(static_cast<page_id_t>(i + i / 8 * 3));
+  }
+  std::shuffle(page_ids.begin(), page_ids.end(), std::mt19937(15445));
+
+  std::vector<std::vector<char>> data(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<const char *> write_buffers;
+  for (size_t i = 0; i < num_pages; i++) {
+    std::fill(data[i].begin(), data[i].end(), static_cast<char>(page_ids[i]));
+    write_buffers.push_back(data[i].data());
+  }
+  dm.WritePages(page_ids, write_buffers);
+  EXPECT_EQ(dm.GetNumWrites(), num_pages);
+
+  // Read everything back in the reverse order, plus a page past the end of the file.
+  std::vector<std::vector<char>> buf(num_pages + 1, std::vector<char>(BUSTUB_PAGE_SIZE, 1));
+  std::vector<page_id_t> read_ids(page_ids.rbegin(), page_ids.rend());
+  read_ids.push_back(1000);
+  std::vector<char *> read_buffers;
+  for (auto &b : buf) {
+    read_buffers.push_back(b.data());
+  }
+  dm.ReadPages(read_ids, read_buffers);
+  for (size_t i = 0; i < num_pages; i++) {
+    EXPECT_EQ(buf[i], data[num_pages - 1 - i]);
+  }
+  EXPECT_EQ(buf[num_pages], std::vector<char>(BUSTUB_PAGE_SIZE, 0));
+
+  // The fstream based disk manager sees the same file.
+  dm.ShutDown();
+  auto fstream_dm = DiskManager(db_file);
+  std::vector<char> page(BUSTUB_PAGE_SIZE);
+  fstream_dm.ReadPage(page_ids[0], page.data());
+  EXPECT_EQ(page, data[0]);
+  fstream_dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixBatchRepeatedPageTest) {
+  std::string db_file("test.db");
+  auto dm = DiskManagerPosix(db_file, 3);
+
+  // Page 0 is written three times in one batch, each time between writes to other pages, so that the writes would
+  // end up in runs of their own. The last write wins.
+  std::vector<page_id_t> page_ids{0, 10, 0, 20, 0, 30};
+  std::vector<std::vector<char>> data;
+  std::vector<const char *> write_buffers;
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    data.emplace_back(BUSTUB_PAGE_SIZE, static_cast<char>(i + 1));
+  }
+  for (const auto &d : data) {
+    write_buffers.push_back(d.data());
+  }
+  dm.WritePages(page_ids, write_buffers);
+  EXPECT_EQ(dm.GetNumWrites(), 4);
+
+  // A page read twice in a batch fills both buffers.
+  std::vector<std::vector<char>> buf(3, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<char *> read_buffers{buf[0].data(), buf[1].data(), buf[2].data()};
+  dm.ReadPages({0, 10, 0}, read_buffers);
+  EXPECT_EQ(buf[0], data[4]);
+  EXPECT_EQ(buf[1], data[1]);
+  EXPECT_EQ(buf[2], data[4]);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixConcurrentReadWriteTest) {
+  const int num_threads = 4;
+  const int pages_per_thread = 50;
+  std::string db_file("test.db");
+  auto dm = DiskManagerPosix(db_file);
+
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&dm, tid] {
+      char data[BUSTUB_PAGE_SIZE];
+      char buf[BUSTUB_PAGE_SIZE];
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id = i * num_threads + tid;
+        std::memset(data, page_id, sizeof(data));
+        dm.WritePage(page_id, data);
+        dm.ReadPage(page_id, buf);
+        EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(dm.GetNumWrites(), num_threads * pages_per_thread);
+
+  dm.ShutDown();
+}
+
+// Random single-page reads from several threads, fstream DiskManager vs. DiskManagerPosix, followed by the same reads
+// submitted as batches.
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DISABLED_RandomReadBenchmark) {
+  const int num_pages = 16384;  // 64MB
+  const int num_threads = 8;
+  const int reads_per_thread = 20000;
+  const int batch_size = 32;
+  std::string db_file("test.db");
+
+  {
+    auto dm = DiskManagerPosix(db_file);
+    std::vector<char> data(BUSTUB_PAGE_SIZE, 'x');
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      dm.WritePage(page_id, data.data());
+    }
+    dm.ShutDown();
+  }
+
+  auto run_single = [&](DiskManager *dm) {
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([dm, tid] {
+        std::mt19937 gen(tid);
+        std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+        char buf[BUSTUB_PAGE_SIZE];
+        for (int i = 0; i < reads_per_thread; i++) {
+          dm->ReadPage(dist(gen), buf);
+        }
+      });
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+  };
+  auto run_batched = [&](DiskManager *dm) {
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+    std::vector<std::vector<char>> buf(batch_size, std::vector<char>(BUSTUB_PAGE_SIZE));
+    std::vector<char *> buffers;
+    for (auto &b : buf) {
+      buffers.push_back(b.data());
+    }
+    std::vector<page_id_t> page_ids(batch_size);
+    for (int i = 0; i < num_threads * reads_per_thread / batch_size; i++) {
+      for (auto &page_id : page_ids) {
+        page_id = dist(gen);
+      }
+      dm->ReadPages(page_ids, buffers);
+    }
+  };
+  auto measure = [&](const char *name, DiskManager *dm, const std::function<void(DiskManager *)> &run) {
+    auto clock_start = std::chrono::steady_clock::now();
+    run(dm);
+    auto clock_end = std::chrono::steady_clock::now();
+    auto dur = std::chrono::duration_cast<std::chrono::microseconds>(clock_end - clock_start);
+    std::cout << name << ": " << num_threads * reads_per_thread * 1000000.0 / dur.count() << " IOPS" << std::endl;
+  };
+
+  auto fstream_dm = DiskManager(db_file);
+  measure("fstream, single page", &fstream_dm, run_single);
+  measure("fstream, batched", &fstream_dm, run_batched);
+  fstream_dm.ShutDown();
+
+  auto posix_dm = DiskManagerPosix(db_file);
+  measure("pread, single page", &posix_dm, run_single);
+  measure("pread, batched", &posix_dm, run_batched);
+  posix_dm.ShutDown();
+}
+
 }  // namespace bustub
@@ -24,7 +24,7 @@
 
 namespace bustub {
 // NOLINTNEXTLINE
-TEST(TupleTest, DISABLED_TableHeapTest) {
+TEST(TupleTest, TableHeapTest) {
   // test1: parse create sql statement
   std::string create_stmt = "a varchar(20), b smallint, c bigint, d bool, e varchar(16)";
   Column col1{"a", TypeId::VARCHAR, 20};
@@ -51,11 +51,17 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
     rid_v.push_back(rid);
   }
 
+  // The pool only holds a fraction of the table, so the scan runs on read-ahead.
+  size_t num_scanned = 0;
   TableIterator itr = table->Begin(transaction);
   while (itr != table->End()) {
     // std::cout << itr->ToString(schema) << std::endl;
+    EXPECT_EQ(rid_v[num_scanned], itr->GetRid());
     ++itr;
+    ++num_scanned;
   }
+  EXPECT_EQ(rid_v.size(), num_scanned);
+  EXPECT_LT(0, buffer_pool_manager->GetNumPrefetchedPages());
 
   // int i = 0;
   std::shuffle(rid_v.begin(), rid_v.end(), std::default_random_engine(0));
@@ -68,6 +74,81 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   remove("test.log");
   delete table;
   delete buffer_pool_manager;
+  delete log_manager;
+  delete lock_manager;
+  delete transaction;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, InterleavedTableHeapTest) {
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  Column col3{"c", TypeId::BIGINT};
+  Column col4{"d", TypeId::BOOLEAN};
+  Column col5{"e", TypeId::VARCHAR, 16};
+  std::vector<Column> cols{col1, col2, col3, col4, col5};
+  Schema schema{cols};
+  Tuple tuple = ConstructTuple(&schema);
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
+  auto *lock_manager = new LockManager();
+  auto *log_manager = new LogManager(disk_manager);
+  // Two tables filled in turns take every other page, so the pages of neither follow each other on disk.
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
+  auto *other_table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
+
+  std::vector<RID> rid_v;
+  for (int i = 0; i < 5000; ++i) {
+    RID rid;
+    table->InsertTuple(tuple, &rid, transaction);
+    rid_v.push_back(rid);
+    other_table->InsertTuple(tuple, &rid, transaction);
+  }
+  std::vector<page_id_t> page_ids;
+  for (const auto &rid : rid_v) {
+    if (page_ids.empty() || page_ids.back() != rid.GetPageId()) {
+      page_ids.push_back(rid.GetPageId());
+    }
+  }
+  ASSERT_NE(page_ids[0] + 1, page_ids[1]);
+
+  auto scan = [&](TableHeap *heap) {
+    auto num_prefetched = buffer_pool_manager->GetNumPrefetchedPages();
+    size_t num_scanned = 0;
+    for (auto itr = heap->Begin(transaction); itr != heap->End(); ++itr) {
+      EXPECT_EQ(rid_v[num_scanned], itr->GetRid());
+      ++num_scanned;
+    }
+    EXPECT_EQ(rid_v.size(), num_scanned);
+    return buffer_pool_manager->GetNumPrefetchedPages() - num_prefetched;
+  };
+
+  // Read-ahead follows the page chain, so it never loads a page of the other table.
+  auto num_prefetched = scan(table);
+  EXPECT_LT(0, num_prefetched);
+  EXPECT_GE(page_ids.size(), num_prefetched);
+
+  // A heap opened on the same pages learns the chain as it scans, reading one page ahead, and keeps it for the next.
+  auto *reopened_table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, table->GetFirstPageId());
+  for (int round = 0; round < 2; ++round) {
+    num_prefetched = scan(reopened_table);
+    EXPECT_LT(0, num_prefetched);
+    EXPECT_GE(page_ids.size(), num_prefetched);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");  // remove db file
+  remove("test.log");
+  delete reopened_table;
+  delete other_table;
+  delete table;
+  delete buffer_pool_manager;
+  delete log_manager;
+  delete lock_manager;
+  delete transaction;
   delete disk_manager;
 }
 
@@ -147,6 +147,7 @@ auto main(int argc, char **argv) -> int {  // NOLINT
   program.add_argument("--verbose").help("increase output verbosity").default_value(false).implicit_value(true);
   program.add_argument("-d", "--diff").help("write diff file").default_value(false).implicit_value(true);
   program.add_argument("--in-memory").help("use in-memory backend").default_value(false).implicit_value(true);
+  program.add_argument("--posix-io").help("use positional I/O backend").default_value(false).implicit_value(true);
 
   try {
     program.parse_args(argc, argv);
@@ -176,7 +177,10 @@ auto main(int argc, char **argv) -> int {  // NOLINT
   if (program.get<bool>("--in-memory")) {
     bustub = std::make_unique<bustub::BustubInstance>();
   } else {
-    bustub = std::make_unique<bustub::BustubInstance>("test.db");
+    // a database file with pages in it would be opened, with the tables and indexes of the previous run
+    remove("test.db");
+    remove("test.log");
+    bustub = std::make_unique<bustub::BustubInstance>("test.db", 1, program.get<bool>("--posix-io"));
   }
 
   bustub->GenerateMockTable();